@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <esp_adc_cal.h>
+
+#define ADC_MAX_READING 4095            // Maximum reading of the 12-bit ADC
+#define ADC_MAX_VOLTAGE 3.3             // Maximum voltage of the ADC input (11dB attenuation) in V
+#define ADC_POLYNOMIAL_MAX_READING 3757 // From this reading (3.0284V) on the linear calculation is used, since the polynomial curve drifts away and maxes out at 3.14V
+#define ADC_TABLE_VOLTAGE_SCALE 10000   // Table values are stored in 0.1 mV
+
+/// @brief Source that is used to correct the none linear ADC readings
+enum class AdcCalibrationSource
+{
+    /// @brief Lookup table generated from the G6EJD polynomial curve
+    Polynomial = 0,
+    /// @brief eFuse Vref calibration of the chip
+    EfuseVref = 1,
+    /// @brief eFuse two point calibration of the chip
+    EfuseTwoPoint = 2,
+};
+
+/// @brief Corrected voltage [0.1 mV] for each 12-bit ADC reading
+struct AdcCorrectionTable
+{
+    uint16_t voltage[ADC_MAX_READING + 1];
+};
+
+/// @brief Compile time generation of the ADC correction table
+namespace AdcCorrectionMath
+{
+    /// @brief Corrected voltage [V] of the reading by the pre-calculated polynomial curve from
+    /// https://github.com/G6EJD/ESP32-ADC-Accuracy-Improvement-function (evaluated by Horner's method)
+    constexpr double voltageFromReading(uint16_t reading)
+    {
+        if (reading < 1)
+            return 0;
+
+        if (reading > ADC_POLYNOMIAL_MAX_READING)
+            return ADC_MAX_VOLTAGE / ADC_MAX_READING * reading;
+
+        double x = reading;
+        return (((-0.000000000000016 * x + 0.000000000118171) * x - 0.000000301211691) * x + 0.001109019271794) * x + 0.034143524634089;
+    }
+
+    /// @brief Builds the correction table for all readings
+    constexpr AdcCorrectionTable table()
+    {
+        AdcCorrectionTable table = {};
+        for (size_t reading = 0; reading <= ADC_MAX_READING; reading++)
+        {
+            table.voltage[reading] = (uint16_t)(voltageFromReading(reading) * ADC_TABLE_VOLTAGE_SCALE + 0.5);
+        }
+
+        return table;
+    }
+}
+
+/**
+ * @brief Converts raw 12-bit ADC readings (11dB attenuation) into corrected voltages.
+ *
+ * By default the reading is mapped through a 4096 entry table in flash that is generated by the compiler
+ * from the G6EJD polynomial curve, the maximum deviation against the polynomial is the table resolution
+ * of 0.05 mV. If enabled and burned into the chip, the eFuse two point or Vref calibration is used instead.
+ * The readings 0 (short) and 4095 (open) are always mapped to 0V and ADC_MAX_VOLTAGE, so that a defect
+ * divider resistor or a disconnected sensor can still be detected.
+ */
+class AdcCorrection
+{
+private:
+    static constexpr AdcCorrectionTable _table = AdcCorrectionMath::table();
+    AdcCalibrationSource _source = AdcCalibrationSource::Polynomial;
+    esp_adc_cal_characteristics_t _characteristics;
+
+protected:
+public:
+    /// @brief Initializes the correction for ADC1
+    /// @param useEfuseCalibration Use the eFuse calibration if available, otherwise the polynomial table is used
+    /// @return The calibration source that is used
+    AdcCalibrationSource begin(bool useEfuseCalibration);
+
+    /// @brief Gets the calibration source that is used
+    AdcCalibrationSource getSource() const { return _source; };
+
+    /// @brief Gets the name of the calibration source that is used
+    const char *getSourceName() const;
+
+    /// @brief Converts the raw reading into the corrected voltage [V]
+    /// @param reading The raw 12-bit ADC reading
+    /// @return The corrected voltage [V]
+    float voltageFromReading(uint16_t reading) const;
+
+    /// @brief Converts the averaged reading of several samples (oversampling) into the corrected voltage [V]
+    /// by interpolating between the neighbouring readings
+    /// @param reading The averaged 12-bit ADC reading
+    /// @return The corrected voltage [V]
+    float voltageFromReading(float reading) const;
+};
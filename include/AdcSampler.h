@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define ADC_CONTINUOUS_SAMPLE_FREQUENCY 20000   // Sample frequency of the continuous (DMA) ADC mode in Hz (minimum supported by the ESP32)
+#define ADC_CONTINUOUS_BUFFER_SIZE 2048         // Size of the DMA ring buffer in bytes (2 bytes per sample)
+#define ADC_CONTINUOUS_CHUNK_SIZE 256           // Size of a single DMA transfer in bytes
+
+/// @brief Interface to read raw samples of a single ADC1 input, implementations can be
+/// replaced by a fake to feed samples into the temperature calculation without hardware
+class AdcSampler
+{
+private:
+protected:
+public:
+    virtual ~AdcSampler() {};
+
+    /// @brief Starts sampling
+    /// @return true if the sampling could be started
+    virtual bool begin() = 0;
+
+    /// @brief Reads the samples that have been captured since the last call (frame)
+    /// @param samples The buffer for the raw 12-bit readings
+    /// @param maxSamples The size of the buffer, if more samples are available only the most recent are kept
+    /// @return The amount of samples inside the buffer
+    virtual size_t read(uint16_t *samples, size_t maxSamples) = 0;
+
+    /// @brief Gets the name of the sampling mode
+    virtual const char *getName() const = 0;
+};
+
+/// @brief Reads a single sample via analogRead on each read call
+class AdcPollingSampler : public AdcSampler
+{
+private:
+    const uint8_t _gpioPin;
+
+protected:
+public:
+    /// @brief Creates the sampler
+    /// @param gpioPin The ADC1 GPIO
+    AdcPollingSampler(uint8_t gpioPin) : _gpioPin(gpioPin) {};
+
+    bool begin() override;
+    size_t read(uint16_t *samples, size_t maxSamples) override;
+    const char *getName() const override { return "Polling"; };
+};
+
+/// @brief Samples continuously in the background via DMA with ADC_CONTINUOUS_SAMPLE_FREQUENCY,
+/// so the samples are evenly spaced independent of the main loop and cost nearly no CPU time
+/// @attention analogRead must not be used for ADC1 while the continuous mode is running
+class AdcContinuousSampler : public AdcSampler
+{
+private:
+    const uint8_t _gpioPin;
+    bool _running = false;
+    uint8_t _chunk[ADC_CONTINUOUS_CHUNK_SIZE];
+
+protected:
+public:
+    /// @brief Creates the sampler
+    /// @param gpioPin The ADC1 GPIO
+    AdcContinuousSampler(uint8_t gpioPin) : _gpioPin(gpioPin) {};
+    ~AdcContinuousSampler() override;
+
+    bool begin() override;
+    size_t read(uint16_t *samples, size_t maxSamples) override;
+    const char *getName() const override { return "Continuous (DMA)"; };
+};
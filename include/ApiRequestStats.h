@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+
+/// @brief Statistics of a single API request
+struct ApiRequestStats
+{
+    /// @brief Duration of the request in milliseconds
+    uint32_t duration = 0;
+
+    /// @brief Duration of the TCP connect and TLS handshake in milliseconds (0 if the connection has been reused)
+    uint32_t handshake = 0;
+
+    /// @brief Gets if the open connection of the previous request has been reused
+    bool reused = false;
+
+    /// @brief Received bytes of the response body
+    uint32_t bytes = 0;
+
+    /// @brief Peak heap usage of the request in bytes
+    uint32_t heapPeak = 0;
+};
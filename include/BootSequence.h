@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+
+/// @brief Stages of the boot sequence, the sequential stages are completed in order (setup and loop),
+/// the events are marked once when they occur for the first time
+enum class BootStage : uint8_t
+{
+    // Reset of the device (time 0)
+    RESET = 0,
+    // Configuration has been loaded
+    CONFIG,
+    // Cached weather of the last run has been loaded (or is not available)
+    WEATHER_CACHE,
+    // Input thermistor reading is running
+    INPUT_SENSOR,
+    // Output control is running
+    OUTPUT_CONTROL,
+    // Power limit control is running
+    POWER_LIMIT,
+    // Network has been started (non-blocking)
+    NETWORK,
+    // Webinterface has been started
+    WEBINTERFACE,
+    // Weather API background requests are running
+    WEATHER_API,
+    // All stages have been completed
+    COMPLETED,
+    // Event: first valid output temperature
+    FIRST_OUTPUT,
+    // Event: network has been connected for the first time
+    NETWORK_CONNECTED,
+    // Event: first live weather API result
+    FIRST_WEATHER,
+};
+
+#define BOOT_STAGE_COUNT 13 // Amount of BootStage values
+
+/// @brief Tracks the boot sequence with a timestamp for each stage, to measure e.g. the latency from reset to first output.
+/// The stages are completed by the network task and the events are marked by any task, so the times are guarded by a spinlock.
+class BootSequenceClass
+{
+private:
+    mutable portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    int64_t _times[BOOT_STAGE_COUNT];
+    BootStage _stage = BootStage::RESET;
+
+public:
+    BootSequenceClass();
+
+    /// @brief Completes a sequential stage and marks its time
+    void complete(BootStage stage);
+
+    /// @brief Marks the time of a stage or event if it has not been marked yet
+    void mark(BootStage stage);
+
+    /// @brief Gets if the stage or event has been marked
+    bool isMarked(BootStage stage) const { return getTime(stage) >= 0; }
+
+    /// @brief Gets the time of the stage or event since reset in microseconds or -1 if not marked yet
+    int64_t getTime(BootStage stage) const;
+
+    /// @brief Gets the last completed sequential stage
+    BootStage getStage() const;
+
+    /// @brief Gets if all sequential stages have been completed
+    bool isCompleted() const { return getStage() == BootStage::COMPLETED; }
+
+    /// @brief Returns the stage name
+    static const char *getStageName(BootStage stage);
+};
+
+extern BootSequenceClass BootSequence;
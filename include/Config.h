@@ -1,13 +1,16 @@
 #pragma once
 
-#include <Preferences.h>
+#include "ConfigStore.h"
 
 #define MIN_TEMPERATURE -20                                 // Minimum supported temperature in °C
 #define MAX_TEMPERATURE 30                                  // Maximum supported temperature in °C
 #define ADJUST_TEMP_START 21                                // Start of adjustment temperatures in °C
 #define ADJUST_TEMP_END -15                                 // End of adjustment temperatures in °C
 #define ADJUST_TEMP_MAX_OFSET 10                            // Maximum offset adjustment temperature in °C
-#define KEY_SETTINGS_NAMESPACE "TCapChamp"                  // Preferences namespance key (limited to 15 chars)
+#define KEY_CONFIG_NAMESPACE "TCapChampCfg"                 // Preferences namespace of the configuration blob (limited to 15 chars)
+#define KEY_CONFIG_BLOB "Config"                            // Preferences key of the configuration blob (limited to 15 chars)
+#define CONFIG_DATA_VERSION 1                               // Layout version of ConfigData, incremented if fields are appended
+#define KEY_SETTINGS_NAMESPACE "TCapChamp"                  // Preferences namespance key of the former per-key layout, migrated into the blob (limited to 15 chars)
 #define KEY_SETTING_TEMP_MANUAL_OUT_MODE "TempOutManual"    // Preferences key for manual output temperature mode (limited to 15 chars)
 #define KEY_SETTING_TEMP_MANUAL_OUT_TEMP "ManualOutTemp"    // Preferences key for manual output temperature (limited to 15 chars)
 #define KEY_SETTING_TEMP_MANUAL_IN_MODE "TempInManual"      // Preferences key for manual input temperature mode (limited to 15 chars)
@@ -29,11 +32,55 @@ static const size_t POWER_AREA_AMOUNT = 6;          // Amount of power areas
 class TemperatureArea;
 class PowerArea;
 
+/// @brief Power area inside the configuration blob
+struct ConfigPowerAreaData
+{
+    /// @brief Start temperature in 0.1 °C
+    int16_t start = 0;
+
+    /// @brief End temperature in 0.1 °C
+    int16_t end = 0;
+
+    /// @brief Power limit in %
+    uint8_t powerLimit = MAX_POWER_LIMIT;
+};
+
+/// @brief Layout of the configuration blob (CONFIG_DATA_VERSION) with the default values, new fields may only be appended
+struct ConfigData
+{
+    /// @brief Manual output temperature mode
+    bool manualOutputActive = false;
+
+    /// @brief Manual output temperature in 0.1 °C
+    int16_t manualOutputTemperature = 150;
+
+    /// @brief Manual input temperature mode
+    bool manualInputActive = false;
+
+    /// @brief Manual input temperature in 0.1 °C
+    int16_t manualInputTemperature = 100;
+
+    /// @brief Temperature offsets in 0.1 °C from ADJUST_TEMP_START to ADJUST_TEMP_END
+    int8_t tempOffset[TEMP_ADJUST_AMOUNT] = {};
+
+    /// @brief Manual power mode
+    bool manualPowerActive = false;
+
+    /// @brief Manual power in %
+    uint8_t manualPower = 100;
+
+    /// @brief Power areas
+    ConfigPowerAreaData powerAreas[POWER_AREA_AMOUNT];
+};
+
+static_assert(sizeof(ConfigStoreHeader) + sizeof(ConfigData) <= CONFIG_STORE_BLOB_SIZE, "The configuration blob is limited to CONFIG_STORE_BLOB_SIZE");
+
 /// @brief Defines an adjustment for a specific temperature
 class TemperatureAdjustment
 {
 private:
-    Preferences *_preferences;    
+    ConfigStore *_store;
+    int8_t *_storedOffset;      // Temperature offset inside the configuration blob
     float _tempOffset;          // Temperature offset
 
 protected:
@@ -41,8 +88,9 @@ public:
     const int8_t tempReal;      // Real measured temperature
 
     /// @brief Creates a new instance of an TemperatureConfig
-    /// @param preferences the app preferences to stroe the configuration
-    TemperatureAdjustment(int8_t tempReal, Preferences *preferences);
+    /// @param store the store of the configuration
+    /// @param storedOffset the temperature offset inside the configuration blob
+    TemperatureAdjustment(int8_t tempReal, ConfigStore *store, int8_t *storedOffset);
 
     /// @brief Gets the adjusted temperature
     float getTemperatureAdjusted() { return tempReal + _tempOffset; };
@@ -61,7 +109,8 @@ class TemperatureConfig
 {
 private:
     TemperatureAdjustment *_adjustments[TEMP_ADJUST_AMOUNT];
-    Preferences *_preferences;
+    ConfigStore *_store;
+    ConfigData *_data;
     bool _manualOutputActive;
     bool _manualInputActive;
     float _manualOutputTemperature;
@@ -70,8 +119,9 @@ private:
 protected:
 public:
     /// @brief Creates a new instance of an TemperatureConfig
-    /// @param preferences the app preferences to stroe the configuration
-    TemperatureConfig(Preferences *preferences);
+    /// @param store the store of the configuration
+    /// @param data the loaded configuration blob
+    TemperatureConfig(ConfigStore *store, ConfigData *data);
 
     /// @brief Gets if the manual output temperature is active
     bool isManualOutputTemp() { return _manualOutputActive; };
@@ -124,15 +174,17 @@ class PowerConfig
 {
 private:
     PowerArea *_areas[POWER_AREA_AMOUNT];
-    Preferences *_preferences;
+    ConfigStore *_store;
+    ConfigData *_data;
     bool _manualOutputActive;
     uint8_t _manualPower;
 
 protected:
 public:
     /// @brief Creates a new instance of an PowerConfig
-    /// @param preferences the app preferences to stroe the configuration
-    PowerConfig(Preferences *preferences);
+    /// @param store the store of the configuration
+    /// @param data the loaded configuration blob
+    PowerConfig(ConfigStore *store, ConfigData *data);
 
     /// @brief Gets if the manual mode is active
     bool isManualOutputPower() { return _manualOutputActive; };
@@ -170,7 +222,8 @@ class PowerArea
 {
 private:
     PowerConfig *_config;
-    Preferences *_preferences;
+    ConfigStore *_store;
+    ConfigPowerAreaData *_data;
     float _start;
     float _end;
     uint8_t _powerLimit;
@@ -182,8 +235,9 @@ public:
     /// @brief Creates a new instance of an PowerArea
     /// @param index unique area index
     /// @param config the parent configuration
-    /// @param preferences the app preferences to store the configuration
-    PowerArea(size_t index, PowerConfig *config, Preferences *preferences);
+    /// @param store the store of the configuration
+    /// @param data the area inside the configuration blob
+    PowerArea(size_t index, PowerConfig *config, ConfigStore *store, ConfigPowerAreaData *data);
 
     /// @brief Gets if the area is responsable for the given temperature
     /// @param temperature the temperature
@@ -224,13 +278,16 @@ public:
 class Config
 {
 private:
-    Preferences *_preferences;
+    ConfigData _data;
+
+    void migrate();
 
 protected:
 public:
+    ConfigStore *store;
     TemperatureConfig *temperatureConfig;
     PowerConfig *powerConfig;
 
-    /// @brief Creates the configuration instance
+    /// @brief Creates the configuration instance, loads the configuration blob or migrates the former per-key layout
     Config();
 };
\ No newline at end of file
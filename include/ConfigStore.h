@@ -0,0 +1,124 @@
+#pragma once
+
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+
+#define CONFIG_STORE_BLOB_SIZE 256          // Maximum size of the configuration blob in bytes including the header
+#define CONFIG_STORE_COMMIT_DELAY 3000      // Quiet period in ms after the last change until the changes are committed
+#define CONFIG_STORE_COMMIT_MAX 30000       // Maximum time in ms from the first change until the changes are committed (ongoing changes)
+
+/// @brief Header of the configuration blob
+struct ConfigStoreHeader
+{
+    /// @brief Layout version of the data
+    uint16_t version;
+
+    /// @brief Size of the data in bytes
+    uint16_t size;
+
+    /// @brief CRC32 of the data
+    uint32_t crc;
+};
+
+/// @brief Load and write counters of the configuration store
+struct ConfigStoreStats
+{
+    /// @brief Duration of the configuration load at boot in us (including a migration)
+    uint32_t loadTime = 0;
+
+    /// @brief Layout version of the loaded blob (0 if no valid blob has been found)
+    uint16_t loadVersion = 0;
+
+    /// @brief Amount of changed values
+    uint32_t changes = 0;
+
+    /// @brief Amount of changes that have been committed together with a later change (saved NVS writes)
+    uint32_t coalesced = 0;
+
+    /// @brief Amount of commits (NVS writes)
+    uint32_t commits = 0;
+
+    /// @brief Amount of written bytes
+    uint32_t bytes = 0;
+
+    /// @brief Amount of failed commits
+    uint32_t failures = 0;
+
+    /// @brief Duration of the last commit in us
+    uint32_t commitTimeLast = 0;
+
+    /// @brief Maximum duration of a commit in us
+    uint32_t commitTimeMax = 0;
+
+    /// @brief Amount of changes that are waiting for the commit
+    uint32_t pending = 0;
+};
+
+/// @brief Stores the configuration as a single versioned and CRC protected blob inside the preferences, so the whole
+/// configuration is loaded with one NVS read. Changes are applied to the data in RAM and written behind: the blob is
+/// committed after CONFIG_STORE_COMMIT_DELAY without further changes, so a burst of changes (e.g. number input steps
+/// of the webinterface) is written once and the NVS write doesn't stall the caller.
+/// Pending changes need to be committed before a restart (see commit()).
+/// New layout versions may only append fields, so a blob of another version loads the fields that are known to both.
+class ConfigStore
+{
+private:
+    mutable portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    Preferences _preferences;
+    const char *_key;
+    const uint16_t _version;
+    uint8_t *_data;
+    const uint16_t _size;
+    uint32_t _changeCnt = 0;
+    uint32_t _commitCnt = 0;
+    uint32_t _firstChange = 0;
+    uint32_t _lastChange = 0;
+    ConfigStoreStats _stats;
+
+    void changed();
+
+protected:
+public:
+    /// @brief Opens the preferences namespace
+    /// @param name the namespace (limited to 15 chars)
+    /// @param key the key of the blob (limited to 15 chars)
+    /// @param version the layout version of the data
+    /// @param data the configuration data in RAM
+    /// @param size the size of the data (at most CONFIG_STORE_BLOB_SIZE - sizeof(ConfigStoreHeader))
+    ConfigStore(const char *name, const char *key, uint16_t version, void *data, size_t size);
+
+    ConfigStore(const ConfigStore &) = delete;
+    ConfigStore &operator=(const ConfigStore &) = delete;
+
+    /// @brief Loads the blob into the data with a single NVS read, the data keeps its values if no valid blob has been found
+    /// (fields that are not part of an older version keep their values as well)
+    /// @return the layout version of the blob or 0 if no valid blob has been found
+    uint16_t load();
+
+    /// @brief Sets the duration of the configuration load at boot
+    /// @param duration the duration in us
+    void setLoadTime(uint32_t duration) { _stats.loadTime = duration; };
+
+    /// @brief Changes a field of the data, the change is committed after the quiet period
+    /// @param field the field inside the data
+    /// @param value the new value
+    template <typename T>
+    void set(T &field, T value)
+    {
+        portENTER_CRITICAL(&_mux);
+        field = value;
+        changed();
+        portEXIT_CRITICAL(&_mux);
+    }
+
+    /// @brief Commits the pending changes if the quiet period has elapsed, needs to be called periodically
+    void update();
+
+    /// @brief Writes the blob to NVS immediately if there are pending changes (e.g. before a restart)
+    /// @param force writes the blob even without pending changes
+    /// @return false if the blob could not be written
+    bool commit(bool force = false);
+
+    /// @brief Gets the load and write counters
+    ConfigStoreStats getStats() const;
+};
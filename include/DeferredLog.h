@@ -0,0 +1,184 @@
+#pragma once
+
+#include <Arduino.h>
+#include <type_traits>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#ifndef DEFERRED_LOG_ENABLED
+#define DEFERRED_LOG_ENABLED 0          // Build flag -D DEFERRED_LOG_ENABLED=1 enables the logger, otherwise the ring buffer, the task and GET /log are compiled out
+#endif
+#define DEFERRED_LOG_SIZE 8192          // Size of the ring buffer in bytes
+#define DEFERRED_LOG_RECORD_SIZE 160    // Maximum size of a single record in bytes (header + arguments)
+#define DEFERRED_LOG_STRING_SIZE 64     // Maximum length of a string argument, longer strings are truncated
+#define DEFERRED_LOG_LINE_SIZE 256      // Maximum length of a formatted line
+#define DEFERRED_LOG_DRAIN_CYCLE 20     // Poll time of the drain task in milliseconds
+#define DEFERRED_LOG_STACK_SIZE 3072    // Stack size of the drain task in bytes
+#define DEFERRED_LOG_PRIORITY 0         // Priority of the drain task (idle priority, only runs if nothing else has to be done)
+
+/// @brief Header of a log record, followed by the encoded arguments
+struct DeferredLogHeader
+{
+    uint16_t size;
+    uint8_t level;
+    uint8_t argc;
+    uint32_t time;
+    const char *cl;
+    const char *fn;
+    const char *fmt;
+};
+
+/// @brief A single log record: header with pointers to the static class, function and format strings plus the raw arguments
+class DeferredLogRecord
+{
+private:
+    uint8_t _data[DEFERRED_LOG_RECORD_SIZE];
+    uint16_t _size = sizeof(DeferredLogHeader);
+    uint8_t _argc = 0;
+
+    void add(char type, const void *value, size_t size)
+    {
+        if (_size + 1 + size > DEFERRED_LOG_RECORD_SIZE)
+            return;
+
+        _data[_size++] = type;
+        memcpy(_data + _size, value, size);
+        _size += size;
+        _argc++;
+    }
+
+    void addString(const char *value)
+    {
+        size_t length = value ? strnlen(value, DEFERRED_LOG_STRING_SIZE) : 0;
+        if (_size + 2 > DEFERRED_LOG_RECORD_SIZE)
+            return;
+        if (_size + 2 + length > DEFERRED_LOG_RECORD_SIZE)
+            length = DEFERRED_LOG_RECORD_SIZE - _size - 2;
+
+        _data[_size++] = 's';
+        _data[_size++] = length;
+        memcpy(_data + _size, value, length);
+        _size += length;
+        _argc++;
+    }
+
+    static const char *toCString(const char *value) { return value; };
+    static const char *toCString(const String &value) { return value.c_str(); };
+    static const char *toCString(const __FlashStringHelper *value) { return reinterpret_cast<const char *>(value); };
+
+    friend class DeferredLogClass;
+
+protected:
+public:
+    /// @brief Adds an argument (integer, enum, bool, float, C string, String or flash string)
+    template <typename T>
+    void arg(const T &value)
+    {
+        if constexpr (std::is_same<T, bool>::value)
+        {
+            uint32_t v = value ? 1 : 0;
+            add('u', &v, sizeof(v));
+        }
+        else if constexpr (std::is_enum<T>::value)
+        {
+            int32_t v = static_cast<int32_t>(value);
+            add('i', &v, sizeof(v));
+        }
+        else if constexpr (std::is_integral<T>::value && sizeof(T) > 4)
+        {
+            int64_t v = value;
+            add(std::is_signed<T>::value ? 'I' : 'U', &v, sizeof(v));
+        }
+        else if constexpr (std::is_integral<T>::value)
+        {
+            int32_t v = value;
+            add(std::is_signed<T>::value ? 'i' : 'u', &v, sizeof(v));
+        }
+        else if constexpr (std::is_floating_point<T>::value)
+        {
+            float v = value;
+            add('f', &v, sizeof(v));
+        }
+        else
+        {
+            addString(toCString(value));
+        }
+    }
+
+    /// @brief Gets the header of the record
+    DeferredLogHeader getHeader() const
+    {
+        DeferredLogHeader header;
+        memcpy(&header, _data, sizeof(header));
+        return header;
+    }
+
+    /// @brief Formats the record as line `LEVEL [Class.function] message`, `{}` inside the format are replaced by the arguments
+    /// @param out output buffer
+    /// @param length size of the output buffer
+    /// @param withTime prefix the line with the time in milliseconds since boot
+    /// @return length of the line
+    size_t format(char *out, size_t length, bool withTime) const;
+};
+
+/// @brief Deferred logger: the LOG_* macros only copy the pointers to the static strings and the raw arguments into a
+/// preallocated ring buffer (no String allocations, no blocking UART output). Formatting and the serial output are
+/// done by a task with idle priority. The ring buffer keeps the latest records, so they can also be shown in the webinterface.
+/// If the buffer is full the oldest records are overwritten, records that have been overwritten before they have been
+/// written to the serial port are counted as lost.
+class DeferredLogClass
+{
+private:
+    mutable portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    uint8_t _buffer[DEFERRED_LOG_SIZE];
+    uint32_t _head = 0;
+    uint32_t _tail = 0;
+    uint32_t _drained = 0;
+    uint32_t _records = 0;
+    uint32_t _lost = 0;
+    TaskHandle_t _task = nullptr;
+
+    void copyOut(uint32_t position, void *data, size_t size) const;
+    void copyIn(uint32_t position, const void *data, size_t size);
+    uint16_t readSize(uint32_t position) const;
+    void commit(DeferredLogRecord &record, uint8_t level, const __FlashStringHelper *cl, const __FlashStringHelper *fn, const __FlashStringHelper *fmt);
+    static void taskLoop(void *parameter);
+
+protected:
+public:
+    DeferredLogClass() {};
+
+    DeferredLogClass(const DeferredLogClass &) = delete;
+    DeferredLogClass &operator=(const DeferredLogClass &) = delete;
+
+    /// @brief Starts the task that writes the records to the serial port (records are buffered until then)
+    bool begin();
+
+    /// @brief Adds a record
+    /// @param level log level
+    /// @param cl class name (static string)
+    /// @param fn function name (static string)
+    /// @param fmt message (static string), each `{}` is replaced by the next argument
+    /// @param args arguments, strings are copied (truncated to DEFERRED_LOG_STRING_SIZE)
+    template <typename... Args>
+    void write(uint8_t level, const __FlashStringHelper *cl, const __FlashStringHelper *fn, const __FlashStringHelper *fmt, const Args &...args)
+    {
+        DeferredLogRecord record;
+        (record.arg(args), ...);
+        commit(record, level, cl, fn, fmt);
+    }
+
+    /// @brief Reads the record at the position and moves the position to the next record
+    /// @param position position of the record, 0 for the oldest record (moved to the oldest record if it has been overwritten)
+    /// @param record the record
+    /// @return false if there is no further record
+    bool read(uint32_t &position, DeferredLogRecord &record) const;
+
+    /// @brief Gets the amount of written records
+    uint32_t getRecordCount() const { return _records; };
+
+    /// @brief Gets the amount of records that have been overwritten before they have been written to the serial port
+    uint32_t getLostCount() const { return _lost; };
+};
+
+extern DeferredLogClass DeferredLog;
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include "ThermistorCalc.h"
+
+/// @brief Position of the digital potentiometer with the achieved output temperature
+struct DigitalPotiPosition
+{
+    /// @brief Wiper position of the digital potentiometer
+    uint16_t position;
+
+    /// @brief Temperature [celsius] that is simulated at the wiper position (pre-resistor + wiper)
+    float temperature;
+};
+
+/// @brief Precomputed table of all achievable output temperatures of the digital potentiometer
+/// (pre-resistor + wiper step), so that the output hot path does not need any transcendental math
+class DigitalPotiTable
+{
+private:
+    float *_temperatures;       // Achieved temperature [celsius] for each wiper position (descending, since NTC)
+    const uint16_t _stepMin;    // Minimum allowed wiper position
+    const uint16_t _stepMax;    // Maximum allowed wiper position
+
+protected:
+public:
+    /// @brief Creates the table for all wiper positions
+    /// @param thermistor The thermistor that is simulated by the digital potentiometer
+    /// @param steps Maximum amount of steps that the digital potentiometer supports (table contains steps + 1 positions)
+    /// @param stepMin Minimum step of the digital potentiometer to limit maximum current
+    /// @param resistance Maximum resistance of the digital potentiometer in Ohm
+    /// @param preResistance Pre-resistor of the digital potentiometer in Ohm
+    DigitalPotiTable(ThermistorCalc &thermistor, uint16_t steps, uint16_t stepMin, float resistance, float preResistance);
+
+    DigitalPotiTable(const DigitalPotiTable &) = delete;
+    DigitalPotiTable &operator=(const DigitalPotiTable &) = delete;
+    ~DigitalPotiTable();
+
+    /// @brief Gets the wiper position whose temperature is closest to the target temperature
+    /// @param targetTemperature The target temperature [celsius]
+    /// @return The wiper position and the achieved temperature
+    DigitalPotiPosition lookup(float targetTemperature) const;
+
+    /// @brief Gets the achieved temperature [celsius] of the given wiper position
+    float getTemperature(uint16_t position) const { return _temperatures[position]; };
+};
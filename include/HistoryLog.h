@@ -0,0 +1,128 @@
+#pragma once
+
+#include <FS.h>
+#include <time.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "HistoryStore.h"
+
+#define HISTORY_LOG_PATH "/history"         // Directory of the segment files on LittleFS
+#define HISTORY_LOG_TIER 1                  // Tier of the HistoryStore that is written to the log (1 min)
+#define HISTORY_LOG_PAGE_SIZE 256           // Size of a write in bytes (LittleFS program page), records are buffered until a page is full
+#define HISTORY_LOG_SEGMENT_SIZE 16384      // Maximum size of a segment file in bytes (1024 records, ~17 hours)
+#define HISTORY_LOG_SEGMENT_CNT 48          // Maximum amount of segment files, the oldest segment is removed (~34 days, 768 KB)
+
+/// @brief Record of the history log: aggregation of one minute
+struct HistoryLogRecord
+{
+    /// @brief Start of the minute, epoch unix in seconds, UTC
+    uint32_t time;
+
+    /// @brief min/max/mean of the input and output temperature (fixed point)
+    HistoryEntry entry;
+};
+
+static_assert(sizeof(HistoryLogRecord) == 16, "The layout of the HistoryLogRecord is part of the segment files");
+static_assert(HISTORY_LOG_PAGE_SIZE % sizeof(HistoryLogRecord) == 0 && HISTORY_LOG_SEGMENT_SIZE % HISTORY_LOG_PAGE_SIZE == 0, "Pages must not be split across records or segments");
+
+/// @brief Write counters of the history log
+struct HistoryLogStats
+{
+    /// @brief Amount of written records
+    uint32_t records = 0;
+
+    /// @brief Amount of page writes (each write is an append to the newest segment)
+    uint32_t writes = 0;
+
+    /// @brief Amount of written bytes
+    uint32_t bytes = 0;
+
+    /// @brief Amount of segments that have been started
+    uint32_t rotations = 0;
+
+    /// @brief Amount of failed writes (the page is dropped)
+    uint32_t failures = 0;
+
+    /// @brief Amount of segment files
+    uint32_t segments = 0;
+};
+
+/// @brief Append-only log of the 1 min history on LittleFS, so the history survives reboots and updates.
+/// The completed minutes of the HistoryStore are buffered as fixed size records and appended page by page
+/// (HISTORY_LOG_PAGE_SIZE) to the newest segment file. A full segment starts the next one and the oldest segment is
+/// removed if there are more than HISTORY_LOG_SEGMENT_CNT. Records are only written while the system time is known and
+/// with a time after the last record (the system time may be corrected), so they are sorted by time and can be searched by seeking.
+class HistoryLog
+{
+private:
+    mutable portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    StaticSemaphore_t _writeLockBuffer;
+    SemaphoreHandle_t _writeLock = nullptr;
+    bool _mounted = false;
+    uint32_t _firstSegment = 0;
+    uint32_t _lastSegment = 0;
+    uint32_t _segmentSize = 0;
+    uint32_t _nextSlot = 0;
+    uint32_t _lastTime = 0;
+    HistoryLogRecord _page[HISTORY_LOG_PAGE_SIZE / sizeof(HistoryLogRecord)];
+    uint8_t _pageCount = 0;
+    HistoryLogStats _stats;
+
+    void writePage();
+
+protected:
+public:
+    HistoryLog() {};
+
+    HistoryLog(const HistoryLog &) = delete;
+    HistoryLog &operator=(const HistoryLog &) = delete;
+
+    /// @brief Mounts LittleFS (formatted if it can't be mounted) and finds the segment files
+    /// @return false if LittleFS is not available
+    bool begin();
+
+    /// @brief Adds the minutes that have been completed since the last call to the page, writes the page if it is full
+    /// @param history the history
+    /// @param bootTime time of the boot (uptime 0), epoch unix in seconds, UTC
+    void update(const HistoryStore &history, time_t bootTime);
+
+    /// @brief Writes the buffered records (e.g. before a restart), can be called by another task than update()
+    void flush();
+
+    /// @brief Gets the range of segment files
+    /// @return false if there are no segments
+    bool getSegments(uint32_t &first, uint32_t &last) const;
+
+    /// @brief Gets the write counters
+    HistoryLogStats getStats() const;
+
+    /// @brief Gets the path of a segment file
+    static void getSegmentPath(uint32_t segment, char *path, size_t size);
+};
+
+/// @brief Reads the records of a time range from the segment files, record by record without loading the files
+class HistoryLogReader
+{
+private:
+    const HistoryLog *_log;
+    const time_t _from;
+    const time_t _to;
+    uint32_t _segment;
+    uint32_t _lastSegment;
+    bool _done = false;
+    fs::File _file;
+
+    bool openSegment();
+
+protected:
+public:
+    /// @brief Creates the reader
+    /// @param log the log
+    /// @param from start of the range, epoch unix in seconds, UTC
+    /// @param to end of the range (included), epoch unix in seconds, UTC
+    HistoryLogReader(const HistoryLog *log, time_t from, time_t to);
+
+    /// @brief Reads the next record
+    /// @return false if there are no further records inside the range
+    bool next(HistoryLogRecord &record);
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <freertos/FreeRTOS.h>
+
+#define HISTORY_CHANNEL_CNT 2           // Amount of recorded values (input and output temperature)
+#define HISTORY_TIER_CNT 3              // Amount of resolution tiers
+#define HISTORY_SECONDS_CNT 3600        // Entries of the 1 s tier (1 hour)
+#define HISTORY_MINUTES_CNT 1440        // Entries of the 1 min tier (1 day)
+#define HISTORY_QUARTERS_CNT 2880       // Entries of the 15 min tier (30 days)
+#define HISTORY_SCALE 100               // Fixed point scale of the values (0.01 °C)
+#define HISTORY_NO_VALUE INT16_MIN      // Fixed point value of a missing value (NAN)
+
+/// @brief Value of all channels for one second (fixed point)
+struct HistoryPoint
+{
+    int16_t value[HISTORY_CHANNEL_CNT];
+};
+
+/// @brief Aggregation of all channels for one period of a tier (fixed point, HISTORY_NO_VALUE if there was no value)
+struct HistoryEntry
+{
+    int16_t min[HISTORY_CHANNEL_CNT];
+    int16_t max[HISTORY_CHANNEL_CNT];
+    int16_t mean[HISTORY_CHANNEL_CNT];
+};
+
+/// @brief RAM footprint of the ring buffers in bytes
+constexpr size_t HISTORY_FOOTPRINT = sizeof(HistoryPoint) * HISTORY_SECONDS_CNT + sizeof(HistoryEntry) * (HISTORY_MINUTES_CNT + HISTORY_QUARTERS_CNT);
+static_assert(HISTORY_FOOTPRINT <= 66240, "The history is limited to about 65 KB of RAM");
+
+/// @brief History of the input and output temperature in RAM with three resolution tiers: 1 s for the last hour,
+/// 1 min for the last day and 15 min for the last 30 days. The 1 s tier stores the values, the other tiers store
+/// min/max/mean that are aggregated incrementally on insert (a period is added to its ring when the next period starts).
+/// The rings are indexed by the period number since boot, so periods without values are kept as gaps and range queries
+/// read the entries straight from the ring. All times are seconds since boot.
+class HistoryStore
+{
+private:
+    struct Tier
+    {
+        uint32_t period;
+        uint16_t count;
+        uint32_t first = UINT32_MAX;
+        uint32_t last = UINT32_MAX;
+    };
+
+    struct Accumulator
+    {
+        uint32_t slot = UINT32_MAX;
+        int32_t sum[HISTORY_CHANNEL_CNT];
+        uint16_t samples[HISTORY_CHANNEL_CNT];
+        int16_t min[HISTORY_CHANNEL_CNT];
+        int16_t max[HISTORY_CHANNEL_CNT];
+    };
+
+    mutable portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    Tier _tiers[HISTORY_TIER_CNT];
+    Accumulator _accumulators[HISTORY_TIER_CNT];
+    HistoryPoint _seconds[HISTORY_SECONDS_CNT];
+    HistoryEntry _minutes[HISTORY_MINUTES_CNT];
+    HistoryEntry _quarters[HISTORY_QUARTERS_CNT];
+
+    void advance(uint8_t tier, uint32_t slot);
+    void write(uint8_t tier, uint32_t slot, const HistoryEntry &entry);
+    void accumulate(uint8_t tier, uint32_t slot, const int16_t *values);
+
+protected:
+public:
+    HistoryStore();
+
+    HistoryStore(const HistoryStore &) = delete;
+    HistoryStore &operator=(const HistoryStore &) = delete;
+
+    /// @brief Adds the values of a second, needs to be called once per second. A second that is added again only replaces
+    /// its value inside the 1 s tier (the other tiers keep the first value), a second before the 1 s ring is ignored
+    /// @param time seconds since boot
+    /// @param values value of each channel (NAN if not available)
+    void add(uint32_t time, const float *values);
+
+    /// @brief Reads the entry of a period
+    /// @param tier the tier (0 = 1 s, 1 = 1 min, 2 = 15 min)
+    /// @param slot the period number (seconds since boot / period)
+    /// @param entry the entry, min/max/mean are equal for the 1 s tier
+    /// @return false if the period is not inside the ring
+    bool read(uint8_t tier, uint32_t slot, HistoryEntry &entry) const;
+
+    /// @brief Gets the range of periods inside the ring of a tier
+    /// @param first the oldest period number
+    /// @param last the newest period number
+    /// @return false if the tier has no entries yet
+    bool getRange(uint8_t tier, uint32_t &first, uint32_t &last) const;
+
+    /// @brief Gets the period of a tier in seconds
+    uint32_t getPeriod(uint8_t tier) const { return _tiers[tier].period; };
+
+    /// @brief Gets the amount of entries of a tier
+    uint16_t getCount(uint8_t tier) const { return _tiers[tier].count; };
+
+    /// @brief Converts a value to fixed point
+    static int16_t toFixed(float value);
+
+    /// @brief Converts a fixed point value to float (NAN if HISTORY_NO_VALUE)
+    static float toFloat(int16_t value);
+};
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * @brief Allocation free sliding window median filter with a fixed capacity of N samples.
+ *
+ * The window is kept in two indexed heaps around the median (max heap for the lower half,
+ * min heap for the upper half), so that adding a sample replaces the oldest one in O(log N)
+ * and the median is available in O(1) without re-sorting the buffer.
+ * The trimmed mean averages all samples of the window that are within a maximum deviation
+ * from the median, the rejected samples are counted as outliers.
+ */
+template <uint16_t N>
+class MedianFilter
+{
+private:
+    static_assert(N > 0 && N < INT16_MAX, "MedianFilter capacity out of range");
+
+    float _data[N];             // Samples as ring buffer
+    int16_t _pos[N];            // Heap position for each sample (<0 max heap, 0 median, >0 min heap)
+    int16_t _heapStorage[N];    // Sample index for each heap position
+    int16_t *_heap;             // Heap with median at index 0
+    uint16_t _index = 0;        // Next sample index that will be replaced
+    uint16_t _count = 0;        // Amount of samples inside the window
+    uint32_t _samples = 0;      // Total amount of samples that has been added
+    uint32_t _outliers = 0;     // Total amount of samples rejected by the trimmed mean
+    uint16_t _lastOutliers = 0; // Amount of samples rejected by the last trimmed mean
+
+    int minCount() const { return (_count - 1) / 2; }
+    int maxCount() const { return _count / 2; }
+
+    bool less(int i, int j) const { return _data[_heap[i]] < _data[_heap[j]]; }
+
+    void exchange(int i, int j)
+    {
+        int16_t t = _heap[i];
+        _heap[i] = _heap[j];
+        _heap[j] = t;
+        _pos[_heap[i]] = i;
+        _pos[_heap[j]] = j;
+    }
+
+    /// @brief Swaps i and j if heap[i] < heap[j], returns if swapped
+    bool compareExchange(int i, int j)
+    {
+        if (!less(i, j))
+            return false;
+
+        exchange(i, j);
+        return true;
+    }
+
+    /// @brief Moves item i down inside the min heap until the min heap property is restored
+    void minSortDown(int i)
+    {
+        for (int child = i * 2; child <= minCount(); i = child, child *= 2)
+        {
+            if (child < minCount() && less(child + 1, child))
+                ++child;
+            if (!compareExchange(child, i))
+                break;
+        }
+    }
+
+    /// @brief Moves item i down inside the max heap (negative indexes) until the max heap property is restored
+    void maxSortDown(int i)
+    {
+        for (int child = i * 2; child >= -maxCount(); i = child, child *= 2)
+        {
+            if (child > -maxCount() && less(child, child - 1))
+                --child;
+            if (!compareExchange(i, child))
+                break;
+        }
+    }
+
+    /// @brief Moves item i up inside the min heap up to the median, returns if it has become the median
+    bool minSortUp(int i)
+    {
+        while (i > 0 && compareExchange(i, i / 2))
+            i /= 2;
+        return i == 0;
+    }
+
+    /// @brief Moves item i up inside the max heap up to the median, returns if it has become the median
+    bool maxSortUp(int i)
+    {
+        while (i < 0 && compareExchange(i / 2, i))
+            i /= 2;
+        return i == 0;
+    }
+
+public:
+    MedianFilter() : _heap(_heapStorage + N / 2) { clear(); }
+
+    MedianFilter(const MedianFilter &) = delete;
+    MedianFilter &operator=(const MedianFilter &) = delete;
+
+    /// @brief Removes all samples from the window and restarts the sample count (the outlier statistics are kept)
+    void clear()
+    {
+        _index = 0;
+        _count = 0;
+        _samples = 0;
+        // Initial heap fill pattern: median, max, min, max, min, ...
+        for (int i = N - 1; i >= 0; i--)
+        {
+            _pos[i] = ((i + 1) / 2) * ((i & 1) ? -1 : 1);
+            _heap[_pos[i]] = i;
+            _data[i] = 0;
+        }
+    }
+
+    /// @brief Adds a sample, if the window is full the oldest sample gets replaced
+    /// @param value the new sample
+    void add(float value)
+    {
+        bool isNew = _count < N;
+        int p = _pos[_index];
+        float old = _data[_index];
+        _data[_index] = value;
+        _index = (_index + 1) % N;
+        _count += isNew ? 1 : 0;
+        _samples++;
+
+        if (p > 0)
+        {
+            // Sample is inside the min heap, if it becomes the median the old median moves into the min heap
+            // and the new median needs to be checked against the max heap
+            if (!isNew && old < value)
+                minSortDown(p);
+            else if (minSortUp(p) && maxCount() > 0 && maxSortUp(-1))
+                maxSortDown(-1);
+        }
+        else if (p < 0)
+        {
+            // Sample is inside the max heap
+            if (!isNew && value < old)
+                maxSortDown(p);
+            else if (maxSortUp(p) && minCount() > 0 && minSortUp(1))
+                minSortDown(1);
+        }
+        else
+        {
+            // Sample is the median, check against both heaps
+            if (maxCount() > 0 && maxSortUp(-1))
+                maxSortDown(-1);
+            else if (minCount() > 0 && minSortUp(1))
+                minSortDown(1);
+        }
+    }
+
+    /// @brief Gets the amount of samples inside the window
+    uint16_t getCount() const { return _count; };
+
+    /// @brief Gets the capacity of the window
+    uint16_t getSize() const { return N; };
+
+    /// @brief Gets the amount of samples that has been added since the last clear()
+    uint32_t getSampleCount() const { return _samples; };
+
+    /// @brief Gets the total amount of samples that has been rejected as outlier by getTrimmedMean()
+    uint32_t getOutlierCount() const { return _outliers; };
+
+    /// @brief Gets the amount of samples that has been rejected as outlier by the last getTrimmedMean()
+    uint16_t getLastOutlierCount() const { return _lastOutliers; };
+
+    /// @brief Gets the median of the window in O(1)
+    /// @return the median or NAN if the window is empty
+    float getMedian() const
+    {
+        if (_count < 1)
+            return NAN;
+
+        float value = _data[_heap[0]];
+        if ((_count & 1) == 0)
+            value = (value + _data[_heap[-1]]) / 2;
+        return value;
+    }
+
+    /// @brief Gets the mean of all samples inside the window that are within the maximum deviation from the median in O(N)
+    /// @param maxDeviation the maximum deviation from the median, samples outside are rejected as outlier
+    /// @return the trimmed mean or NAN if the window is empty
+    float getTrimmedMean(float maxDeviation)
+    {
+        float median = getMedian();
+        if (isnanf(median))
+            return NAN;
+
+        float sum = 0;
+        uint16_t used = 0;
+        for (uint16_t i = 0; i < _count; i++)
+        {
+            if (fabsf(_data[i] - median) <= maxDeviation)
+            {
+                sum += _data[i];
+                used++;
+            }
+        }
+
+        _lastOutliers = _count - used;
+        _outliers += _lastOutliers;
+        return used > 0 ? sum / used : median;
+    }
+};
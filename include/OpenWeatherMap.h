@@ -1,6 +1,16 @@
 #pragma once
 
 #include <HTTPClient.h>
+#include <WiFiClientSecure.h>
+#include <ArduinoJson.h>
+#include "ApiRequestStats.h"
+#include "WeatherSeries.h"
+
+/// @brief Default base URL of the OpenWeatherMap API
+#define OPEN_WEATHER_MAP_URL "https://api.openweathermap.org"
+
+/// @brief Default timeout in milliseconds of an API request (connecting and reading the response)
+#define OPEN_WEATHER_MAP_TIMEOUT 5000
 
 /// @brief API request error type
 enum Error 
@@ -38,32 +48,98 @@ struct ApiResponse
 
     /// @brief Gets the timestamp of the temperature
     const String timestamp;
+
+    /// @brief Time of the temperature, epoch unix in seconds, UTC (0 if request failed)
+    time_t time = 0;
+
+    /// @brief Time of the server from the HTTP Date header, epoch unix in seconds, UTC (0 if unknown)
+    time_t serverTime = 0;
+
+    /// @brief Statistics of the request
+    ApiRequestStats stats;
+};
+
+/// @brief Represents the API forecast response, plain data so it can be handed over between tasks without allocation
+struct ForecastResponse
+{
+    /// @brief Gets if the request was successful
+    bool successful;
+
+    /// @brief Error
+    Error error;
+
+    /// @brief HTTP code RFC7231
+    int httpCode;
+
+    /// @brief Amount of forecast points
+    uint8_t count;
+
+    /// @brief Forecast points in ascending time order
+    WeatherPoint points[WEATHER_FORECAST_SIZE];
+
+    /// @brief Time of the server from the HTTP Date header, epoch unix in seconds, UTC (0 if unknown)
+    time_t serverTime;
+
+    /// @brief Statistics of the request
+    ApiRequestStats stats;
 };
 
-/// @brief Implements the OpenWeatherMap API https://openweathermap.org/current
+/// @brief Implements the OpenWeatherMap API https://openweathermap.org/current and https://openweathermap.org/forecast5
 /// NOTE: Free API is limited to 60 calls/minute or 1,000,000 calls/month
 /// A API key can be created for free at https://home.openweathermap.org/users/sign_up
 class OpenWeatherMap
 {
 private:
+    uint16_t _timeout = OPEN_WEATHER_MAP_TIMEOUT;
+    String _host;
+    uint16_t _port;
+    WiFiClientSecure *_secureClient = nullptr;
+    WiFiClient *_client;
+    HTTPClient _http;
+
+    void init();
+    bool connect(ApiRequestStats &stats, unsigned long deadline);
+    Error get(const String &url, JsonDocument &filter, JsonDocument &doc, int &httpCode, time_t &serverTime, ApiRequestStats &stats);
+
 protected:
 public:
 
     /// @brief URL that is used for the API requests
     const String apiUrl;
 
+    /// @brief URL that is used for the API forecast requests
+    const String forecastUrl;
+
     /// @brief Creates an instance of the OpenWeatherMap API
     /// @param apiKey Your API key
     /// @param cityId The city ID can be taken from https://openweathermap.org/ by search from URL (https://openweathermap.org/city/xxxxxxx)
-    OpenWeatherMap(String apiKey, unsigned int cityId);
+    /// @param baseUrl Base URL of the API, can be replaced by a local stand-in server for testing (e.g. http://192.168.1.10:8080)
+    OpenWeatherMap(String apiKey, unsigned int cityId, const String &baseUrl = OPEN_WEATHER_MAP_URL);
 
     /// @brief Creates an instance of the OpenWeatherMap API
     /// @param apiKey Your API key
     /// @param latitude Location latitude (can be taken from google maps with right-click)
     /// @param longitude Location longitude (can be taken from google maps with right-click)
-    OpenWeatherMap(String apiKey, double latitude, double longitude);
+    /// @param baseUrl Base URL of the API, can be replaced by a local stand-in server for testing (e.g. http://192.168.1.10:8080)
+    OpenWeatherMap(String apiKey, double latitude, double longitude, const String &baseUrl = OPEN_WEATHER_MAP_URL);
+
+    /// @brief Sets the timeout budget of a request, one deadline covers the connect, the response header and the body
+    /// @param timeout the timeout in milliseconds
+    void setTimeout(const uint16_t timeout) { _timeout = timeout; };
 
-    /// @brief Sends a API request (may take a while and will block)
+    /// @brief Gets the timeout budget of a request in milliseconds
+    uint16_t getTimeout() const { return _timeout; };
+
+    OpenWeatherMap(const OpenWeatherMap &) = delete;
+    OpenWeatherMap &operator=(const OpenWeatherMap &) = delete;
+    ~OpenWeatherMap();
+
+    /// @brief Sends a API request (may take up to the timeout budget and will block, use WeatherFetcher to run it in the background).
+    /// The connection is kept open (keep-alive) and reused by the next request, a new connection is only established if it has been closed
     /// @return the API response
     ApiResponse request();
+
+    /// @brief Sends a API forecast request for the next WEATHER_FORECAST_SIZE points in 3 hour steps (blocking like request())
+    /// @return the API forecast response
+    ForecastResponse requestForecast();
 };
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <functional>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "SharedState.h"
+
+/// @brief Timing statistics of a PeriodicTask
+struct PeriodicTaskStats
+{
+    /// @brief Period of the task in microseconds
+    uint32_t period = 0;
+
+    /// @brief Amount of executed cycles
+    uint32_t cycles = 0;
+
+    /// @brief Amount of cycles that took longer than the period
+    uint32_t overruns = 0;
+
+    /// @brief Deviation of the last wake up from the scheduled time in microseconds
+    uint32_t jitter = 0;
+
+    /// @brief Worst case deviation of the wake up from the scheduled time in microseconds
+    uint32_t jitterMax = 0;
+
+    /// @brief Average deviation of the wake up from the scheduled time in microseconds
+    uint32_t jitterAvg = 0;
+
+    /// @brief Worst case execution time of a cycle in microseconds
+    uint32_t execMax = 0;
+};
+
+/// @brief Runs a function with a fixed period inside a FreeRTOS task pinned to a core (vTaskDelayUntil, so the
+/// execution time does not add up to the period) and measures the wake up jitter and the execution time of each cycle
+class PeriodicTask
+{
+private:
+    const char *_name;
+    const uint32_t _periodMs;
+    std::function<void()> _function;
+    TaskHandle_t _task = nullptr;
+    SharedState<PeriodicTaskStats> _stats;
+
+    static void taskLoop(void *parameter);
+
+protected:
+public:
+    /// @brief Creates the task definition, the task is started by begin()
+    /// @param name Name of the task
+    /// @param periodMs Period in milliseconds (multiple of the FreeRTOS tick)
+    /// @param function Function that is executed each period
+    PeriodicTask(const char *name, uint32_t periodMs, std::function<void()> function) : _name(name), _periodMs(periodMs), _function(function) {};
+
+    PeriodicTask(const PeriodicTask &) = delete;
+    PeriodicTask &operator=(const PeriodicTask &) = delete;
+
+    /// @brief Creates the task
+    /// @param stackSize Stack size in bytes
+    /// @param priority FreeRTOS priority
+    /// @param core Core the task is pinned to
+    /// @return true if the task is running
+    bool begin(uint32_t stackSize, UBaseType_t priority, BaseType_t core);
+
+    /// @brief Gets a snapshot of the timing statistics (thread safe)
+    PeriodicTaskStats getStats() const { return _stats.load(); };
+};
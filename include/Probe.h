@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+
+#define PROBE_BUCKET_CNT 16 // Amount of log2 histogram buckets: <2 us, <4 us, <8 us, ... <32768 us, >=32768 us
+#define PROBE_MAX_CNT 16    // Maximum amount of registered probes
+
+/// @brief Distribution of measured times in microseconds with log2 buckets (bucket i counts values below 2^(i+1) us)
+struct ProbeHistogram
+{
+    /// @brief Amount of values
+    uint32_t count = 0;
+
+    /// @brief Minimum value
+    uint32_t min = UINT32_MAX;
+
+    /// @brief Maximum value
+    uint32_t max = 0;
+
+    /// @brief Sum of all values
+    uint64_t sum = 0;
+
+    /// @brief Amount of values per bucket
+    uint32_t buckets[PROBE_BUCKET_CNT] = {};
+
+    /// @brief Adds a value
+    void add(uint32_t value);
+
+    /// @brief Gets the average value (0 if empty)
+    uint32_t getAverage() const { return count > 0 ? sum / count : 0; };
+
+    /// @brief Gets the minimum value (0 if empty)
+    uint32_t getMin() const { return count > 0 ? min : 0; };
+
+    /// @brief Gets the upper bound of the bucket that contains the percentile (e.g. 99 for p99), the maximum for the last bucket
+    uint32_t getPercentile(uint8_t percent) const;
+
+    /// @brief Gets the upper bound of a bucket in microseconds (exclusive)
+    static uint32_t getBucketLimit(uint8_t bucket) { return 2UL << bucket; };
+};
+
+/// @brief Statistics of a probe
+struct ProbeStats
+{
+    /// @brief Name of the probe
+    const char *name = nullptr;
+
+    /// @brief Expected period between two starts in microseconds (0 if not periodic)
+    uint32_t period = 0;
+
+    /// @brief Execution time between begin() and end()
+    ProbeHistogram exec;
+
+    /// @brief Deviation of the time between two starts from the period (time between two starts if not periodic)
+    ProbeHistogram jitter;
+};
+
+/// @brief Lightweight execution time and inter-arrival jitter measurement of a named code section.
+/// Probes are created as globals and register themselves, so all of them can be listed (e.g. System tab, JSON endpoint).
+/// Recording takes a short spinlock, so probes can be written by one task and read by any other task.
+/// The time source is esp_timer_get_time() and can be replaced by defining PROBE_CLOCK (e.g. mock clock on the host).
+class Probe
+{
+private:
+    static Probe *_probes[PROBE_MAX_CNT];
+    static uint8_t _count;
+
+    mutable portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    ProbeStats _stats;
+    int64_t _start = 0;
+    int64_t _lastStart = -1;
+
+protected:
+public:
+    /// @brief Creates and registers the probe
+    /// @param name Name of the probe (static string)
+    /// @param periodUs Expected period between two starts in microseconds (0 if not periodic)
+    Probe(const char *name, uint32_t periodUs = 0);
+
+    Probe(const Probe &) = delete;
+    Probe &operator=(const Probe &) = delete;
+
+    /// @brief Marks the start of the measured section
+    void begin();
+
+    /// @brief Marks the end of the measured section
+    void end();
+
+    /// @brief Gets a copy of the statistics
+    ProbeStats getStats() const;
+
+    /// @brief Resets the statistics
+    void reset();
+
+    /// @brief Gets the amount of registered probes
+    static uint8_t getCount() { return _count; };
+
+    /// @brief Gets a registered probe
+    /// @param index index in the order of creation
+    static Probe *get(uint8_t index) { return index < _count ? _probes[index] : nullptr; };
+};
+
+/// @brief Measures the scope of a code block with a Probe
+class ProbeScope
+{
+private:
+    Probe &_probe;
+
+public:
+    ProbeScope(Probe &probe) : _probe(probe) { _probe.begin(); };
+    ~ProbeScope() { _probe.end(); };
+
+    ProbeScope(const ProbeScope &) = delete;
+    ProbeScope &operator=(const ProbeScope &) = delete;
+};
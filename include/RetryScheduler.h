@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+
+/// @brief Counters of the RetryScheduler
+struct RetrySchedulerStats
+{
+    /// @brief Amount of started attempts
+    uint32_t attempts = 0;
+
+    /// @brief Amount of successful attempts
+    uint32_t successes = 0;
+
+    /// @brief Amount of failed attempts
+    uint32_t failures = 0;
+
+    /// @brief Amount of due attempts that have been skipped (e.g. network not connected)
+    uint32_t skipped = 0;
+
+    /// @brief Amount of failed attempts since the last success
+    uint8_t consecutiveFailures = 0;
+
+    /// @brief Last delay until the next attempt in milliseconds
+    uint32_t delay = 0;
+};
+
+/// @brief Schedules a cyclic operation with capped exponential backoff and jitter if it fails.
+/// After a success the next attempt is due after the interval, after each failure the retry delay starts with
+/// the minimum delay and doubles up to the maximum delay. The retry delay is reduced by a random jitter,
+/// so devices that failed at the same time (e.g. ISP outage) are not retrying in lockstep.
+class RetryScheduler
+{
+private:
+    const uint32_t _interval;
+    const uint32_t _retryMin;
+    const uint32_t _retryMax;
+    const uint8_t _jitterPercent;
+    uint32_t _lastTime = 0;
+    bool _skipping = false;
+    RetrySchedulerStats _stats;
+
+    void schedule(uint32_t now, uint32_t delay);
+
+protected:
+public:
+    /// @brief Creates the scheduler, the first attempt is due immediately
+    /// @param interval Delay after a successful attempt in milliseconds
+    /// @param retryMin Delay after the first failed attempt in milliseconds
+    /// @param retryMax Maximum delay after failed attempts in milliseconds
+    /// @param jitterPercent Maximum random reduction of the retry delay in percent
+    RetryScheduler(uint32_t interval, uint32_t retryMin, uint32_t retryMax, uint8_t jitterPercent)
+        : _interval(interval), _retryMin(retryMin), _retryMax(retryMax), _jitterPercent(jitterPercent > 100 ? 100 : jitterPercent) {};
+
+    /// @brief Gets if the next attempt is due
+    /// @param now Current time in milliseconds
+    bool isDue(uint32_t now) const { return now - _lastTime >= _stats.delay; };
+
+    /// @brief Marks a due attempt as skipped, the attempt stays due (counted once per due attempt)
+    void skip();
+
+    /// @brief Marks the start of an attempt
+    void attempt();
+
+    /// @brief Reports a successful attempt, the next attempt is due after the interval
+    /// @param now Current time in milliseconds
+    void succeeded(uint32_t now);
+
+    /// @brief Reports a failed attempt, the next attempt is due after the backoff delay
+    /// @param now Current time in milliseconds
+    void failed(uint32_t now);
+
+    /// @brief Gets the counters
+    const RetrySchedulerStats &getStats() const { return _stats; };
+};
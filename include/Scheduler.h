@@ -0,0 +1,177 @@
+#pragma once
+
+#include <stdint.h>
+
+/// @brief Callback of a scheduled job
+typedef void (*SchedulerCallback)();
+
+/// @brief Timing statistics of a scheduled job, all times in microseconds
+struct SchedulerJobStats
+{
+    /// @brief Name of the job
+    const char *name = nullptr;
+
+    /// @brief Period of the job
+    uint32_t period = 0;
+
+    /// @brief Amount of executions
+    uint32_t runs = 0;
+
+    /// @brief Amount of periods that have been skipped because the job could not be started in time
+    uint32_t missed = 0;
+
+    /// @brief Amount of executions that took longer than the period
+    uint32_t overruns = 0;
+
+    /// @brief Delay of the last start after the deadline
+    uint32_t late = 0;
+
+    /// @brief Maximum delay of the start after the deadline
+    uint32_t lateMax = 0;
+
+    /// @brief Execution time of the last run
+    uint32_t exec = 0;
+
+    /// @brief Maximum execution time
+    uint32_t execMax = 0;
+
+    /// @brief Sum of all execution times (average = execTotal / runs)
+    uint64_t execTotal = 0;
+};
+
+/// @brief Copy of the statistics of all jobs of a Scheduler, plain data so it can be handed over between tasks
+template <uint8_t N>
+struct SchedulerSnapshot
+{
+    /// @brief Amount of jobs
+    uint8_t count = 0;
+
+    /// @brief Statistics of the jobs
+    SchedulerJobStats jobs[N];
+};
+
+/// @brief Deadline aware scheduler for periodic jobs with a fixed capacity of N jobs.
+/// Jobs are scheduled with a fixed rate: the next deadline is always the last deadline plus the period, so a late
+/// start does not shift the cadence. If a job is so late that whole periods have passed, the missed periods are
+/// skipped and counted instead of running the job back to back. Due jobs are started in the order they have been added.
+/// @tparam N maximum amount of jobs
+/// @tparam Clock time source in microseconds (e.g. micros, or a mock clock on the host)
+template <uint8_t N, unsigned long (*Clock)()>
+class Scheduler
+{
+private:
+    struct Job
+    {
+        SchedulerCallback callback;
+        uint32_t next;
+        SchedulerJobStats stats;
+    };
+
+    Job _jobs[N];
+    uint8_t _count = 0;
+    const uint32_t _tolerance;
+
+public:
+    /// @brief Creates the scheduler
+    /// @param toleranceUs Jobs are started up to this time before their deadline, so a caller that is woken up slightly
+    /// early (e.g. by the FreeRTOS tick) does not delay the job by a whole call cycle
+    Scheduler(uint32_t toleranceUs = 0) : _tolerance(toleranceUs) {}
+
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+
+    /// @brief Adds a periodic job, the first run is due after the offset
+    /// @param name Name of the job (static string)
+    /// @param periodMs Period in milliseconds
+    /// @param callback Function that is executed each period
+    /// @param offsetMs Delay of the first run in milliseconds
+    /// @return false if the scheduler is full
+    bool every(const char *name, uint32_t periodMs, SchedulerCallback callback, uint32_t offsetMs = 0)
+    {
+        if (_count >= N || periodMs == 0 || !callback)
+            return false;
+
+        Job &job = _jobs[_count++];
+        job.callback = callback;
+        job.next = (uint32_t)Clock() + offsetMs * 1000;
+        job.stats = SchedulerJobStats();
+        job.stats.name = name;
+        job.stats.period = periodMs * 1000;
+        return true;
+    }
+
+    /// @brief Runs all due jobs, needs to be called at least with the shortest period
+    /// @return Microseconds until the next deadline (0 if a job is already due again)
+    uint32_t tick()
+    {
+        for (uint8_t i = 0; i < _count; i++)
+        {
+            Job &job = _jobs[i];
+            uint32_t start = Clock();
+            int32_t late = start - job.next;
+            if (late < -(int32_t)_tolerance)
+                continue;
+            if (late < 0)
+                late = 0;
+
+            job.callback();
+            uint32_t exec = (uint32_t)Clock() - start;
+
+            SchedulerJobStats &stats = job.stats;
+            stats.runs++;
+            stats.late = late;
+            if ((uint32_t)late > stats.lateMax)
+                stats.lateMax = late;
+            stats.exec = exec;
+            if (exec > stats.execMax)
+                stats.execMax = exec;
+            stats.execTotal += exec;
+            if (exec > stats.period)
+                stats.overruns++;
+
+            // Fixed rate: keep the cadence, skip (and count) the periods that have already passed
+            job.next += stats.period;
+            int32_t behind = (uint32_t)Clock() - job.next;
+            if (behind > 0)
+            {
+                uint32_t missed = behind / stats.period + 1;
+                stats.missed += missed;
+                job.next += missed * stats.period;
+            }
+        }
+
+        return getTimeUntilDue();
+    }
+
+    /// @brief Gets the time until the next job is due in microseconds (0 if a job is due, UINT32_MAX without jobs)
+    uint32_t getTimeUntilDue() const
+    {
+        uint32_t now = Clock();
+        uint32_t result = UINT32_MAX;
+        for (uint8_t i = 0; i < _count; i++)
+        {
+            int32_t remaining = _jobs[i].next - now - _tolerance;
+            if (remaining <= 0)
+                return 0;
+            if ((uint32_t)remaining < result)
+                result = remaining;
+        }
+
+        return result;
+    }
+
+    /// @brief Gets the amount of jobs
+    uint8_t getCount() const { return _count; };
+
+    /// @brief Gets the statistics of a job
+    /// @param index index of the job in the order they have been added
+    const SchedulerJobStats &getStats(uint8_t index) const { return _jobs[index].stats; };
+
+    /// @brief Copies the statistics of all jobs
+    void getSnapshot(SchedulerSnapshot<N> &snapshot) const
+    {
+        snapshot.count = _count;
+        for (uint8_t i = 0; i < _count; i++)
+            snapshot.jobs[i] = _jobs[i].stats;
+    }
+};
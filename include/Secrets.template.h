@@ -14,4 +14,8 @@
 #define WEATHER_LONGITUDE 0
 
 /// @brief Initial password for WiFi configuration AP 
-#define WIFI_CONFIG_PASSWORD "MyPassword"
\ No newline at end of file
+#define WIFI_CONFIG_PASSWORD "MyPassword"
+
+/// @brief Optional base URL of the weather API (default https://api.openweathermap.org). Can point to a local stand-in server for
+/// testing, e.g. "http://192.168.1.10:8080" with `python3 -m http.server 8080` serving a response JSON as file data/2.5/weather
+// #define WEATHER_API_URL "http://192.168.1.10:8080"
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "DeferredLog.h"
+
 #define ERROR 4     // Error log level
 #define WARNING 3   // Warning log level
 #define INFO 2      // Info log level
@@ -10,18 +12,25 @@
     #define LOG_LEVEL NONE
 #endif
 
+#if LOG_LEVEL != NONE && !DEFERRED_LOG_ENABLED
+    #error "LOG_LEVEL requires the deferred logger, add -D DEFERRED_LOG_ENABLED=1 to the build_flags"
+#endif
+
+// Usage: LOG_INFO(F("Class"), F("function"), F("Message with {} and {}"), value1, value2)
+// The records are written into the ring buffer of the DeferredLog and printed by its task (see DeferredLog.h)
+
 #if LOG_LEVEL == DEBUG
-    #define LOG_DEBUG(cl, fn, msg) Serial.println(String(F("DEBUG\t[")) + cl + String(F(".")) + fn + String(F("] ")) + msg)
+    #define LOG_DEBUG(cl, fn, ...) DeferredLog.write(DEBUG, cl, fn, __VA_ARGS__)
 #endif
 
 #if LOG_LEVEL == DEBUG || LOG_LEVEL == INFO
-    #define LOG_INFO(cl, fn, msg) Serial.println(String(F("INFO\t[")) + cl + String(F(".")) + fn + String(F("] ")) + msg)
+    #define LOG_INFO(cl, fn, ...) DeferredLog.write(INFO, cl, fn, __VA_ARGS__)
 #endif
 
 #if LOG_LEVEL == DEBUG || LOG_LEVEL == INFO || LOG_LEVEL == WARNING
-    #define LOG_WARNING(cl, fn, msg) Serial.println(String(F("WARNING\t[")) + cl + String(F(".")) + fn + String(F("] ")) + msg)
+    #define LOG_WARNING(cl, fn, ...) DeferredLog.write(WARNING, cl, fn, __VA_ARGS__)
 #endif
 
 #if LOG_LEVEL == DEBUG || LOG_LEVEL == INFO || LOG_LEVEL == WARNING || LOG_LEVEL == ERROR
-    #define LOG_ERROR(cl, fn, msg) Serial.println(String(F("ERROR\t[")) + cl + String(F(".")) + fn + String(F("] ")) + msg)
-#endif
\ No newline at end of file
+    #define LOG_ERROR(cl, fn, ...) DeferredLog.write(ERROR, cl, fn, __VA_ARGS__)
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+
+/// @brief Holds a copy of a value that is written by one task and read by other tasks (e.g. control task and network/UI task).
+/// The value is copied in and out under a spinlock, so readers always get a consistent snapshot and never block for longer than the copy.
+/// @tparam T plain data type of the value (should be small, it is copied with interrupts disabled on the current core)
+template <typename T>
+class SharedState
+{
+private:
+    mutable portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    T _value;
+    uint32_t _version = 0;
+
+public:
+    SharedState() : _value() {}
+    SharedState(const T &value) : _value(value) {}
+
+    SharedState(const SharedState &) = delete;
+    SharedState &operator=(const SharedState &) = delete;
+
+    /// @brief Stores a new value
+    void store(const T &value)
+    {
+        portENTER_CRITICAL(&_mux);
+        _value = value;
+        _version++;
+        portEXIT_CRITICAL(&_mux);
+    }
+
+    /// @brief Loads a snapshot of the value
+    /// @param value the snapshot
+    /// @return the version of the value, incremented on each store
+    uint32_t load(T &value) const
+    {
+        portENTER_CRITICAL(&_mux);
+        value = _value;
+        uint32_t version = _version;
+        portEXIT_CRITICAL(&_mux);
+        return version;
+    }
+
+    /// @brief Loads a snapshot of the value
+    T load() const
+    {
+        T value;
+        load(value);
+        return value;
+    }
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+
+#define TELEMETRY_FRAME_VERSION 1   // Version of the TelemetryFrame layout, incremented on each change of the layout
+#define TELEMETRY_RATE_MAX 20       // Maximum rate of the telemetry stream in frames per second (frames are produced with this rate)
+#define TELEMETRY_RATE_DEFAULT 2    // Rate of the telemetry stream in frames per second until the client selects a rate
+
+/// @brief Binary frame of the telemetry stream (/telemetry), little endian without padding.
+/// Layout: u32 time [ms], u16 sequence, u16 adcRaw, f32 input, f32 weather, f32 target, f32 output [°C, NaN if not available],
+/// u16 potiPosition, u8 powerLimit [%], u8 version
+struct __attribute__((packed)) TelemetryFrame
+{
+    /// @brief Time since boot in milliseconds
+    uint32_t time;
+
+    /// @brief Sequence number, incremented on each produced frame (gaps show frames that have been skipped or dropped)
+    uint16_t sequence;
+
+    /// @brief Average raw ADC reading of the last input thermistor sample frame
+    uint16_t adcRaw;
+
+    /// @brief Filtered input sensor temperature in °C
+    float input;
+
+    /// @brief Weather API temperature in °C
+    float weather;
+
+    /// @brief Target temperature of the output in °C
+    float target;
+
+    /// @brief Output temperature in °C
+    float output;
+
+    /// @brief Wiper position of the digital potentiometer
+    uint16_t potiPosition;
+
+    /// @brief Power limit in percent (<10 means inactive)
+    uint8_t powerLimit;
+
+    /// @brief Layout version (TELEMETRY_FRAME_VERSION)
+    uint8_t version;
+};
+
+static_assert(sizeof(TelemetryFrame) == 28, "The layout of the TelemetryFrame is part of the stream protocol");
+
+/// @brief Counters of the telemetry stream
+struct TelemetryStreamStats
+{
+    /// @brief Amount of connected stream clients
+    uint8_t clients = 0;
+
+    /// @brief Amount of sent frames
+    uint32_t sent = 0;
+
+    /// @brief Amount of frames that have been dropped because the queue of the client was full
+    uint32_t dropped = 0;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <ESPAsyncWebServer.h>
+#include <freertos/FreeRTOS.h>
+#include "TelemetryFrame.h"
+
+#define TELEMETRY_STREAM_CLIENT_CNT 4   // Maximum amount of stream clients, further connections are closed
+
+/// @brief Websocket endpoint that streams TelemetryFrames as binary messages, independent of the ESPUI websocket.
+/// Each client selects its rate by sending the frames per second as text message (e.g. "10", 1 to TELEMETRY_RATE_MAX).
+/// A frame is dropped for a client while its send queue is full, so a slow client never delays the others or the network task.
+class TelemetryStream
+{
+private:
+    struct Client
+    {
+        uint32_t id;
+        uint32_t period;
+        uint32_t next;
+    };
+
+    AsyncWebSocket _ws;
+    mutable portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    Client _clients[TELEMETRY_STREAM_CLIENT_CNT];
+    uint8_t _clientCnt = 0;
+    TelemetryStreamStats _stats;
+
+    void onEvent(AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len);
+    void setRate(uint32_t id, const uint8_t *data, size_t len);
+
+protected:
+public:
+    /// @brief Creates the websocket and adds it to the server
+    /// @param server the webserver (e.g. ESPUI.server)
+    /// @param url the path of the websocket
+    TelemetryStream(AsyncWebServer *server, const char *url);
+
+    TelemetryStream(const TelemetryStream &) = delete;
+    TelemetryStream &operator=(const TelemetryStream &) = delete;
+
+    /// @brief Gets if any client is connected
+    bool hasClients() const { return _clientCnt > 0; };
+
+    /// @brief Sends the frame to each client that is due according to its rate, needs to be called with TELEMETRY_RATE_MAX
+    /// @param frame the frame
+    void send(const TelemetryFrame &frame);
+
+    /// @brief Gets the counters of the stream
+    TelemetryStreamStats getStats() const;
+};
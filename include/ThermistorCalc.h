@@ -1,9 +1,208 @@
 #pragma once
 
+#include <stddef.h>
+
+#define THERMISTOR_TABLE_MIN_CELSIUS -40    // Lowest temperature covered by the lookup table in °C
+#define THERMISTOR_TABLE_MAX_CELSIUS 120    // Highest temperature covered by the lookup table in °C
+#define THERMISTOR_TABLE_STEP_CELSIUS 1     // Temperature distance between two lookup table entries in °C
+
+static const size_t THERMISTOR_TABLE_SIZE = (THERMISTOR_TABLE_MAX_CELSIUS - THERMISTOR_TABLE_MIN_CELSIUS) / THERMISTOR_TABLE_STEP_CELSIUS + 1; // Amount of lookup table entries
+
+/// @brief Coefficients of the Steinhart–Hart equation 1/T = a + b(Ln R) + c(Ln R)^3
+struct SteinhartHartCoefficients
+{
+    double a;
+    double b;
+    double c;
+};
+
+/// @brief Resistance [Ohm] for each lookup table temperature, descending since NTC
+struct ThermistorTable
+{
+    float resistance[THERMISTOR_TABLE_SIZE];
+};
+
+/// @brief Compile time implementation of the thermistor math, the standard library
+/// functions (log, exp, pow) are not constexpr and therefore replaced by series expansions
+namespace ThermistorMath
+{
+    constexpr double LN2 = 0.693147180559945309417;
+    constexpr double KELVIN_OFFSET = 273.15;
+
+    /// @brief Natural logarithm via range reduction to [1, 2) and the atanh series
+    constexpr double ln(double x)
+    {
+        int exponent = 0;
+        while (x >= 2)
+        {
+            x /= 2;
+            exponent++;
+        }
+        while (x < 1)
+        {
+            x *= 2;
+            exponent--;
+        }
+
+        double z = (x - 1) / (x + 1);
+        double term = z;
+        double sum = 0;
+        for (int n = 1; n < 60; n += 2)
+        {
+            sum += term / n;
+            term *= z * z;
+        }
+
+        return 2 * sum + exponent * LN2;
+    }
+
+    /// @brief Exponential function via range reduction by LN2 and the Taylor series
+    constexpr double exp(double x)
+    {
+        int exponent = (int)(x / LN2 + (x < 0 ? -0.5 : 0.5));
+        double r = x - exponent * LN2;
+        double term = 1;
+        double sum = 1;
+        for (int n = 1; n < 30; n++)
+        {
+            term *= r / n;
+            sum += term;
+        }
+
+        for (; exponent > 0; exponent--)
+            sum *= 2;
+        for (; exponent < 0; exponent++)
+            sum /= 2;
+        return sum;
+    }
+
+    /// @brief Square root via Newton iteration
+    constexpr double sqrt(double x)
+    {
+        if (x <= 0)
+            return 0;
+
+        double guess = x > 1 ? x : 1;
+        for (int i = 0; i < 100; i++)
+            guess = (guess + x / guess) / 2;
+        return guess;
+    }
+
+    /// @brief Cube root of a positive value
+    constexpr double cbrt(double x)
+    {
+        return x > 0 ? exp(ln(x) / 3) : 0;
+    }
+
+    /// @brief Calculates the Steinhart–Hart coefficients from three reference points (see ThermistorCalc constructor)
+    constexpr SteinhartHartCoefficients coefficients(int cLow, int rLow, int cMid, int rMid, int cHigh, int rHigh)
+    {
+        double lnR1 = ln(rLow);
+        double k1 = cLow + KELVIN_OFFSET;
+        double lnR2 = ln(rMid);
+        double k2 = cMid + KELVIN_OFFSET;
+        double lnR3 = ln(rHigh);
+        double k3 = cHigh + KELVIN_OFFSET;
+        double lnR1R2 = lnR1 - lnR2;
+        double lnR1R3 = lnR1 - lnR3;
+        double denominatorK1K2 = (1 / k1) - (1 / k2);
+        double denominatorK1K3 = (1 / k1) - (1 / k3);
+
+        double lnR1Pow3 = lnR1 * lnR1 * lnR1;
+        double lnR2Pow3 = lnR2 * lnR2 * lnR2;
+        double lnR3Pow3 = lnR3 * lnR3 * lnR3;
+
+        double c = (denominatorK1K2 - lnR1R2 * denominatorK1K3 / lnR1R3) / ((lnR1Pow3 - lnR2Pow3) - lnR1R2 * (lnR1Pow3 - lnR3Pow3) / lnR1R3);
+        double b = (denominatorK1K2 - c * (lnR1Pow3 - lnR2Pow3)) / lnR1R2;
+        double a = 1 / k1 - c * lnR1Pow3 - b * lnR1;
+        return {a, b, c};
+    }
+
+    /// @brief Calculates the exact resistance [Ohm] of the given temperature [celsius]
+    constexpr double resistanceFromCelsius(const SteinhartHartCoefficients &coefficients, double celsius)
+    {
+        double alpha = (coefficients.a - (1 / (celsius + KELVIN_OFFSET))) / coefficients.c;
+        double betaBase = coefficients.b / (3 * coefficients.c);
+        double beta = sqrt(betaBase * betaBase * betaBase + (alpha * alpha) / 4);
+        return exp(cbrt(beta - (alpha / 2)) - cbrt(beta + (alpha / 2)));
+    }
+
+    /// @brief Calculates the exact temperature [celsius] of the given resistance [Ohm]
+    constexpr double celsiusFromResistance(const SteinhartHartCoefficients &coefficients, double resistance)
+    {
+        double lnR = ln(resistance);
+        return 1 / (coefficients.a + coefficients.b * lnR + coefficients.c * lnR * lnR * lnR) - KELVIN_OFFSET;
+    }
+
+    /// @brief Builds the lookup table (see ThermistorCalc::enableLookupTable)
+    constexpr ThermistorTable table(const SteinhartHartCoefficients &coefficients)
+    {
+        ThermistorTable table = {};
+        for (size_t i = 0; i < THERMISTOR_TABLE_SIZE; i++)
+        {
+            table.resistance[i] = resistanceFromCelsius(coefficients, THERMISTOR_TABLE_MIN_CELSIUS + (int)i * THERMISTOR_TABLE_STEP_CELSIUS);
+        }
+
+        return table;
+    }
+
+    /// @brief Calculates the maximum deviation of the lookup table against the exact formula [celsius],
+    /// sampled at each quarter between the table points. Since the interpolation is linear in both
+    /// directions, a point on the interpolated segment covers the conversion in both directions.
+    constexpr float tableMaxError(const SteinhartHartCoefficients &coefficients, const ThermistorTable &table)
+    {
+        double maxError = 0;
+        for (size_t i = 0; i < THERMISTOR_TABLE_SIZE - 1; i++)
+        {
+            for (int fraction = 1; fraction < 4; fraction++)
+            {
+                double celsius = THERMISTOR_TABLE_MIN_CELSIUS + (i + fraction / 4.0) * THERMISTOR_TABLE_STEP_CELSIUS;
+                double resistance = table.resistance[i] + (table.resistance[i + 1] - table.resistance[i]) * fraction / 4.0;
+                double error = celsiusFromResistance(coefficients, resistance) - celsius;
+                error = error < 0 ? -error : error;
+                maxError = error > maxError ? error : maxError;
+            }
+        }
+
+        return maxError;
+    }
+}
+
+/**
+ * @brief Compile time thermistor profile based on three reference points (temperature in Celsius, resistance in Ohm).
+ * The Steinhart–Hart coefficients and the lookup table are calculated by the compiler and stored in flash,
+ * so a profile costs neither boot time nor RAM. Invalid reference points fail to compile.
+ */
+template <int CLow, int RLow, int CMid, int RMid, int CHigh, int RHigh>
+struct ThermistorProfile
+{
+    static_assert(CLow < CMid && CMid < CHigh, "Thermistor profile reference temperatures need to be ascending (low < mid < high)");
+    static_assert(RLow > RMid && RMid > RHigh && RHigh > 0, "Thermistor profile reference resistances need to be positive and descending (NTC)");
+
+    static constexpr bool isThermistorProfile = true;
+    static constexpr SteinhartHartCoefficients coefficients = ThermistorMath::coefficients(CLow, RLow, CMid, RMid, CHigh, RHigh);
+    static constexpr ThermistorTable table = ThermistorMath::table(coefficients);
+    static constexpr float tableMaxError = ThermistorMath::tableMaxError(coefficients, table);
+
+    static_assert(coefficients.c > 0 && coefficients.b > 0, "Thermistor profile reference points do not describe a valid Steinhart–Hart curve");
+};
+
+/// @brief Panasonic PAW-A2W-TSOD outdoor sensor (also expected by the Panasonic T-Cap)
+using PanasonicPawA2wTsod = ThermistorProfile<-40, 167820, 25, 6523, 120, 302>;
+
 /**
  * @brief Calculates the temperature or resistance of an thermistor
  * based on the Steinhart–Hart equation (T in degrees Kelvin):
  * 1/T = a + b(Ln R) + c(Ln R)^3
+ *
+ * Optionally a lookup table can be enabled, which is built once from the coefficients
+ * for the range THERMISTOR_TABLE_MIN_CELSIUS to THERMISTOR_TABLE_MAX_CELSIUS. Conversions
+ * inside that range are then done by binary search and linear interpolation in single precision
+ * instead of log/pow/exp in double precision (which is emulated in software on the ESP32).
+ * With a step of 1 °C the maximum deviation against the exact formula is below 0.01 °C
+ * for the Panasonic PAW-A2W-TSOD (worst case at -40 °C), the measured value is available
+ * via getLookupTableMaxError(). Values outside the table range fall back to the exact formula.
+ * Instances created from a ThermistorProfile use the table from flash and do no math at boot.
  */
 class ThermistorCalc
 {
@@ -11,6 +210,24 @@ private:
     double _coefficientA;
     double _coefficientB;
     double _coefficientC;
+    const float *_table = nullptr;  // Resistance [Ohm] for each table temperature (descending, since NTC)
+    bool _tableOwned = false;       // Table has been allocated by enableLookupTable() (otherwise it is a profile table in flash)
+    float _tableMaxError = 0;       // Maximum measured deviation of the table against the exact formula [celsius]
+
+    /// @brief Calculates the exact resistance [Ohm] of the given temperature [kelvin] via Steinhart–Hart
+    const double exactResistanceFromKelvin(double kelvin);
+
+    /// @brief Calculates the exact temperature [kelvin] of the given resistance [Ohm] via Steinhart–Hart
+    const double exactKelvinFromResistance(double resistance);
+
+    /// @brief Calculates the resistance [Ohm] of the given temperature [celsius] via lookup table
+    /// @attention The temperature needs to be inside the table range
+    const float tableResistanceFromCelsius(float celsius);
+
+    /// @brief Calculates the temperature [celsius] of the given resistance [Ohm] via lookup table
+    /// @attention The resistance needs to be inside the table range
+    const float tableCelsiusFromResistance(float resistance);
+
 protected:
 public:
     /// @brief Creates an instance of the calculator
@@ -22,6 +239,30 @@ public:
     /// @param rHigh High reference resistance on Ohm
     ThermistorCalc(int cLow, int rLow, int cMid, int rMid, int cHigh, int rHigh);
 
+    /// @brief Creates an instance of the calculator from a compile time profile with enabled lookup table
+    /// @tparam Profile The ThermistorProfile (e.g. PanasonicPawA2wTsod)
+    template <typename Profile>
+    constexpr ThermistorCalc(Profile) : _coefficientA(Profile::coefficients.a), _coefficientB(Profile::coefficients.b), _coefficientC(Profile::coefficients.c),
+                                        _table(Profile::table.resistance), _tableOwned(false), _tableMaxError(Profile::tableMaxError)
+    {
+        static_assert(Profile::isThermistorProfile, "ThermistorCalc requires a ThermistorProfile");
+    }
+
+    ThermistorCalc(const ThermistorCalc &) = delete;
+    ThermistorCalc &operator=(const ThermistorCalc &) = delete;
+    ~ThermistorCalc();
+
+    /// @brief Builds the lookup table once, all following conversions inside the
+    /// table range will use the table instead of the exact formula (nothing to do for profile instances)
+    void enableLookupTable();
+
+    /// @brief Gets if the lookup table is in use
+    bool isLookupTableEnabled() const { return _table != nullptr; };
+
+    /// @brief Gets the maximum deviation of the lookup table against the exact formula [celsius]
+    /// (measured while building the table, 0 if the table is not enabled)
+    float getLookupTableMaxError() const { return _tableMaxError; };
+
     /// @brief Calculates the resistance [Ohm] of the given temperature [kelvin]
     /// @param kelvin Temperature [kelvin]
     /// @return The calculated resistane [Ohm]
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include "AdcSampler.h"
+#include "AdcCorrection.h"
+#include "ThermistorCalc.h"
+#include "MedianFilter.h"
+
+#define THERMISTOR_INPUT_MIN_CHANGE 0.06f // Minimum change of the trimmed mean in °C to be applied as new temperature
+
+/**
+ * @brief Input thermistor behind a voltage divider (divider resistor to the supply, thermistor to ground).
+ *
+ * Each update reads the frame that the sampler has captured since the last update, averages it and adds the
+ * temperature to a sliding median window of N samples. Every N samples the trimmed mean of the window is applied
+ * as temperature if it has changed by more than THERMISTOR_INPUT_MIN_CHANGE. A shorted divider resistor (0V) or
+ * a disconnected sensor (supply voltage) clears the window and makes the temperature unavailable immediately.
+ * @tparam N amount of samples inside the sliding median window
+ * @tparam FrameSize maximum amount of raw samples per frame
+ */
+template <uint16_t N, size_t FrameSize>
+class ThermistorInput
+{
+private:
+    static_assert(FrameSize > 0, "ThermistorInput frame size out of range");
+
+    const AdcCorrection &_correction;
+    ThermistorCalc &_thermistor;
+    const float _dividerResistance;
+    const float _supplyVoltage;
+    const float _outlierDeviation;
+    AdcSampler *_sampler = nullptr;
+    uint16_t _frame[FrameSize];
+    uint16_t _raw = 0;
+    float _voltage = NAN;
+    float _temperature = NAN;
+    MedianFilter<N> _median;
+
+public:
+    /// @brief Creates the input
+    /// @param correction the correction of the ADC readings
+    /// @param thermistor the thermistor characteristic
+    /// @param dividerResistance the voltage divider resistor in Ohm
+    /// @param supplyVoltage the supply voltage of the voltage divider in V
+    /// @param outlierDeviation maximum deviation from the median in °C, samples above are rejected as outlier
+    ThermistorInput(const AdcCorrection &correction, ThermistorCalc &thermistor, float dividerResistance, float supplyVoltage, float outlierDeviation)
+        : _correction(correction), _thermistor(thermistor), _dividerResistance(dividerResistance), _supplyVoltage(supplyVoltage), _outlierDeviation(outlierDeviation) {}
+
+    ThermistorInput(const ThermistorInput &) = delete;
+    ThermistorInput &operator=(const ThermistorInput &) = delete;
+
+    /// @brief Starts reading from the sampler and applies the temperature of the first frame without the window
+    /// @param sampler the started sampler of the ADC input
+    /// @return the temperature or NAN if it is not available
+    float begin(AdcSampler *sampler)
+    {
+        _sampler = sampler;
+        float voltage = readAdcVoltageCorrected();
+        _temperature = isnanf(voltage) ? NAN : temperatureFromVoltage(voltage);
+        return _temperature;
+    }
+
+    /// @brief Reads the frame that has been captured since the last call and averages it with none linear compensation
+    /// @return the voltage or NAN if no samples are available
+    float readAdcVoltageCorrected()
+    {
+        size_t count = _sampler ? _sampler->read(_frame, FrameSize) : 0;
+        if (count < 1)
+        {
+            return NAN;
+        }
+
+        if (count == 1)
+        {
+            _raw = _frame[0];
+            _voltage = _correction.voltageFromReading(_frame[0]);
+            return _voltage;
+        }
+
+        uint32_t sum = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            sum += _frame[i];
+        }
+
+        _raw = sum / count;
+        _voltage = _correction.voltageFromReading((float)sum / count);
+        return _voltage;
+    }
+
+    /// @brief Calculates the thermistor temperature from the voltage of the voltage divider
+    /// @param voltage the corrected ADC voltage
+    /// @return the temperature or NAN if the divider resistor is shorted or no sensor is connected
+    float temperatureFromVoltage(float voltage)
+    {
+        if (!(voltage > 0) || !(voltage < _supplyVoltage))
+        {
+            return NAN;
+        }
+
+        float resistance = _dividerResistance * voltage / (_supplyVoltage - voltage);
+        return _thermistor.celsiusFromResistance(resistance);
+    }
+
+    /// @brief Adds the temperature of the next frame to the sliding median window,
+    /// every N samples the trimmed mean of the window gets applied
+    /// @return if the temperature has changed
+    bool update()
+    {
+        float voltage = readAdcVoltageCorrected();
+        if (isnanf(voltage))
+        {
+            // No new sample frame captured
+            return false;
+        }
+
+        float temperature = temperatureFromVoltage(voltage);
+        if (isnanf(temperature))
+        {
+            if (!isnanf(_temperature) || _median.getCount() > 0)
+            {
+                _median.clear();
+                _temperature = NAN;
+                return true;
+            }
+
+            return false;
+        }
+
+        _median.add(temperature);
+        if ((_median.getSampleCount() % N) == 0)
+        {
+            float mean = _median.getTrimmedMean(_outlierDeviation);
+            if (isnanf(_temperature) || fabsf(mean - _temperature) > THERMISTOR_INPUT_MIN_CHANGE)
+            {
+                _temperature = mean;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /// @brief Gets the last applied temperature (NAN if not available)
+    float getTemperature() const { return _temperature; };
+
+    /// @brief Gets the corrected voltage of the last frame (NAN if no frame has been read yet)
+    float getVoltage() const { return _voltage; };
+
+    /// @brief Gets the average raw reading of the last frame
+    uint16_t getAdcRaw() const { return _raw; };
+
+    /// @brief Gets the amount of samples that have been rejected as outlier by the last trimmed mean of the window
+    uint16_t getLastOutlierCount() const { return _median.getLastOutlierCount(); };
+
+    /// @brief Gets the total amount of samples that have been rejected as outlier
+    uint32_t getOutlierCount() const { return _median.getOutlierCount(); };
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Arduino.h>
+#include "WeatherSeries.h"
+
+/// @brief Keeps the last successful weather result (current weather and forecast) inside the RTC memory,
+/// which survives software resets, watchdog resets and OTA reboots (but not a power loss). At boot the cached
+/// result can be used immediately while the live refresh is running in the background.
+/// The data is protected by a magic number and a CRC, since the RTC memory is not initialized on power up.
+class WeatherCache
+{
+private:
+protected:
+public:
+    /// @brief Stores the weather series
+    /// @param series the current weather and forecast
+    /// @param timestamp the timestamp of the current weather (HH:MM:SS)
+    /// @param now current time epoch unix in seconds, UTC
+    static void store(const WeatherSeries &series, const String &timestamp, const time_t now);
+
+    /// @brief Gets the time when the cache has been stored, can be used as lower bound of the system time
+    /// if the time is not known after a reset (the reset itself is not included)
+    /// @return the time epoch unix in seconds, UTC or 0 if the cache is not valid
+    static time_t getSavedAt();
+
+    /// @brief Loads the weather series if the cache is valid and the current weather is not older than the maximum age
+    /// @param series the current weather and forecast
+    /// @param timestamp the timestamp of the current weather (HH:MM:SS)
+    /// @param now current time epoch unix in seconds, UTC
+    /// @param maxAge maximum age of the current weather in seconds
+    /// @return true if the cache has been loaded
+    static bool load(WeatherSeries &series, String &timestamp, const time_t now, const uint32_t maxAge);
+
+    /// @brief Invalidates the cache
+    static void clear();
+};
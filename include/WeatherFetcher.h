@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "OpenWeatherMap.h"
+
+#define WEATHER_FETCHER_STACK_SIZE 8192 // Stack size of the fetch task in bytes (TLS handshake + JSON parsing)
+#define WEATHER_FETCHER_PRIORITY 1      // Priority of the fetch task (same as the Arduino loop)
+#define WEATHER_FETCHER_CORE 0          // Core of the fetch task (WiFi core, the Arduino loop runs on core 1)
+
+/// @brief Result of a background weather request, plain data so it can be handed over between tasks without allocation
+struct WeatherResult
+{
+    /// @brief Gets if the request was successful
+    bool successful;
+
+    /// @brief Error
+    Error error;
+
+    /// @brief HTTP code RFC7231
+    int httpCode;
+
+    /// @brief Gets the termperature or NAN if request failed
+    float temperature;
+
+    /// @brief Gets the timestamp of the temperature (HH:MM:SS)
+    char timestamp[9];
+
+    /// @brief Time of the temperature, epoch unix in seconds, UTC (0 if request failed)
+    time_t time;
+
+    /// @brief Time of the server from the HTTP Date header, epoch unix in seconds, UTC (0 if unknown)
+    time_t serverTime;
+
+    /// @brief Gets if the forecast has been requested together with the current weather
+    bool forecastRequested;
+
+    /// @brief Forecast response (only valid if forecastRequested)
+    ForecastResponse forecast;
+
+    /// @brief Statistics of the request
+    ApiRequestStats stats;
+};
+
+/// @brief Runs the blocking OpenWeatherMap request inside a dedicated FreeRTOS task, so the main loop
+/// (sampling, output update, WiFi and webinterface) keeps running while the TLS handshake and the request are in progress.
+/// The result is handed over as single producer / single consumer slot: the task only writes the result while
+/// the ready flag is cleared and the main loop only reads it while it is set, so no lock is required.
+class WeatherFetcher
+{
+private:
+    OpenWeatherMap *_api;
+    TaskHandle_t _task = nullptr;
+    std::atomic<bool> _busy{false};
+    std::atomic<bool> _ready{false};
+    std::atomic<bool> _forecast{false};
+    WeatherResult _result;
+
+    static void taskLoop(void *parameter);
+
+protected:
+public:
+    /// @brief Creates the fetcher
+    /// @param api The API that is used for the requests
+    WeatherFetcher(OpenWeatherMap *api) : _api(api) {};
+
+    WeatherFetcher(const WeatherFetcher &) = delete;
+    WeatherFetcher &operator=(const WeatherFetcher &) = delete;
+
+    /// @brief Creates the fetch task
+    /// @return true if the task is running
+    bool begin();
+
+    /// @brief Starts a request in the background
+    /// @param includeForecast Request the forecast after the current weather within the same run
+    /// @return false if a request is still in progress or the last result has not been taken by poll()
+    bool trigger(bool includeForecast = false);
+
+    /// @brief Gets if a request is in progress or the result has not been taken yet
+    bool isBusy() const { return _busy.load(std::memory_order_acquire); };
+
+    /// @brief Takes the result of the last request if it is available, non-blocking
+    /// @param result The result of the request
+    /// @return true if a new result has been taken
+    bool poll(WeatherResult &result);
+
+    /// @brief Gets the API that is used for the requests
+    OpenWeatherMap *getApi() const { return _api; };
+
+    /// @brief Converts the response of a blocking request into a result
+    static WeatherResult toResult(const ApiResponse &response);
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+#define WEATHER_FORECAST_SIZE 8 // Amount of forecast points (3 hour steps, 24 hours)
+
+/// @brief Temperature at a point in time
+struct WeatherPoint
+{
+    /// @brief Time of the temperature, epoch unix in seconds, UTC
+    time_t time;
+
+    /// @brief Temperature in °C
+    float temperature;
+};
+
+/// @brief Time indexed temperature series of the current weather and the forecast, the temperature is
+/// linear interpolated between the points so that the weather temperature changes continuously instead of
+/// stepping on each API request
+class WeatherSeries
+{
+private:
+    WeatherPoint _current = {0, 0};
+    WeatherPoint _forecast[WEATHER_FORECAST_SIZE];
+    uint8_t _forecastCount = 0;
+
+protected:
+public:
+    /// @brief Sets the current weather (start of the series)
+    /// @param time Time of the temperature, epoch unix in seconds, UTC
+    /// @param temperature Temperature in °C
+    void setCurrent(const time_t time, const float temperature) { _current = {time, temperature}; };
+
+    /// @brief Sets the forecast points
+    /// @param points Forecast points in ascending time order
+    /// @param count Amount of points (limited to WEATHER_FORECAST_SIZE)
+    void setForecast(const WeatherPoint *points, uint8_t count);
+
+    /// @brief Gets the current weather (time 0 if unknown)
+    const WeatherPoint &getCurrent() const { return _current; };
+
+    /// @brief Gets the forecast points
+    const WeatherPoint *getForecast() const { return _forecast; };
+
+    /// @brief Gets the amount of forecast points
+    uint8_t getForecastCount() const { return _forecastCount; };
+
+    /// @brief Gets the time of the last forecast point or 0 if no forecast is available
+    time_t getForecastEnd() const { return _forecastCount > 0 ? _forecast[_forecastCount - 1].time : 0; };
+
+    /// @brief Gets the temperature at the given time, interpolated between the current weather and the forecast points.
+    /// Before the current weather the current temperature is used, after the last forecast point its temperature.
+    /// @param time Time epoch unix in seconds, UTC
+    /// @return The temperature or NAN if the current weather is unknown
+    float interpolate(const time_t time) const;
+};
@@ -1,6 +1,16 @@
 #pragma once
 
 #include "Config.h"
+#include "ApiRequestStats.h"
+#include "RetryScheduler.h"
+#include "PeriodicTask.h"
+#include "Scheduler.h"
+#include "SharedState.h"
+#include "TelemetryFrame.h"
+#include "HistoryStore.h"
+#include "HistoryLog.h"
+
+class TelemetryStream;
 
 #define STYLE_HIDDEN "background-color: unset; width: 0px; height: 0px; display: none;"
 #define STYLE_NUM_TEMP_ADJUST_NORMAL "width: 16%; color: black; background: rgba(255,255,255,0.8);"
@@ -17,6 +27,18 @@
 #define STYLE_LBL_INOUT_MANUAL_ENABLE "background-color: unset; text-align: left; width: 70%; vertical-align: bottom;" 
 
 
+#define SYSTEM_INFO_JOB_CNT 10            // Maximum amount of scheduler jobs shown inside the System-Tab
+#define SYSTEM_INFO_BUFFER_SIZE 2048      // Size of the stack buffer a label of the System-Tab is formatted into
+#define SYSTEM_INFO_STATS_CYCLE 10        // Update cycle of the statistic labels (tasks, probes, log, traffic) in update() calls
+#define SYSTEM_INFO_HEAP_THRESHOLD 1024   // Minimum change of the heap values in bytes that is sent to the System-Tab
+#define SYSTEM_INFO_TEMP_THRESHOLD 0.5f   // Minimum change of the chip temperature in °C that is sent to the System-Tab
+#define SYSTEM_INFO_RSSI_THRESHOLD 3      // Minimum change of the RSSI in dB that is sent to the System-Tab
+#define WEBINTERFACE_LABEL_CNT 8          // Maximum amount of labels with coalesced updates (sensor, weather, output, target, power)
+#define WEBINTERFACE_LABEL_SIZE 64        // Maximum length of a coalesced label text
+#define WEBINTERFACE_FRAME_BUDGET 512     // Maximum amount of bytes that are sent to each client per UI frame
+#define WEBINTERFACE_MESSAGE_OVERHEAD 48  // Estimated size of an ESPUI update message without the label text
+#define WEBINTERFACE_TELEMETRY_SIZE 640   // Size of the stack buffer the telemetry JSON (/api/telemetry) is formatted into
+
 /// @brief Holds a available WiFi option
 struct WiFiOption 
 {
@@ -25,6 +47,84 @@ struct WiFiOption
     uint16_t Control = 0;
 };
 
+/// @brief Label text that is sent with the next UI frame
+struct PendingLabel
+{
+    /// @brief Id of the label control
+    uint16_t control = 0;
+
+    /// @brief Gets if the text has changed since the last frame
+    bool dirty = false;
+
+    /// @brief Latest text of the label
+    char text[WEBINTERFACE_LABEL_SIZE] = "";
+};
+
+/// @brief Counters of the coalesced label updates
+struct WebinterfaceFrameStats
+{
+    /// @brief Amount of UI frames that have sent at least one label
+    uint32_t frames = 0;
+
+    /// @brief Amount of sent label updates
+    uint32_t updates = 0;
+
+    /// @brief Amount of label texts that have been replaced by a newer text before they have been sent
+    uint32_t coalesced = 0;
+
+    /// @brief Estimated amount of bytes that have been sent to each client
+    uint32_t bytes = 0;
+
+    /// @brief Amount of UI frames that have been skipped because the websocket queue of a client was full
+    uint32_t deferred = 0;
+
+    /// @brief Amount of UI frames that have postponed labels to the next frame because the budget was used
+    uint32_t overBudget = 0;
+};
+
+/// @brief Values that are served by the telemetry API (/api/telemetry), written by the network task and read by the webserver
+struct WebinterfaceTelemetry
+{
+    /// @brief Temperature of the input sensor in °C (NAN if not available)
+    float sensorTemperature = NAN;
+
+    /// @brief Total amount of input sensor samples rejected as outlier
+    uint32_t sensorOutliersTotal = 0;
+
+    /// @brief Weather API temperature in °C (NAN if not available)
+    float weatherTemperature = NAN;
+
+    /// @brief Timestamp of the weather API temperature (HH:MM:SS, empty if unknown)
+    char weatherTimestamp[9] = "";
+
+    /// @brief Target temperature of the output in °C (NAN if not available)
+    float targetTemperature = NAN;
+
+    /// @brief Output temperature in °C (NAN if not available)
+    float outputTemperature = NAN;
+
+    /// @brief Wiper position of the digital potentiometer
+    uint16_t potiPosition = 0;
+
+    /// @brief Power limit in percent (<10 means inactive, NAN if not available)
+    float powerLimit = NAN;
+
+    /// @brief Amount of weather API request attempts
+    uint32_t weatherApiAttempts = 0;
+
+    /// @brief Amount of failed weather API requests
+    uint32_t weatherApiFailures = 0;
+
+    /// @brief Amount of failed weather API requests since the last success
+    uint8_t weatherApiConsecutiveFailures = 0;
+
+    /// @brief Amount of control task cycles that took longer than the period
+    uint32_t controlOverruns = 0;
+
+    /// @brief Amount of network task cycles that took longer than the period
+    uint32_t networkOverruns = 0;
+};
+
 /// @brief Implements a system information tab inside the Webinterface
 class SystemInfoTab
 {
@@ -37,6 +137,49 @@ private:
     uint16_t _btnReboot;
     uint16_t _lblPerformance;
     uint16_t _lblInfoTest;
+    uint16_t _lblWeatherApi;
+    uint16_t _lblBoot;
+    uint16_t _lblControl;
+    uint16_t _lblProbes;
+#if DEFERRED_LOG_ENABLED
+    uint16_t _lblLog;
+#endif
+    uint32_t _weatherApiRequests = 0;
+    uint32_t _weatherApiReused = 0;
+    uint32_t _weatherApiHeapPeakMax = 0;
+    ApiRequestStats _weatherApiStats;
+    RetrySchedulerStats _weatherApiSchedule;
+    PeriodicTaskStats _controlStats;
+    PeriodicTaskStats _networkStats;
+    SchedulerJobStats _jobs[SYSTEM_INFO_JOB_CNT];
+    uint8_t _jobCount = 0;
+    WebinterfaceFrameStats _frameStats;
+    TelemetryStreamStats _streamStats;
+    HistoryLogStats _historyLogStats;
+    ConfigStoreStats _configStoreStats;
+    bool _weatherApiDirty = true;
+    uint32_t _updateCount = 0;
+    uint32_t _pushBytes = 0;
+    uint32_t _pushCount = 0;
+    uint32_t _pushBytesRate = 0;
+    uint32_t _pushCountRate = 0;
+    uint32_t _shownUptime = UINT32_MAX;
+    uint32_t _shownHeapUsed = 0;
+    uint32_t _shownHeapMaxAlloc = 0;
+    float _shownTemperature = NAN;
+    uint32_t _shownPushBytesRate = UINT32_MAX;
+    uint32_t _shownNetworkHash = 0;
+    int8_t _shownRssi = 0;
+    uint8_t _shownBootStages = UINT8_MAX;
+    uint32_t _hashPerformance = 0;
+    uint32_t _hashNetwork = 0;
+    uint32_t _hashWeatherApi = 0;
+    uint32_t _hashBoot = 0;
+    uint32_t _hashControl = 0;
+    uint32_t _hashProbes = 0;
+#if DEFERRED_LOG_ENABLED
+    uint32_t _hashLog = 0;
+#endif
     uint16_t _selSsid;
     uint16_t _txtSsid;
     uint16_t _txtPassword;
@@ -46,6 +189,16 @@ private:
 
     void updateBtnSaveState();
     void wifiScanCompleted(int16_t networkCnt);
+    void pushLabel(uint16_t control, const char *text, uint32_t &hash);
+    void updatePerformance(char *buffer, size_t size);
+    void updateNetworkInfo(char *buffer, size_t size);
+    void updateWeatherApi(char *buffer, size_t size);
+    void updateBoot(char *buffer, size_t size);
+    void updateTasks(char *buffer, size_t size);
+    void updateProbes(char *buffer, size_t size);
+#if DEFERRED_LOG_ENABLED
+    void updateLog(char *buffer, size_t size);
+#endif
 
 protected:
 public:
@@ -53,7 +206,42 @@ public:
     SystemInfoTab();
 
     /// @brief Update the system information. NOTE: this function is called cyclically if a client is connected!
+    /// Only the labels with values that have changed beyond their threshold are formatted and sent,
+    /// the statistic labels are only refreshed every SYSTEM_INFO_STATS_CYCLE calls.
     void update();
+
+    /// @brief Sets the statistics of the last weather API request
+    /// @param stats the statistics of the request
+    /// @param schedule the counters of the request schedule
+    void setWeatherApiStats(const ApiRequestStats &stats, const RetrySchedulerStats &schedule);
+
+    /// @brief Sets the timing statistics of the control and network tasks
+    /// @param control the statistics of the control task
+    /// @param network the statistics of the network task
+    void setTaskStats(const PeriodicTaskStats &control, const PeriodicTaskStats &network);
+
+    /// @brief Sets the statistics of the scheduler jobs of the control and network tasks
+    /// @param control the statistics of the control jobs
+    /// @param controlCount the amount of control jobs
+    /// @param network the statistics of the network jobs
+    /// @param networkCount the amount of network jobs
+    void setJobStats(const SchedulerJobStats *control, uint8_t controlCount, const SchedulerJobStats *network, uint8_t networkCount);
+
+    /// @brief Updates the counters of the coalesced label updates
+    /// @param stats the counters
+    void setFrameStats(const WebinterfaceFrameStats &stats) { _frameStats = stats; };
+
+    /// @brief Updates the counters of the binary telemetry stream
+    /// @param stats the counters
+    void setStreamStats(const TelemetryStreamStats &stats) { _streamStats = stats; };
+
+    /// @brief Updates the write counters of the history log
+    /// @param stats the counters
+    void setHistoryLogStats(const HistoryLogStats &stats) { _historyLogStats = stats; };
+
+    /// @brief Updates the write counters of the configuration
+    /// @param stats the counters
+    void setConfigStoreStats(const ConfigStoreStats &stats) { _configStoreStats = stats; };
 };
 
 /// @brief Web UI temperature element that represents a power limit area
@@ -100,6 +288,7 @@ class Webinterface
 private:
     Config *_config;
     uint16_t _lblSensorTemp;
+    uint16_t _lblSensorTempInfo;
     uint16_t _lblWeatherTemp;
     uint16_t _swManualTempInput;
     uint16_t _swManualTempOutput;
@@ -108,10 +297,24 @@ private:
     uint16_t _numManualTempOutput;
     uint16_t _numManualPowerOutput;
     uint16_t _lblTempOutput;
+    uint16_t _lblTempOutputInfo;
     uint16_t _lblTempTarget;
     uint16_t _lblPowerOutput;
     AdjustmentTab *_adjustmentTab;
     SystemInfoTab *_systemInfoTab;
+    TelemetryStream *_telemetryStream;
+    const HistoryStore *_history = nullptr;
+    const HistoryLog *_historyLog = nullptr;
+    PendingLabel _pendingLabels[WEBINTERFACE_LABEL_CNT];
+    uint8_t _pendingLabelCnt = 0;
+    uint8_t _pendingLabelNext = 0;
+    WebinterfaceFrameStats _frameStats;
+    WebinterfaceTelemetry _telemetryValues;
+    SharedState<WebinterfaceTelemetry> _telemetry;
+    bool _telemetryDirty = true;
+
+    void setLabel(uint16_t control, const char *format, ...);
+    size_t formatTelemetry(char *buffer, size_t size) const;
 
 protected:
 public:
@@ -126,19 +329,65 @@ public:
     bool getClientIsConnected();
 
     /// @brief Update the System and WiFi information inside the Webinterface-Tab if a client is connected
-    void updateSystemInformation() { if(getClientIsConnected()) _systemInfoTab->update(); };
+    /// and the websocket queues are not full
+    void updateSystemInformation();
+
+    /// @brief Sends the label texts that have changed since the last UI frame and publishes the telemetry values, needs to be called once per frame.
+    /// The setters below only store the latest text, so a value that changes several times within a frame is sent once.
+    /// Each frame sends at most WEBINTERFACE_FRAME_BUDGET bytes to each client (remaining labels are sent with the next frame)
+    /// and the whole frame is skipped while the AsyncTCP queue of a client is full.
+    void flush();
+
+    /// @brief Gets the counters of the coalesced label updates
+    const WebinterfaceFrameStats &getFrameStats() const { return _frameStats; };
+
+    /// @brief Sets the history that is served by /api/history
+    /// @param history the history
+    void setHistory(const HistoryStore *history) { _history = history; };
+
+    /// @brief Sets the history log that is served by /api/history-log
+    /// @param historyLog the history log
+    void setHistoryLog(const HistoryLog *historyLog) { _historyLog = historyLog; };
+
+    /// @brief Gets if any client is connected to the binary telemetry stream (/telemetry)
+    bool hasTelemetryClients() const;
+
+    /// @brief Sends a frame to the clients of the binary telemetry stream that are due, needs to be called with TELEMETRY_RATE_MAX
+    /// @param frame the live values
+    void streamTelemetry(const TelemetryFrame &frame);
 
     /// @brief Updates the sensor temperature inside webinterface
     /// @param temperature the new temperature
-    void setSensorTemp(const float temperature);
+    /// @param outliers the amount of samples rejected as outlier by the last update
+    /// @param outliersTotal the total amount of samples rejected as outlier
+    void setSensorTemp(const float temperature, const uint16_t outliers, const uint32_t outliersTotal);
 
     /// @brief Updates the weather API temperature inside webinterface
     /// @param temperature the new temperature
     void setWeatherTemp(const float temperature, const String timestamp);
 
+    /// @brief Updates the statistics of the last weather API request inside the System-Tab
+    /// @param stats the statistics of the request
+    /// @param schedule the counters of the request schedule
+    void setWeatherApiStats(const ApiRequestStats &stats, const RetrySchedulerStats &schedule);
+
+    /// @brief Updates the timing statistics of the control and network tasks inside the System-Tab
+    /// @param control the statistics of the control task
+    /// @param network the statistics of the network task
+    void setTaskStats(const PeriodicTaskStats &control, const PeriodicTaskStats &network);
+
+    /// @brief Updates the statistics of the scheduler jobs of the control and network tasks inside the System-Tab
+    /// @param control the statistics of the control jobs
+    /// @param controlCount the amount of control jobs
+    /// @param network the statistics of the network jobs
+    /// @param networkCount the amount of network jobs
+    void setJobStats(const SchedulerJobStats *control, uint8_t controlCount, const SchedulerJobStats *network, uint8_t networkCount) { _systemInfoTab->setJobStats(control, controlCount, network, networkCount); };
+
     /// @brief Updates the output temperature inside webinterface
     /// @param temperature the new output temperature
-    void setOutputTemp(const float temperature);
+    /// @param potiPosition the wiper position of the digital potentiometer
+    /// @param quantizationError the deviation of the output temperature from the target temperature caused by the potentiometer steps
+    void setOutputTemp(const float temperature, const uint16_t potiPosition, const float quantizationError);
 
     /// @brief Updates the target temperature inside webinterface
     /// @param temperature the new target temperature
@@ -0,0 +1,66 @@
+#include "AdcCorrection.h"
+
+static const char *AdcCalibrationSourceNames[] = {
+    "Polynomial",
+    "eFuse Vref",
+    "eFuse Two Point",
+};
+
+AdcCalibrationSource AdcCorrection::begin(bool useEfuseCalibration)
+{
+    _source = AdcCalibrationSource::Polynomial;
+    if (!useEfuseCalibration)
+    {
+        return _source;
+    }
+
+    if (esp_adc_cal_check_efuse(ESP_ADC_CAL_VAL_EFUSE_TP) == ESP_OK)
+    {
+        esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, 1100, &_characteristics);
+        _source = AdcCalibrationSource::EfuseTwoPoint;
+    }
+    else if (esp_adc_cal_check_efuse(ESP_ADC_CAL_VAL_EFUSE_VREF) == ESP_OK)
+    {
+        esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, 1100, &_characteristics);
+        _source = AdcCalibrationSource::EfuseVref;
+    }
+
+    return _source;
+}
+
+const char *AdcCorrection::getSourceName() const
+{
+    return AdcCalibrationSourceNames[static_cast<int>(_source)];
+}
+
+float AdcCorrection::voltageFromReading(uint16_t reading) const
+{
+    if (reading >= ADC_MAX_READING)
+    {
+        return ADC_MAX_VOLTAGE;
+    }
+
+    if (_source == AdcCalibrationSource::Polynomial || reading < 1)
+    {
+        return _table.voltage[reading] / (float)ADC_TABLE_VOLTAGE_SCALE;
+    }
+
+    return esp_adc_cal_raw_to_voltage(reading, &_characteristics) / 1000.0f;
+}
+
+float AdcCorrection::voltageFromReading(float reading) const
+{
+    if (!(reading > 0))
+    {
+        return voltageFromReading((uint16_t)0);
+    }
+
+    if (reading >= ADC_MAX_READING)
+    {
+        return voltageFromReading((uint16_t)ADC_MAX_READING);
+    }
+
+    uint16_t lower = (uint16_t)reading;
+    float lowerVoltage = voltageFromReading(lower);
+    return lowerVoltage + (voltageFromReading((uint16_t)(lower + 1)) - lowerVoltage) * (reading - lower);
+}
@@ -0,0 +1,124 @@
+#define LOG_LEVEL NONE
+
+#include <Arduino.h>
+#include <driver/adc.h>
+#include "AdcSampler.h"
+#include "SerialLogging.h"
+
+/*
+##############################################
+##            AdcPollingSampler             ##
+##############################################
+*/
+
+bool AdcPollingSampler::begin()
+{
+    return true;
+}
+
+size_t AdcPollingSampler::read(uint16_t *samples, size_t maxSamples)
+{
+    if (maxSamples < 1)
+    {
+        return 0;
+    }
+
+    samples[0] = analogRead(_gpioPin);
+    return 1;
+}
+
+/*
+##############################################
+##           AdcContinuousSampler           ##
+##############################################
+*/
+
+AdcContinuousSampler::~AdcContinuousSampler()
+{
+    if (_running)
+    {
+        adc_digi_stop();
+        adc_digi_deinitialize();
+    }
+}
+
+bool AdcContinuousSampler::begin()
+{
+    if (_running)
+    {
+        return true;
+    }
+
+    int8_t channel = digitalPinToAnalogChannel(_gpioPin);
+    if (channel < 0 || channel >= ADC1_CHANNEL_MAX)
+    {
+#ifdef LOG_ERROR
+        LOG_ERROR(F("AdcContinuousSampler"), F("begin"), F("GPIO is not an ADC1 channel {}"), _gpioPin);
+#endif
+        return false;
+    }
+
+    adc_digi_init_config_t initConfig = {};
+    initConfig.max_store_buf_size = ADC_CONTINUOUS_BUFFER_SIZE;
+    initConfig.conv_num_each_intr = ADC_CONTINUOUS_CHUNK_SIZE;
+    initConfig.adc1_chan_mask = BIT(channel);
+    initConfig.adc2_chan_mask = 0;
+    if (adc_digi_initialize(&initConfig) != ESP_OK)
+    {
+#ifdef LOG_ERROR
+        LOG_ERROR(F("AdcContinuousSampler"), F("begin"), F("Failed to initialize continuous ADC mode"));
+#endif
+        return false;
+    }
+
+    adc_digi_pattern_config_t pattern = {};
+    pattern.atten = ADC_ATTEN_DB_11;
+    pattern.channel = channel;
+    pattern.unit = 0; // ADC1
+    pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = true;
+    config.conv_limit_num = 250;
+    config.pattern_num = 1;
+    config.adc_pattern = &pattern;
+    config.sample_freq_hz = ADC_CONTINUOUS_SAMPLE_FREQUENCY;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+    if (adc_digi_controller_configure(&config) != ESP_OK || adc_digi_start() != ESP_OK)
+    {
+#ifdef LOG_ERROR
+        LOG_ERROR(F("AdcContinuousSampler"), F("begin"), F("Failed to start continuous ADC mode"));
+#endif
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    _running = true;
+    return true;
+}
+
+size_t AdcContinuousSampler::read(uint16_t *samples, size_t maxSamples)
+{
+    if (!_running || maxSamples < 1)
+    {
+        return 0;
+    }
+
+    // Drain everything that has been captured, the buffer is used as ring to keep the most recent samples
+    size_t count = 0;
+    size_t next = 0;
+    uint32_t length = 0;
+    while (adc_digi_read_bytes(_chunk, sizeof(_chunk), &length, 0) == ESP_OK && length > 0)
+    {
+        for (uint32_t i = 0; i + sizeof(adc_digi_output_data_t) <= length; i += sizeof(adc_digi_output_data_t))
+        {
+            auto data = reinterpret_cast<adc_digi_output_data_t *>(&_chunk[i]);
+            samples[next] = data->type1.data;
+            next = (next + 1) % maxSamples;
+            count = min(count + 1, maxSamples);
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,83 @@
+#define LOG_LEVEL NONE
+
+#include <Arduino.h>
+#include "BootSequence.h"
+#include "SerialLogging.h"
+
+static const char *BootStageNames[] = {
+    "Reset",
+    "Config",
+    "Weather Cache",
+    "Input Sensor",
+    "Output Control",
+    "Power Limit",
+    "Network",
+    "Webinterface",
+    "Weather API",
+    "Completed",
+    "First Output",
+    "Network Connected",
+    "First Weather",
+};
+
+static_assert(sizeof(BootStageNames) / sizeof(BootStageNames[0]) == BOOT_STAGE_COUNT, "Missing boot stage name");
+
+BootSequenceClass::BootSequenceClass()
+{
+    for (uint8_t i = 0; i < BOOT_STAGE_COUNT; i++)
+    {
+        _times[i] = -1;
+    }
+
+    _times[static_cast<uint8_t>(BootStage::RESET)] = 0;
+}
+
+void BootSequenceClass::complete(BootStage stage)
+{
+    portENTER_CRITICAL(&_mux);
+    _stage = stage;
+    portEXIT_CRITICAL(&_mux);
+    mark(stage);
+}
+
+void BootSequenceClass::mark(BootStage stage)
+{
+    int64_t time = esp_timer_get_time();
+    portENTER_CRITICAL(&_mux);
+    bool marked = _times[static_cast<uint8_t>(stage)] >= 0;
+    if (!marked)
+    {
+        _times[static_cast<uint8_t>(stage)] = time;
+    }
+    portEXIT_CRITICAL(&_mux);
+
+#ifdef LOG_INFO
+    if (!marked)
+    {
+        LOG_INFO(F("BootSequence"), F("mark"), F("{} after {} ms"), getStageName(stage), (long)(time / 1000));
+    }
+#endif
+}
+
+int64_t BootSequenceClass::getTime(BootStage stage) const
+{
+    portENTER_CRITICAL(&_mux);
+    int64_t time = _times[static_cast<uint8_t>(stage)];
+    portEXIT_CRITICAL(&_mux);
+    return time;
+}
+
+BootStage BootSequenceClass::getStage() const
+{
+    portENTER_CRITICAL(&_mux);
+    BootStage stage = _stage;
+    portEXIT_CRITICAL(&_mux);
+    return stage;
+}
+
+const char *BootSequenceClass::getStageName(BootStage stage)
+{
+    return BootStageNames[static_cast<uint8_t>(stage)];
+}
+
+BootSequenceClass BootSequence;
@@ -9,33 +9,82 @@
 ##############################################
 */
 
-Config::Config() : _preferences(new Preferences())
+Config::Config() : store(new ConfigStore(KEY_CONFIG_NAMESPACE, KEY_CONFIG_BLOB, CONFIG_DATA_VERSION, &_data, sizeof(_data)))
 {
-    _preferences->begin(KEY_SETTINGS_NAMESPACE, false);
-    //_preferences->clear();
+    uint32_t start = micros();
+    auto version = store->load();
+    if (version == 0)
+    {
+        migrate();
+    }
+    else if (version != CONFIG_DATA_VERSION)
+    {
+        // Store the blob with the current layout
+        store->commit(true);
+    }
 
-    temperatureConfig = new TemperatureConfig(_preferences);
-    powerConfig = new PowerConfig(_preferences);
+    temperatureConfig = new TemperatureConfig(store, &_data);
+    powerConfig = new PowerConfig(store, &_data);
+    store->setLoadTime(micros() - start);
+#ifdef LOG_INFO
+    LOG_INFO(F("Config"), F("Config"), F("Loaded version {} in {} us"), version, micros() - start);
+#endif
 };
 
+void Config::migrate()
+{
+    // Values of the former per-key layout, or the defaults on the first boot
+    Preferences preferences;
+    preferences.begin(KEY_SETTINGS_NAMESPACE, false);
+    _data.manualOutputActive = preferences.getBool(KEY_SETTING_TEMP_MANUAL_OUT_MODE, _data.manualOutputActive);
+    _data.manualOutputTemperature = preferences.getShort(KEY_SETTING_TEMP_MANUAL_OUT_TEMP, _data.manualOutputTemperature);
+    _data.manualInputActive = preferences.getBool(KEY_SETTING_TEMP_MANUAL_IN_MODE, _data.manualInputActive);
+    _data.manualInputTemperature = preferences.getShort(KEY_SETTING_TEMP_MANUAL_IN_TEMP, _data.manualInputTemperature);
+    for (size_t i = 0; i < TEMP_ADJUST_AMOUNT; i++)
+    {
+        auto keyOffset = String(KEY_SETTING_TEMP_ADJUST_TEMP_OFFSET) + (int8_t)(ADJUST_TEMP_START - i);
+        _data.tempOffset[i] = preferences.getChar(keyOffset.c_str(), _data.tempOffset[i]);
+    }
+
+    _data.manualPowerActive = preferences.getBool(KEY_SETTING_POWER_MANUAL_MODE, _data.manualPowerActive);
+    _data.manualPower = preferences.getUChar(KEY_SETTING_POWER_MANUAL_POWER, _data.manualPower);
+    for (size_t i = 0; i < POWER_AREA_AMOUNT; i++)
+    {
+        auto &area = _data.powerAreas[i];
+        area.start = preferences.getShort((String(KEY_SETTING_POWER_AREA_START) + i).c_str(), area.start);
+        area.end = preferences.getShort((String(KEY_SETTING_POWER_AREA_END) + i).c_str(), area.end);
+        area.powerLimit = preferences.getUChar((String(KEY_SETTING_POWER_AREA_LIMIT) + i).c_str(), area.powerLimit);
+    }
+
+    // The per-key values are removed after the blob has been written, so a power loss in between doesn't lose them
+    if (store->commit(true))
+    {
+        preferences.clear();
+    }
+    preferences.end();
+#ifdef LOG_INFO
+    LOG_INFO(F("Config"), F("migrate"), F("Per-key configuration migrated into the blob"));
+#endif
+}
+
 /*
 ##############################################
 ##            TemperatureConfig             ##
 ##############################################
 */
 
-TemperatureConfig::TemperatureConfig(Preferences *preferences) : _preferences(preferences)
+TemperatureConfig::TemperatureConfig(ConfigStore *store, ConfigData *data) : _store(store), _data(data)
 {
     // Check limit and round to 0.1
-    _manualOutputActive = preferences->getBool(KEY_SETTING_TEMP_MANUAL_OUT_MODE, false);
-    _manualOutputTemperature = preferences->getShort(KEY_SETTING_TEMP_MANUAL_OUT_TEMP, 150) / 10.0f;
+    _manualOutputActive = data->manualOutputActive;
+    _manualOutputTemperature = data->manualOutputTemperature / 10.0f;
 
-    _manualInputActive = preferences->getBool(KEY_SETTING_TEMP_MANUAL_IN_MODE, false);
-    _manualInputTemperature = preferences->getShort(KEY_SETTING_TEMP_MANUAL_IN_TEMP, 100) / 10.0f;
+    _manualInputActive = data->manualInputActive;
+    _manualInputTemperature = data->manualInputTemperature / 10.0f;
 
     for (size_t i = 0; i < TEMP_ADJUST_AMOUNT; i++)
     {
-        _adjustments[i] = new TemperatureAdjustment(ADJUST_TEMP_START - i, preferences);
+        _adjustments[i] = new TemperatureAdjustment(ADJUST_TEMP_START - i, store, &data->tempOffset[i]);
     }
 };
 
@@ -47,7 +96,7 @@ bool TemperatureConfig::setManualOutputActive(bool manualMode)
     }
 
     _manualOutputActive = manualMode;
-    _preferences->putBool(KEY_SETTING_TEMP_MANUAL_OUT_MODE, _manualOutputActive);
+    _store->set(_data->manualOutputActive, _manualOutputActive);
     return _manualOutputActive;
 }
 
@@ -59,7 +108,7 @@ bool TemperatureConfig::setManualInputActive(bool manualMode)
     }
 
     _manualInputActive = manualMode;
-    _preferences->putBool(KEY_SETTING_TEMP_MANUAL_IN_MODE, _manualInputActive);
+    _store->set(_data->manualInputActive, _manualInputActive);
     return _manualInputActive;
 }
 
@@ -75,7 +124,7 @@ float TemperatureConfig::setManualOutputTemperature(float manualTemperature)
     }
 
     _manualOutputTemperature = manualTemperature;
-    _preferences->putShort(KEY_SETTING_TEMP_MANUAL_OUT_TEMP, (int16_t)(_manualOutputTemperature * 10));
+    _store->set(_data->manualOutputTemperature, (int16_t)roundf(_manualOutputTemperature * 10));
     return _manualOutputTemperature;
 }
 
@@ -91,7 +140,7 @@ float TemperatureConfig::setManualInputTemperature(float manualTemperature)
     }
 
     _manualInputTemperature = manualTemperature;
-    _preferences->putShort(KEY_SETTING_TEMP_MANUAL_IN_TEMP, (int16_t)(_manualInputTemperature * 10));
+    _store->set(_data->manualInputTemperature, (int16_t)roundf(_manualInputTemperature * 10));
     return _manualInputTemperature;
 }
 
@@ -164,10 +213,9 @@ TemperatureAdjustment *TemperatureConfig::getTempAdjustment(int8_t tempReal)
 ##############################################
 */
 
-TemperatureAdjustment::TemperatureAdjustment(int8_t tempReal, Preferences *preferences) : _preferences(preferences), tempReal(tempReal)
+TemperatureAdjustment::TemperatureAdjustment(int8_t tempReal, ConfigStore *store, int8_t *storedOffset) : _store(store), _storedOffset(storedOffset), tempReal(tempReal)
 {
-    auto keyOffset = String(KEY_SETTING_TEMP_ADJUST_TEMP_OFFSET) + tempReal;
-    _tempOffset =  preferences->getChar(keyOffset.c_str(), 0) / 10.0f;
+    _tempOffset = *storedOffset / 10.0f;
 }
 
 float TemperatureAdjustment::setTemperatureOffset(float offset)
@@ -182,8 +230,7 @@ float TemperatureAdjustment::setTemperatureOffset(float offset)
     }
 
     _tempOffset = offset;
-    auto keyOffset = String(KEY_SETTING_TEMP_ADJUST_TEMP_OFFSET) + tempReal;
-    _preferences->putChar(keyOffset.c_str(), (int8_t)(_tempOffset * 10));
+    _store->set(*_storedOffset, (int8_t)roundf(_tempOffset * 10));
     return _tempOffset;
 }
 
@@ -193,14 +240,14 @@ float TemperatureAdjustment::setTemperatureOffset(float offset)
 ##############################################
 */
 
-PowerConfig::PowerConfig(Preferences *preferences) : _preferences(preferences)
+PowerConfig::PowerConfig(ConfigStore *store, ConfigData *data) : _store(store), _data(data)
 {
-    _manualOutputActive = preferences->getBool(KEY_SETTING_POWER_MANUAL_MODE, false);
-    _manualPower = preferences->getUChar(KEY_SETTING_POWER_MANUAL_POWER, 100);
+    _manualOutputActive = data->manualPowerActive;
+    _manualPower = data->manualPower;
 
     for (size_t i = 0; i < POWER_AREA_AMOUNT; i++)
     {
-        _areas[i] = new PowerArea(i, this, preferences);
+        _areas[i] = new PowerArea(i, this, store, &data->powerAreas[i]);
     }
 };
 
@@ -212,7 +259,7 @@ bool PowerConfig::setManualOutputActive(bool manualMode)
     }
 
     _manualOutputActive = manualMode;
-    _preferences->putBool(KEY_SETTING_POWER_MANUAL_MODE, _manualOutputActive);
+    _store->set(_data->manualPowerActive, _manualOutputActive);
     return _manualOutputActive;
 }
 
@@ -228,7 +275,7 @@ uint8_t PowerConfig::setManualPower(uint8_t manualPower)
     }
 
     _manualPower = manualPower;
-    _preferences->putUChar(KEY_SETTING_POWER_MANUAL_POWER, _manualPower);
+    _store->set(_data->manualPower, _manualPower);
     return _manualPower;
 }
 
@@ -278,16 +325,9 @@ PowerArea *PowerConfig::getArea(float temperature)
 ##############################################
 */
 
-PowerArea::PowerArea(size_t index, PowerConfig *config, Preferences *preferences) : index(index), _config(config), _preferences(preferences)
+PowerArea::PowerArea(size_t index, PowerConfig *config, ConfigStore *store, ConfigPowerAreaData *data)
+    : _config(config), _store(store), _data(data), _start(data->start / 10.0f), _end(data->end / 10.0f), _powerLimit(data->powerLimit), index(index)
 {
-    auto keyStart = String(KEY_SETTING_POWER_AREA_START) + index;
-    _start = preferences->getShort(keyStart.c_str(), 0) / 10.0f;
-
-    auto keyEnd = String(KEY_SETTING_POWER_AREA_END) + index;
-    _end = preferences->getShort(keyEnd.c_str(), 0) / 10.0f;
-
-    auto keyLimit = String(KEY_SETTING_POWER_AREA_LIMIT) + index;
-    _powerLimit = preferences->getUChar(keyLimit.c_str(), MAX_POWER_LIMIT);
 };
 
 float PowerArea::setStart(float start)
@@ -302,8 +342,7 @@ float PowerArea::setStart(float start)
     }
 
     _start = start;
-    auto keyStart = String(KEY_SETTING_POWER_AREA_START) + index;
-    _preferences->putShort(keyStart.c_str(), (int16_t)(_start * 10));
+    _store->set(_data->start, (int16_t)roundf(_start * 10));
     return _start;
 }
 
@@ -319,8 +358,7 @@ float PowerArea::setEnd(float end)
     }
 
     _end = end;
-    auto keyEnd = String(KEY_SETTING_POWER_AREA_END) + index;
-    _preferences->putShort(keyEnd.c_str(), (int16_t)(_end * 10));
+    _store->set(_data->end, (int16_t)roundf(_end * 10));
     return _end;
 }
 
@@ -335,8 +373,7 @@ uint8_t PowerArea::setPowerLimit(uint8_t powerLimit)
     }
 
     _powerLimit = powerLimit;
-    auto keyLimit = String(KEY_SETTING_POWER_AREA_LIMIT) + index;
-    _preferences->putUChar(keyLimit.c_str(), _powerLimit);
+    _store->set(_data->powerLimit, _powerLimit);
     return _powerLimit;
 }
 
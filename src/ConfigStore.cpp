@@ -0,0 +1,126 @@
+#define LOG_LEVEL NONE
+
+#include <Arduino.h>
+#include <esp_rom_crc.h>
+#include "ConfigStore.h"
+#include "SerialLogging.h"
+
+ConfigStore::ConfigStore(const char *name, const char *key, uint16_t version, void *data, size_t size)
+    : _key(key), _version(version), _data(static_cast<uint8_t *>(data)), _size(size)
+{
+    assert(sizeof(ConfigStoreHeader) + size <= CONFIG_STORE_BLOB_SIZE);
+    _preferences.begin(name, false);
+}
+
+uint16_t ConfigStore::load()
+{
+    // The whole blob is read at once, the size of the stored blob may differ (other layout version)
+    uint8_t blob[CONFIG_STORE_BLOB_SIZE];
+    size_t length = _preferences.getBytes(_key, blob, sizeof(blob));
+    ConfigStoreHeader header;
+    memcpy(&header, blob, sizeof(header));
+    if (length < sizeof(header) || header.version == 0 || sizeof(header) + header.size != length ||
+        header.crc != esp_rom_crc32_le(0, blob + sizeof(header), header.size))
+    {
+#ifdef LOG_WARNING
+        LOG_WARNING(F("ConfigStore"), F("load"), F("No valid blob found ({} bytes)"), length);
+#endif
+        return 0;
+    }
+
+    portENTER_CRITICAL(&_mux);
+    memcpy(_data, blob + sizeof(header), min(header.size, _size));
+    _stats.loadVersion = header.version;
+    portEXIT_CRITICAL(&_mux);
+#ifdef LOG_DEBUG
+    LOG_DEBUG(F("ConfigStore"), F("load"), F("Loaded version {} ({} bytes)"), header.version, header.size);
+#endif
+    return header.version;
+}
+
+void ConfigStore::changed()
+{
+    uint32_t now = millis();
+    if (_changeCnt == _commitCnt)
+        _firstChange = now;
+    _lastChange = now;
+    _changeCnt++;
+    _stats.changes++;
+    _stats.pending = _changeCnt - _commitCnt;
+}
+
+void ConfigStore::update()
+{
+    uint32_t now = millis();
+    portENTER_CRITICAL(&_mux);
+    bool due = _changeCnt != _commitCnt && (now - _lastChange >= CONFIG_STORE_COMMIT_DELAY || now - _firstChange >= CONFIG_STORE_COMMIT_MAX);
+    portEXIT_CRITICAL(&_mux);
+
+    if (due)
+    {
+        commit();
+    }
+}
+
+bool ConfigStore::commit(bool force)
+{
+    uint8_t blob[CONFIG_STORE_BLOB_SIZE];
+    portENTER_CRITICAL(&_mux);
+    uint32_t changeCnt = _changeCnt;
+    memcpy(blob + sizeof(ConfigStoreHeader), _data, _size);
+    portEXIT_CRITICAL(&_mux);
+
+    if (!force && changeCnt == _commitCnt)
+    {
+        return true;
+    }
+
+    uint32_t start = micros();
+    ConfigStoreHeader header;
+    header.version = _version;
+    header.size = _size;
+    header.crc = esp_rom_crc32_le(0, blob + sizeof(header), _size);
+    memcpy(blob, &header, sizeof(header));
+    size_t length = sizeof(header) + _size;
+    bool written = _preferences.putBytes(_key, blob, length) == length;
+    uint32_t duration = micros() - start;
+
+    // Changes made during the write stay pending, a failed write is retried after the next quiet period
+    portENTER_CRITICAL(&_mux);
+    if (written)
+    {
+        uint32_t committed = changeCnt - _commitCnt;
+        if (committed > 1)
+            _stats.coalesced += committed - 1;
+        _commitCnt = changeCnt;
+        _stats.commits++;
+        _stats.bytes += length;
+    }
+    else
+    {
+        _stats.failures++;
+    }
+    _stats.commitTimeLast = duration;
+    if (duration > _stats.commitTimeMax)
+        _stats.commitTimeMax = duration;
+    _stats.pending = _changeCnt - _commitCnt;
+    _firstChange = _lastChange = millis();
+    portEXIT_CRITICAL(&_mux);
+
+#ifdef LOG_ERROR
+    if (!written)
+        LOG_ERROR(F("ConfigStore"), F("commit"), F("Failed to write {} bytes"), length);
+#endif
+#ifdef LOG_DEBUG
+    LOG_DEBUG(F("ConfigStore"), F("commit"), F("{} bytes written in {} us"), length, duration);
+#endif
+    return written;
+}
+
+ConfigStoreStats ConfigStore::getStats() const
+{
+    portENTER_CRITICAL(&_mux);
+    auto stats = _stats;
+    portEXIT_CRITICAL(&_mux);
+    return stats;
+}
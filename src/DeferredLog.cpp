@@ -0,0 +1,234 @@
+#include <Arduino.h>
+#include "DeferredLog.h"
+#include "SerialLogging.h"
+
+#if DEFERRED_LOG_ENABLED
+
+DeferredLogClass DeferredLog;
+
+/// @brief Gets the name of a log level
+static const char *getLevelName(uint8_t level)
+{
+    switch (level)
+    {
+    case DEBUG:
+        return "DEBUG";
+    case INFO:
+        return "INFO";
+    case WARNING:
+        return "WARNING";
+    case ERROR:
+        return "ERROR";
+    default:
+        return "LOG";
+    }
+}
+
+size_t DeferredLogRecord::format(char *out, size_t length, bool withTime) const
+{
+    if (length < 1)
+        return 0;
+
+    auto header = getHeader();
+    size_t pos = 0;
+    auto append = [&](int written)
+    {
+        if (written > 0)
+            pos += (size_t)written < length - pos ? written : length - pos - 1;
+    };
+
+    if (withTime)
+        append(snprintf(out + pos, length - pos, "%u ", header.time));
+    append(snprintf(out + pos, length - pos, "%s\t[%s.%s] ", getLevelName(header.level), header.cl, header.fn));
+
+    uint16_t offset = sizeof(DeferredLogHeader);
+    uint8_t argIndex = 0;
+    for (const char *c = header.fmt; *c && pos < length - 1; c++)
+    {
+        if (c[0] != '{' || c[1] != '}' || argIndex >= header.argc || offset >= _size)
+        {
+            out[pos++] = *c;
+            continue;
+        }
+
+        c++;
+        argIndex++;
+        char type = _data[offset++];
+        switch (type)
+        {
+        case 'i':
+        {
+            int32_t v;
+            memcpy(&v, _data + offset, sizeof(v));
+            offset += sizeof(v);
+            append(snprintf(out + pos, length - pos, "%d", (int)v));
+            break;
+        }
+        case 'u':
+        {
+            uint32_t v;
+            memcpy(&v, _data + offset, sizeof(v));
+            offset += sizeof(v);
+            append(snprintf(out + pos, length - pos, "%u", (unsigned int)v));
+            break;
+        }
+        case 'I':
+        {
+            int64_t v;
+            memcpy(&v, _data + offset, sizeof(v));
+            offset += sizeof(v);
+            append(snprintf(out + pos, length - pos, "%lld", (long long)v));
+            break;
+        }
+        case 'U':
+        {
+            uint64_t v;
+            memcpy(&v, _data + offset, sizeof(v));
+            offset += sizeof(v);
+            append(snprintf(out + pos, length - pos, "%llu", (unsigned long long)v));
+            break;
+        }
+        case 'f':
+        {
+            float v;
+            memcpy(&v, _data + offset, sizeof(v));
+            offset += sizeof(v);
+            append(snprintf(out + pos, length - pos, "%.2f", v));
+            break;
+        }
+        case 's':
+        {
+            uint8_t size = _data[offset++];
+            append(snprintf(out + pos, length - pos, "%.*s", (int)size, (const char *)_data + offset));
+            offset += size;
+            break;
+        }
+        default:
+            // Unknown type, the remaining arguments can't be decoded
+            offset = _size;
+            break;
+        }
+    }
+
+    out[pos] = '\0';
+    return pos;
+}
+
+bool DeferredLogClass::begin()
+{
+    if (_task)
+    {
+        return true;
+    }
+
+    if (xTaskCreate(taskLoop, "DeferredLog", DEFERRED_LOG_STACK_SIZE, this, DEFERRED_LOG_PRIORITY, &_task) != pdPASS)
+    {
+        _task = nullptr;
+        Serial.println(F("ERROR\t[DeferredLog.begin] Failed to create task"));
+        return false;
+    }
+
+    return true;
+}
+
+void DeferredLogClass::copyOut(uint32_t position, void *data, size_t size) const
+{
+    size_t index = position % DEFERRED_LOG_SIZE;
+    size_t first = size < DEFERRED_LOG_SIZE - index ? size : DEFERRED_LOG_SIZE - index;
+    memcpy(data, _buffer + index, first);
+    memcpy((uint8_t *)data + first, _buffer, size - first);
+}
+
+void DeferredLogClass::copyIn(uint32_t position, const void *data, size_t size)
+{
+    size_t index = position % DEFERRED_LOG_SIZE;
+    size_t first = size < DEFERRED_LOG_SIZE - index ? size : DEFERRED_LOG_SIZE - index;
+    memcpy(_buffer + index, data, first);
+    memcpy(_buffer, (const uint8_t *)data + first, size - first);
+}
+
+uint16_t DeferredLogClass::readSize(uint32_t position) const
+{
+    uint16_t size;
+    copyOut(position, &size, sizeof(size));
+    return size;
+}
+
+void DeferredLogClass::commit(DeferredLogRecord &record, uint8_t level, const __FlashStringHelper *cl, const __FlashStringHelper *fn, const __FlashStringHelper *fmt)
+{
+    DeferredLogHeader header;
+    header.size = record._size;
+    header.level = level;
+    header.argc = record._argc;
+    header.time = millis();
+    header.cl = reinterpret_cast<const char *>(cl);
+    header.fn = reinterpret_cast<const char *>(fn);
+    header.fmt = reinterpret_cast<const char *>(fmt);
+    memcpy(record._data, &header, sizeof(header));
+
+    portENTER_CRITICAL(&_mux);
+    // Overwrite the oldest records until the new one fits
+    while (_head + header.size - _tail > DEFERRED_LOG_SIZE)
+    {
+        if (_drained == _tail)
+        {
+            _drained += readSize(_tail);
+            _lost++;
+        }
+        _tail += readSize(_tail);
+    }
+
+    copyIn(_head, record._data, header.size);
+    _head += header.size;
+    _records++;
+    portEXIT_CRITICAL(&_mux);
+}
+
+bool DeferredLogClass::read(uint32_t &position, DeferredLogRecord &record) const
+{
+    portENTER_CRITICAL(&_mux);
+    if ((int32_t)(position - _tail) < 0)
+    {
+        position = _tail;
+    }
+
+    if ((int32_t)(_head - position) <= 0)
+    {
+        portEXIT_CRITICAL(&_mux);
+        return false;
+    }
+
+    uint16_t size = readSize(position);
+    copyOut(position, record._data, size);
+    record._size = size;
+    record._argc = record.getHeader().argc;
+    position += size;
+    portEXIT_CRITICAL(&_mux);
+    return true;
+}
+
+void DeferredLogClass::taskLoop(void *parameter)
+{
+    auto log = static_cast<DeferredLogClass *>(parameter);
+    DeferredLogRecord record;
+    char line[DEFERRED_LOG_LINE_SIZE];
+    for (;;)
+    {
+        uint32_t position = log->_drained;
+        while (log->read(position, record))
+        {
+            // Only the drain task moves _drained forward, commit() only moves it if the record gets overwritten
+            portENTER_CRITICAL(&log->_mux);
+            if ((int32_t)(position - log->_drained) > 0)
+                log->_drained = position;
+            portEXIT_CRITICAL(&log->_mux);
+
+            record.format(line, sizeof(line), false);
+            Serial.println(line);
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(DEFERRED_LOG_DRAIN_CYCLE));
+    }
+}
+
+#endif
@@ -0,0 +1,44 @@
+#include "DigitalPotiTable.h"
+
+DigitalPotiTable::DigitalPotiTable(ThermistorCalc &thermistor, uint16_t steps, uint16_t stepMin, float resistance, float preResistance) : _stepMin(stepMin), _stepMax(steps)
+{
+    _temperatures = new float[steps + 1];
+    float stepResistance = resistance / (steps + 1);
+    for (uint16_t position = 0; position <= steps; position++)
+    {
+        _temperatures[position] = thermistor.celsiusFromResistance(preResistance + stepResistance + position * stepResistance);
+    }
+}
+
+DigitalPotiTable::~DigitalPotiTable()
+{
+    delete[] _temperatures;
+}
+
+DigitalPotiPosition DigitalPotiTable::lookup(float targetTemperature) const
+{
+    // Binary search for the interval temperatures[low] >= target > temperatures[high] (descending table)
+    uint16_t low = _stepMin;
+    uint16_t high = _stepMax;
+    if (targetTemperature >= _temperatures[low])
+    {
+        return {low, _temperatures[low]};
+    }
+
+    if (targetTemperature <= _temperatures[high])
+    {
+        return {high, _temperatures[high]};
+    }
+
+    while (high - low > 1)
+    {
+        uint16_t mid = (low + high) / 2;
+        if (_temperatures[mid] >= targetTemperature)
+            low = mid;
+        else
+            high = mid;
+    }
+
+    uint16_t position = _temperatures[low] - targetTemperature <= targetTemperature - _temperatures[high] ? low : high;
+    return {position, _temperatures[position]};
+}
@@ -0,0 +1,288 @@
+#define LOG_LEVEL NONE
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "HistoryLog.h"
+#include "SerialLogging.h"
+
+void HistoryLog::getSegmentPath(uint32_t segment, char *path, size_t size)
+{
+    snprintf(path, size, HISTORY_LOG_PATH "/%08u.bin", segment);
+}
+
+bool HistoryLog::begin()
+{
+    if (_mounted)
+    {
+        return true;
+    }
+
+    if (!LittleFS.begin(true))
+    {
+#ifdef LOG_ERROR
+        LOG_ERROR(F("HistoryLog"), F("begin"), F("LittleFS could not be mounted"));
+#endif
+        return false;
+    }
+
+    LittleFS.mkdir(HISTORY_LOG_PATH);
+    uint32_t first = UINT32_MAX;
+    uint32_t last = 0;
+    uint32_t count = 0;
+    auto dir = LittleFS.open(HISTORY_LOG_PATH);
+    for (auto file = dir.openNextFile(); file; file = dir.openNextFile())
+    {
+        auto name = strrchr(file.name(), '/');
+        uint32_t segment = strtoul(name ? name + 1 : file.name(), nullptr, 10);
+        if (segment < first)
+            first = segment;
+        if (segment >= last)
+        {
+            last = segment;
+            _segmentSize = file.size();
+        }
+        count++;
+    }
+
+    // An interrupted write leaves an incomplete record, continue with a new segment so the records stay aligned
+    if (_segmentSize % sizeof(HistoryLogRecord) != 0)
+        _segmentSize = HISTORY_LOG_SEGMENT_SIZE;
+
+    // New records need to be written after the newest record
+    if (count > 0)
+    {
+        char path[32];
+        getSegmentPath(last, path, sizeof(path));
+        auto file = LittleFS.open(path, FILE_READ);
+        size_t size = file ? file.size() / sizeof(HistoryLogRecord) * sizeof(HistoryLogRecord) : 0;
+        if (size > 0 && file.seek(size - sizeof(HistoryLogRecord)))
+            file.read(reinterpret_cast<uint8_t *>(&_lastTime), sizeof(_lastTime));
+        file.close();
+    }
+
+    _writeLock = xSemaphoreCreateMutexStatic(&_writeLockBuffer);
+    portENTER_CRITICAL(&_mux);
+    _firstSegment = count > 0 ? first : 0;
+    _lastSegment = last;
+    _stats.segments = count;
+    _mounted = true;
+    portEXIT_CRITICAL(&_mux);
+#ifdef LOG_INFO
+    LOG_INFO(F("HistoryLog"), F("begin"), F("Found {} segments ({} to {}), {} of {} bytes used"), count, _firstSegment, _lastSegment, LittleFS.usedBytes(), LittleFS.totalBytes());
+#endif
+    return true;
+}
+
+void HistoryLog::update(const HistoryStore &history, time_t bootTime)
+{
+    uint32_t first, last;
+    if (!_mounted || !history.getRange(HISTORY_LOG_TIER, first, last))
+    {
+        return;
+    }
+
+    uint32_t period = history.getPeriod(HISTORY_LOG_TIER);
+    for (uint32_t slot = _nextSlot > first ? _nextSlot : first; slot <= last; slot++)
+    {
+        HistoryLogRecord record;
+        if (!history.read(HISTORY_LOG_TIER, slot, record.entry))
+            continue;
+
+        // Minutes without any value (gaps) are not written
+        bool empty = true;
+        for (uint8_t c = 0; c < HISTORY_CHANNEL_CNT; c++)
+            empty &= record.entry.mean[c] == HISTORY_NO_VALUE;
+        if (empty)
+            continue;
+
+        // Minutes before the newest record are skipped (already written before a reboot or the system time has been corrected)
+        record.time = bootTime + slot * period;
+        if (record.time <= _lastTime)
+            continue;
+
+        _lastTime = record.time;
+        portENTER_CRITICAL(&_mux);
+        _page[_pageCount++] = record;
+        bool full = _pageCount >= sizeof(_page) / sizeof(_page[0]);
+        portEXIT_CRITICAL(&_mux);
+        if (full)
+            writePage();
+    }
+
+    _nextSlot = last + 1;
+}
+
+void HistoryLog::flush()
+{
+    if (_mounted)
+    {
+        writePage();
+    }
+}
+
+void HistoryLog::writePage()
+{
+    // The write lock is held from taking the records out of the page until they are appended, so a flush of another
+    // task (shutdown handler) waits for a running write and the pages are appended in the order of their records.
+    // The spinlock only guards the page and the counters, it must not be held while the file system is busy.
+    if (xSemaphoreTake(_writeLock, portMAX_DELAY) != pdTRUE)
+    {
+        return;
+    }
+
+    HistoryLogRecord page[sizeof(_page) / sizeof(_page[0])];
+    uint32_t removed = UINT32_MAX;
+    portENTER_CRITICAL(&_mux);
+    uint8_t count = _pageCount;
+    if (count == 0)
+    {
+        portEXIT_CRITICAL(&_mux);
+        xSemaphoreGive(_writeLock);
+        return;
+    }
+
+    memcpy(page, _page, count * sizeof(HistoryLogRecord));
+    _pageCount = 0;
+    size_t size = count * sizeof(HistoryLogRecord);
+    if (_stats.segments == 0 || _segmentSize + size > HISTORY_LOG_SEGMENT_SIZE)
+    {
+        if (_stats.segments > 0)
+            _lastSegment++;
+        _segmentSize = 0;
+        _stats.segments++;
+        _stats.rotations++;
+        if (_stats.segments > HISTORY_LOG_SEGMENT_CNT)
+        {
+            removed = _firstSegment++;
+            _stats.segments--;
+        }
+    }
+    uint32_t segment = _lastSegment;
+    _segmentSize += size;
+    portEXIT_CRITICAL(&_mux);
+
+    char path[32];
+    if (removed != UINT32_MAX)
+    {
+        getSegmentPath(removed, path, sizeof(path));
+        LittleFS.remove(path);
+    }
+
+    getSegmentPath(segment, path, sizeof(path));
+    auto file = LittleFS.open(path, FILE_APPEND);
+    size_t written = file ? file.write(reinterpret_cast<const uint8_t *>(page), size) : 0;
+    file.close();
+
+    portENTER_CRITICAL(&_mux);
+    if (written == size)
+    {
+        _stats.records += count;
+        _stats.writes++;
+        _stats.bytes += size;
+    }
+    else
+    {
+        // The segment may end with an incomplete record now, continue with a new segment
+        _segmentSize = HISTORY_LOG_SEGMENT_SIZE;
+        _stats.failures++;
+    }
+    portEXIT_CRITICAL(&_mux);
+    xSemaphoreGive(_writeLock);
+#ifdef LOG_ERROR
+    if (written != size)
+        LOG_ERROR(F("HistoryLog"), F("writePage"), F("Failed to write {} records to segment {}"), count, segment);
+#endif
+}
+
+bool HistoryLog::getSegments(uint32_t &first, uint32_t &last) const
+{
+    portENTER_CRITICAL(&_mux);
+    first = _firstSegment;
+    last = _lastSegment;
+    bool available = _mounted && _stats.segments > 0;
+    portEXIT_CRITICAL(&_mux);
+    return available;
+}
+
+HistoryLogStats HistoryLog::getStats() const
+{
+    portENTER_CRITICAL(&_mux);
+    auto stats = _stats;
+    portEXIT_CRITICAL(&_mux);
+    return stats;
+}
+
+HistoryLogReader::HistoryLogReader(const HistoryLog *log, time_t from, time_t to) : _log(log), _from(from), _to(to)
+{
+    _done = !log->getSegments(_segment, _lastSegment);
+}
+
+bool HistoryLogReader::openSegment()
+{
+    char path[32];
+    HistoryLog::getSegmentPath(_segment, path, sizeof(path));
+    _file = LittleFS.open(path, FILE_READ);
+    if (!_file)
+    {
+        return false;
+    }
+
+    // Records are sorted by time, search the first record of the range
+    size_t low = 0;
+    size_t high = _file.size() / sizeof(HistoryLogRecord);
+    while (low < high)
+    {
+        size_t mid = (low + high) / 2;
+        uint32_t time = 0;
+        _file.seek(mid * sizeof(HistoryLogRecord));
+        _file.read(reinterpret_cast<uint8_t *>(&time), sizeof(time));
+        if ((time_t)time < _from)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    _file.seek(low * sizeof(HistoryLogRecord));
+    return true;
+}
+
+bool HistoryLogReader::next(HistoryLogRecord &record)
+{
+    while (!_done)
+    {
+        if (!_file)
+        {
+            if (_segment > _lastSegment)
+            {
+                _done = true;
+                break;
+            }
+
+            if (!openSegment())
+            {
+                // Removed by the rotation meanwhile
+                _segment++;
+                continue;
+            }
+        }
+
+        if (_file.read(reinterpret_cast<uint8_t *>(&record), sizeof(record)) != sizeof(record))
+        {
+            // End of the segment (an incomplete record of an interrupted write is ignored)
+            _file.close();
+            _segment++;
+            continue;
+        }
+
+        if ((time_t)record.time > _to)
+        {
+            _file.close();
+            _done = true;
+            return false;
+        }
+
+        return true;
+    }
+
+    return false;
+}
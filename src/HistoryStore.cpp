@@ -0,0 +1,174 @@
+#include <Arduino.h>
+#include "HistoryStore.h"
+
+HistoryStore::HistoryStore()
+{
+    _tiers[0].period = 1;
+    _tiers[0].count = HISTORY_SECONDS_CNT;
+    _tiers[1].period = 60;
+    _tiers[1].count = HISTORY_MINUTES_CNT;
+    _tiers[2].period = 900;
+    _tiers[2].count = HISTORY_QUARTERS_CNT;
+}
+
+int16_t HistoryStore::toFixed(float value)
+{
+    if (isnanf(value))
+        return HISTORY_NO_VALUE;
+
+    float scaled = value * HISTORY_SCALE;
+    if (scaled >= INT16_MAX)
+        return INT16_MAX;
+    if (scaled <= INT16_MIN + 1)
+        return INT16_MIN + 1;
+    return (int16_t)lroundf(scaled);
+}
+
+float HistoryStore::toFloat(int16_t value)
+{
+    return value == HISTORY_NO_VALUE ? NAN : (float)value / HISTORY_SCALE;
+}
+
+void HistoryStore::advance(uint8_t tier, uint32_t slot)
+{
+    auto &t = _tiers[tier];
+    if (t.last == UINT32_MAX)
+    {
+        t.first = slot;
+        t.last = slot;
+        return;
+    }
+
+    // Periods without values are kept as gaps (at most one ring)
+    HistoryEntry empty;
+    for (uint8_t c = 0; c < HISTORY_CHANNEL_CNT; c++)
+        empty.min[c] = empty.max[c] = empty.mean[c] = HISTORY_NO_VALUE;
+    uint32_t gap = slot - t.last;
+    for (uint32_t s = gap > t.count ? slot - t.count : t.last + 1; s < slot; s++)
+        write(tier, s, empty);
+
+    t.last = slot;
+    if (t.last - t.first >= t.count)
+        t.first = t.last - t.count + 1;
+}
+
+void HistoryStore::write(uint8_t tier, uint32_t slot, const HistoryEntry &entry)
+{
+    switch (tier)
+    {
+    case 0:
+        for (uint8_t c = 0; c < HISTORY_CHANNEL_CNT; c++)
+            _seconds[slot % HISTORY_SECONDS_CNT].value[c] = entry.mean[c];
+        break;
+    case 1:
+        _minutes[slot % HISTORY_MINUTES_CNT] = entry;
+        break;
+    default:
+        _quarters[slot % HISTORY_QUARTERS_CNT] = entry;
+        break;
+    }
+}
+
+void HistoryStore::accumulate(uint8_t tier, uint32_t slot, const int16_t *values)
+{
+    auto &acc = _accumulators[tier];
+    if (acc.slot != slot)
+    {
+        if (acc.slot != UINT32_MAX)
+        {
+            // The period is completed, add its aggregation to the ring
+            HistoryEntry entry;
+            for (uint8_t c = 0; c < HISTORY_CHANNEL_CNT; c++)
+            {
+                int32_t n = acc.samples[c];
+                entry.min[c] = n > 0 ? acc.min[c] : HISTORY_NO_VALUE;
+                entry.max[c] = n > 0 ? acc.max[c] : HISTORY_NO_VALUE;
+                entry.mean[c] = n > 0 ? (acc.sum[c] >= 0 ? (acc.sum[c] + n / 2) / n : (acc.sum[c] - n / 2) / n) : HISTORY_NO_VALUE;
+            }
+            advance(tier, acc.slot);
+            write(tier, acc.slot, entry);
+        }
+
+        acc.slot = slot;
+        for (uint8_t c = 0; c < HISTORY_CHANNEL_CNT; c++)
+        {
+            acc.sum[c] = 0;
+            acc.samples[c] = 0;
+            acc.min[c] = INT16_MAX;
+            acc.max[c] = INT16_MIN;
+        }
+    }
+
+    for (uint8_t c = 0; c < HISTORY_CHANNEL_CNT; c++)
+    {
+        if (values[c] == HISTORY_NO_VALUE)
+            continue;
+
+        acc.sum[c] += values[c];
+        acc.samples[c]++;
+        if (values[c] < acc.min[c])
+            acc.min[c] = values[c];
+        if (values[c] > acc.max[c])
+            acc.max[c] = values[c];
+    }
+}
+
+void HistoryStore::add(uint32_t time, const float *values)
+{
+    int16_t fixed[HISTORY_CHANNEL_CNT];
+    HistoryEntry point;
+    for (uint8_t c = 0; c < HISTORY_CHANNEL_CNT; c++)
+    {
+        fixed[c] = toFixed(values[c]);
+        point.min[c] = point.max[c] = point.mean[c] = fixed[c];
+    }
+
+    portENTER_CRITICAL(&_mux);
+    auto &seconds = _tiers[0];
+    if (seconds.last == UINT32_MAX || time > seconds.last)
+    {
+        advance(0, time);
+        write(0, time, point);
+        for (uint8_t tier = 1; tier < HISTORY_TIER_CNT; tier++)
+            accumulate(tier, time / _tiers[tier].period, fixed);
+    }
+    else if (time >= seconds.first)
+    {
+        // The second has already been accumulated into the other tiers, only its value is replaced
+        write(0, time, point);
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+bool HistoryStore::read(uint8_t tier, uint32_t slot, HistoryEntry &entry) const
+{
+    if (tier >= HISTORY_TIER_CNT)
+        return false;
+
+    portENTER_CRITICAL(&_mux);
+    auto &t = _tiers[tier];
+    bool valid = t.last != UINT32_MAX && slot >= t.first && slot <= t.last;
+    if (valid && tier == 0)
+    {
+        for (uint8_t c = 0; c < HISTORY_CHANNEL_CNT; c++)
+            entry.min[c] = entry.max[c] = entry.mean[c] = _seconds[slot % HISTORY_SECONDS_CNT].value[c];
+    }
+    else if (valid)
+    {
+        entry = tier == 1 ? _minutes[slot % HISTORY_MINUTES_CNT] : _quarters[slot % HISTORY_QUARTERS_CNT];
+    }
+    portEXIT_CRITICAL(&_mux);
+    return valid;
+}
+
+bool HistoryStore::getRange(uint8_t tier, uint32_t &first, uint32_t &last) const
+{
+    if (tier >= HISTORY_TIER_CNT)
+        return false;
+
+    portENTER_CRITICAL(&_mux);
+    first = _tiers[tier].first;
+    last = _tiers[tier].last;
+    portEXIT_CRITICAL(&_mux);
+    return last != UINT32_MAX;
+}
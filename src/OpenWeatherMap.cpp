@@ -5,52 +5,293 @@
 #include "OpenWeatherMap.h"
 #include "SerialLogging.h"
 
-OpenWeatherMap::OpenWeatherMap(String apiKey, unsigned int cityId) : apiUrl(String("https://api.openweathermap.org/data/2.5/weather?id=") + cityId + "&lang=en&units=METRIC&appid=" + apiKey)
+OpenWeatherMap::OpenWeatherMap(String apiKey, unsigned int cityId, const String &baseUrl)
+    : apiUrl(baseUrl + "/data/2.5/weather?id=" + cityId + "&lang=en&units=METRIC&appid=" + apiKey),
+      forecastUrl(baseUrl + "/data/2.5/forecast?id=" + cityId + "&cnt=" + WEATHER_FORECAST_SIZE + "&lang=en&units=METRIC&appid=" + apiKey)
 {
+    init();
 }
 
-OpenWeatherMap::OpenWeatherMap(String apiKey, double latitude, double longitude) : apiUrl(String("https://api.openweathermap.org/data/2.5/weather?lat=") + String(latitude, 6) + "&lon=" + String(longitude, 6) + "&lang=en&units=METRIC&appid=" + apiKey)
+OpenWeatherMap::OpenWeatherMap(String apiKey, double latitude, double longitude, const String &baseUrl)
+    : apiUrl(baseUrl + "/data/2.5/weather?lat=" + String(latitude, 6) + "&lon=" + String(longitude, 6) + "&lang=en&units=METRIC&appid=" + apiKey),
+      forecastUrl(baseUrl + "/data/2.5/forecast?lat=" + String(latitude, 6) + "&lon=" + String(longitude, 6) + "&cnt=" + WEATHER_FORECAST_SIZE + "&lang=en&units=METRIC&appid=" + apiKey)
 {
+    init();
 }
 
-ApiResponse OpenWeatherMap::request()
+OpenWeatherMap::~OpenWeatherMap()
+{
+    _http.end();
+    _client->stop();
+    delete _client;
+}
+
+void OpenWeatherMap::init()
+{
+    // Split host and port from the URL for the connection that is established ahead of the request
+    int hostStart = apiUrl.indexOf("://") + 3;
+    int hostEnd = apiUrl.indexOf('/', hostStart);
+    _host = apiUrl.substring(hostStart, hostEnd);
+    bool secure = apiUrl.startsWith("https");
+    _port = secure ? 443 : 80;
+    int portStart = _host.indexOf(':');
+    if (portStart >= 0)
+    {
+        _port = _host.substring(portStart + 1).toInt();
+        _host = _host.substring(0, portStart);
+    }
+
+    if (secure)
+    {
+        // Same as the HTTPClient does for HTTPS URLs without CA certificate
+        _secureClient = new WiFiClientSecure();
+        _secureClient->setInsecure();
+        _client = _secureClient;
+    }
+    else
+    {
+        _client = new WiFiClient();
+    }
+
+    _http.setReuse(true);
+    _http.useHTTP10(true); // No chunked transfer encoding, so the JSON can be parsed directly from the stream
+    static const char *headerKeys[] = {"Date"};
+    _http.collectHeaders(headerKeys, 1);
+}
+
+/// @brief Gets the remaining time until the deadline
+/// @return the remaining time in milliseconds, 0 if the deadline has passed
+static uint16_t remainingTime(unsigned long deadline)
+{
+    long remaining = (long)(deadline - millis());
+    return remaining > 0 ? remaining : 0;
+}
+
+bool OpenWeatherMap::connect(ApiRequestStats &stats, unsigned long deadline)
+{
+    stats.reused = _client->connected();
+    if (stats.reused)
+    {
+        return true;
+    }
+
+    _client->stop();
+    uint16_t timeout = remainingTime(deadline);
+    if (timeout == 0)
+    {
+        return false;
+    }
+
+    auto start = millis();
+    bool connected;
+    if (_secureClient)
+    {
+        // The connect overloads with timeout are not virtual, so the secure client has to be called directly
+        _secureClient->setHandshakeTimeout((timeout + 999) / 1000);
+        connected = _secureClient->connect(_host.c_str(), _port, timeout);
+    }
+    else
+    {
+        connected = _client->connect(_host.c_str(), _port, timeout);
+    }
+    stats.handshake = millis() - start;
+#ifdef LOG_DEBUG
+    LOG_DEBUG(F("OpenWeatherMap"), F("connect"), F("Connected = {} in {} ms"), connected, stats.handshake);
+#endif
+    return connected;
+}
+
+/// @brief Stream wrapper that counts the bytes read from the underlying stream and stops waiting at the deadline
+class CountingStream : public Stream
+{
+private:
+    Stream &_stream;
+    const unsigned long _deadline;
+    uint32_t _count = 0;
+
+public:
+    CountingStream(Stream &stream, unsigned long deadline) : _stream(stream), _deadline(deadline) {};
+    uint32_t getCount() const { return _count; };
+    size_t readBytes(char *buffer, size_t length) override
+    {
+        size_t count = 0;
+        while (count < length)
+        {
+            // Each byte may only wait for the remaining time of the request
+            setTimeout(remainingTime(_deadline));
+            int c = timedRead();
+            if (c < 0)
+                break;
+            buffer[count++] = (char)c;
+        }
+        return count;
+    };
+    int available() override { return _stream.available(); };
+    int peek() override { return _stream.peek(); };
+    int read() override
+    {
+        int c = _stream.read();
+        if (c >= 0)
+            _count++;
+        return c;
+    };
+    size_t write(uint8_t) override { return 0; };
+};
+
+/// @brief Parses a HTTP Date header (RFC 7231 IMF-fixdate, e.g. "Sun, 06 Nov 1994 08:49:37 GMT")
+/// @return Epoch unix in seconds, UTC or 0 if the date is invalid
+static time_t parseHttpDate(const String &date)
 {
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    int day, year, hour, minute, second;
+    char month[4];
+    if (sscanf(date.c_str(), "%*3s, %d %3s %d %d:%d:%d", &day, month, &year, &hour, &minute, &second) != 6)
+    {
+        return 0;
+    }
+
+    const char *monthPos = strstr(months, month);
+    if (!monthPos || (monthPos - months) % 3 != 0)
+    {
+        return 0;
+    }
+
+    // Days since 1970-01-01 of the civil date (proleptic Gregorian calendar)
+    int m = (monthPos - months) / 3 + 1;
+    int y = year - (m <= 2 ? 1 : 0);
+    int era = y / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    long days = era * 146097L + doe - 719468L;
+    return (time_t)days * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+Error OpenWeatherMap::get(const String &url, JsonDocument &filter, JsonDocument &doc, int &httpCode, time_t &serverTime, ApiRequestStats &stats)
+{
+    serverTime = 0;
+    httpCode = HTTP_CODE_REQUEST_TIMEOUT;
     if (WiFi.status() != WL_CONNECTED)
     {
 #ifdef LOG_WARNING
-        LOG_WARNING(F("OpenWeatherMap"), F("request"), F("WiFi is not connected"));
+        LOG_WARNING(F("OpenWeatherMap"), F("get"), F("WiFi is not connected"));
+#endif
+        return WifiNotConnected;
+    }
+
+    auto start = millis();
+    auto deadline = start + _timeout; // One deadline for connect, header and body, the HTTPClient timeouts only limit each phase
+
+    // Lowest free heap during the request, checked after each step that allocates (TLS, response, JSON)
+    uint32_t freeHeapStart = ESP.getFreeHeap();
+    uint32_t freeHeapMin = freeHeapStart;
+    auto heapCheckpoint = [&freeHeapMin]()
+    {
+        uint32_t freeHeap = ESP.getFreeHeap();
+        if (freeHeap < freeHeapMin)
+            freeHeapMin = freeHeap;
+    };
+
+    httpCode = HTTPC_ERROR_CONNECTION_REFUSED;
+    for (uint8_t attempt = 0; attempt < 2; attempt++)
+    {
+        if (!connect(stats, deadline))
+        {
+            break;
+        }
+
+        heapCheckpoint();
+        uint16_t remaining = remainingTime(deadline);
+        _http.setConnectTimeout(remaining);
+        _http.setTimeout(remaining);
+        _http.begin(*_client, url);
+        httpCode = _http.GET();
+        heapCheckpoint();
+        if (httpCode > 0 || !stats.reused)
+        {
+            break;
+        }
+
+        // Connection has been closed by the server while it was idle, retry once with a new connection
+#ifdef LOG_DEBUG
+        LOG_DEBUG(F("OpenWeatherMap"), F("get"), F("Reused connection failed = {}"), httpCode);
 #endif
-        return ApiResponse(WifiNotConnected, HTTP_CODE_REQUEST_TIMEOUT);
+        _http.end();
+        _client->stop();
+    }
+
+    if (httpCode > 0)
+    {
+        serverTime = parseHttpDate(_http.header("Date"));
+        if (remainingTime(deadline) == 0)
+        {
+            // The header timeout is an inactivity timeout, a header that trickles in may end after the deadline
+            httpCode = HTTPC_ERROR_READ_TIMEOUT;
+        }
     }
 
-    HTTPClient client;
-    client.setReuse(false);
-    client.begin(apiUrl);
-    int httpCode = client.GET();
+    Error result = None;
     if (httpCode != HTTP_CODE_OK)
     {
-        client.end();
+        _http.end();
+        _client->stop();
 #ifdef LOG_ERROR
-        LOG_ERROR(F("OpenWeatherMap"), F("request"), F("HTTP Error code = ") + httpCode);
+        LOG_ERROR(F("OpenWeatherMap"), F("get"), F("HTTP Error code = {}"), httpCode);
 #endif
-        return ApiResponse(HttpError, httpCode);
+        result = HttpError;
     }
-
-    auto response = client.getString();
-    client.end();
+    else
+    {
+        CountingStream stream(_http.getStream(), deadline);
+        auto error = deserializeJson(doc, stream, DeserializationOption::Filter(filter));
+        stats.bytes = stream.getCount();
+        heapCheckpoint();
+        _http.end(); // Keeps the connection open if the server allows keep-alive
+        if (error != DeserializationError::Ok)
+        {
+            _client->stop();
+#ifdef LOG_ERROR
+            LOG_ERROR(F("OpenWeatherMap"), F("get"), F("DeserializationError = {}"), error.c_str());
+#endif
+            result = DeserializationFailed;
+        }
 #ifdef LOG_DEBUG
-    LOG_DEBUG(F("OpenWeatherMap"), F("request"), F("response = ") + response);
+        else
+        {
+            LOG_DEBUG(F("OpenWeatherMap"), F("get"), F("response = {}"), doc.as<String>());
+        }
 #endif
+    }
+
+    stats.duration = millis() - start;
+    stats.heapPeak = freeHeapStart - freeHeapMin;
+    return result;
+}
+
+ApiResponse OpenWeatherMap::request()
+{
+    // Only the used values are kept inside the document, everything else is skipped while reading the stream
+    JsonDocument filter;
+    filter["main"]["temp"] = true;
+    filter["dt"] = true;
+    filter["timezone"] = true;
 
     JsonDocument doc;
-    auto error = deserializeJson(doc, response);
-    if (error != DeserializationError::Ok)
+    ApiRequestStats stats;
+    int httpCode;
+    time_t serverTime;
+    auto error = get(apiUrl, filter, doc, httpCode, serverTime, stats);
+    if (error == None && !doc["main"]["temp"].is<float>())
     {
-#ifdef LOG_ERROR
-        LOG_ERROR(F("OpenWeatherMap"), F("request"), F("DeserializationError = ") + error.c_str());
-#endif
-        doc.clear();
-        return ApiResponse(DeserializationFailed, httpCode);
+        error = DeserializationFailed;
+    }
+
+    if (error != None)
+    {
+        ApiResponse failed(error, httpCode);
+        failed.serverTime = serverTime;
+        failed.stats = stats;
+        return failed;
     }
 
     float temperature = doc["main"]["temp"];
@@ -66,14 +307,52 @@ ApiResponse OpenWeatherMap::request()
     auto timeString = String(buf);
 
 #ifdef LOG_INFO
-    LOG_INFO(F("OpenWeatherMap"), F("request"), F("temperature = ") + 
-    temperature + F(" unixTimestampUtc = ") + unixTimestampUtc + 
-    F(" unixTimezoneShift = ") + unixTimezoneShift + 
-    F(" unixTimestampLocal = ") + unixTimestampLocal + 
-    F(" time = ") + timeString);
+    LOG_INFO(F("OpenWeatherMap"), F("request"), F("temperature = {} unixTimestampUtc = {} unixTimezoneShift = {} unixTimestampLocal = {} time = {}"),
+        temperature, unixTimestampUtc, unixTimezoneShift, unixTimestampLocal, timeString);
+#endif
+    ApiResponse response(temperature, timeString);
+    response.time = unixTimestampUtc;
+    response.serverTime = serverTime;
+    response.stats = stats;
+    return response;
+}
+
+ForecastResponse OpenWeatherMap::requestForecast()
+{
+    JsonDocument filter;
+    filter["list"][0]["dt"] = true;
+    filter["list"][0]["main"]["temp"] = true;
+
+    JsonDocument doc;
+    ForecastResponse response = {};
+    response.error = get(forecastUrl, filter, doc, response.httpCode, response.serverTime, response.stats);
+    if (response.error != None)
+    {
+        return response;
+    }
+
+    for (JsonObject point : doc["list"].as<JsonArray>())
+    {
+        if (response.count >= WEATHER_FORECAST_SIZE)
+            break;
+        if (!point["main"]["temp"].is<float>())
+            continue;
+
+        response.points[response.count].time = point["dt"].as<long>();
+        response.points[response.count].temperature = point["main"]["temp"];
+        response.count++;
+    }
+
+    response.successful = response.count > 0;
+    if (!response.successful)
+    {
+        response.error = DeserializationFailed;
+    }
+
+#ifdef LOG_INFO
+    LOG_INFO(F("OpenWeatherMap"), F("requestForecast"), F("points = {}"), response.count);
 #endif
-    doc.clear();
-    return ApiResponse(temperature, timeString);
+    return response;
 }
 
 /*
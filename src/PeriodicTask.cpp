@@ -0,0 +1,69 @@
+#define LOG_LEVEL NONE
+
+#include <Arduino.h>
+#include "PeriodicTask.h"
+#include "SerialLogging.h"
+
+bool PeriodicTask::begin(uint32_t stackSize, UBaseType_t priority, BaseType_t core)
+{
+    if (_task)
+    {
+        return true;
+    }
+
+    if (xTaskCreatePinnedToCore(taskLoop, _name, stackSize, this, priority, &_task, core) != pdPASS)
+    {
+        _task = nullptr;
+#ifdef LOG_ERROR
+        LOG_ERROR(F("PeriodicTask"), F("begin"), F("Failed to create task {}"), _name);
+#endif
+        return false;
+    }
+
+    return true;
+}
+
+void PeriodicTask::taskLoop(void *parameter)
+{
+    auto task = static_cast<PeriodicTask *>(parameter);
+    const TickType_t periodTicks = pdMS_TO_TICKS(task->_periodMs);
+    const int64_t periodUs = (int64_t)task->_periodMs * 1000;
+    PeriodicTaskStats stats;
+    stats.period = periodUs;
+    uint64_t jitterSum = 0;
+
+    TickType_t lastWake = xTaskGetTickCount();
+    int64_t scheduled = esp_timer_get_time();
+    for (;;)
+    {
+        int64_t start = esp_timer_get_time();
+        task->_function();
+        int64_t end = esp_timer_get_time();
+
+        // Wake up jitter against the ideal schedule (the first cycle defines the phase)
+        uint32_t jitter = start > scheduled ? start - scheduled : scheduled - start;
+        uint32_t exec = end - start;
+        stats.cycles++;
+        stats.jitter = jitter;
+        if (jitter > stats.jitterMax)
+            stats.jitterMax = jitter;
+        jitterSum += jitter;
+        stats.jitterAvg = jitterSum / stats.cycles;
+        if (exec > stats.execMax)
+            stats.execMax = exec;
+        if (exec > periodUs)
+            stats.overruns++;
+        task->_stats.store(stats);
+
+        scheduled += periodUs;
+        if (end > scheduled)
+        {
+            // Skip the missed periods instead of running them back to back
+            TickType_t missed = (end - scheduled) / periodUs + 1;
+            scheduled += missed * periodUs;
+            lastWake += missed * periodTicks;
+        }
+
+        vTaskDelayUntil(&lastWake, periodTicks);
+    }
+}
@@ -0,0 +1,92 @@
+#define LOG_LEVEL NONE
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "Probe.h"
+#include "SerialLogging.h"
+
+#ifndef PROBE_CLOCK
+#define PROBE_CLOCK esp_timer_get_time
+#endif
+
+Probe *Probe::_probes[PROBE_MAX_CNT];
+uint8_t Probe::_count = 0;
+
+void ProbeHistogram::add(uint32_t value)
+{
+    count++;
+    sum += value;
+    if (value < min)
+        min = value;
+    if (value > max)
+        max = value;
+
+    // Index of the highest set bit: 0-1 us -> 0, 2-3 us -> 1, 4-7 us -> 2, ...
+    uint8_t bucket = value > 1 ? 31 - __builtin_clz(value) : 0;
+    buckets[bucket < PROBE_BUCKET_CNT ? bucket : PROBE_BUCKET_CNT - 1]++;
+}
+
+uint32_t ProbeHistogram::getPercentile(uint8_t percent) const
+{
+    if (count < 1)
+        return 0;
+
+    uint64_t target = ((uint64_t)count * percent + 99) / 100;
+    uint64_t sum = 0;
+    for (uint8_t i = 0; i < PROBE_BUCKET_CNT - 1; i++)
+    {
+        sum += buckets[i];
+        if (sum >= target)
+            return getBucketLimit(i) < max ? getBucketLimit(i) : max;
+    }
+
+    return max;
+}
+
+Probe::Probe(const char *name, uint32_t periodUs)
+{
+    _stats.name = name;
+    _stats.period = periodUs;
+    if (_count < PROBE_MAX_CNT)
+    {
+        _probes[_count++] = this;
+    }
+}
+
+void Probe::begin()
+{
+    _start = PROBE_CLOCK();
+}
+
+void Probe::end()
+{
+    int64_t end = PROBE_CLOCK();
+    uint32_t exec = end - _start;
+    int64_t interval = _lastStart < 0 ? -1 : _start - _lastStart;
+    _lastStart = _start;
+
+    portENTER_CRITICAL(&_mux);
+    _stats.exec.add(exec);
+    if (interval >= 0)
+    {
+        int64_t jitter = _stats.period > 0 ? interval - _stats.period : interval;
+        _stats.jitter.add(jitter < 0 ? -jitter : jitter);
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+ProbeStats Probe::getStats() const
+{
+    portENTER_CRITICAL(&_mux);
+    ProbeStats stats = _stats;
+    portEXIT_CRITICAL(&_mux);
+    return stats;
+}
+
+void Probe::reset()
+{
+    portENTER_CRITICAL(&_mux);
+    _stats.exec = ProbeHistogram();
+    _stats.jitter = ProbeHistogram();
+    portEXIT_CRITICAL(&_mux);
+}
@@ -0,0 +1,62 @@
+#define LOG_LEVEL NONE
+
+#include <Arduino.h>
+#include <esp_system.h>
+#include "RetryScheduler.h"
+#include "SerialLogging.h"
+
+void RetryScheduler::schedule(uint32_t now, uint32_t delay)
+{
+    _lastTime = now;
+    _stats.delay = delay;
+    _skipping = false;
+}
+
+void RetryScheduler::skip()
+{
+    if (!_skipping)
+    {
+        _skipping = true;
+        _stats.skipped++;
+    }
+}
+
+void RetryScheduler::attempt()
+{
+    _skipping = false;
+    _stats.attempts++;
+}
+
+void RetryScheduler::succeeded(uint32_t now)
+{
+    _stats.successes++;
+    _stats.consecutiveFailures = 0;
+    schedule(now, _interval);
+}
+
+void RetryScheduler::failed(uint32_t now)
+{
+    _stats.failures++;
+
+    // Capped exponential backoff: min, 2 * min, 4 * min, ... max
+    uint32_t delay = _retryMax;
+    if (_stats.consecutiveFailures < 31 && (_retryMin << _stats.consecutiveFailures) >> _stats.consecutiveFailures == _retryMin)
+    {
+        delay = _retryMin << _stats.consecutiveFailures;
+        if (delay > _retryMax)
+            delay = _retryMax;
+    }
+
+    if (_stats.consecutiveFailures < UINT8_MAX)
+        _stats.consecutiveFailures++;
+
+    // Random reduction by up to the jitter percentage
+    uint32_t jitter = (uint64_t)delay * _jitterPercent / 100;
+    if (jitter > 0)
+        delay -= esp_random() % (jitter + 1);
+
+#ifdef LOG_DEBUG
+    LOG_DEBUG(F("RetryScheduler"), F("failed"), F("Failure {}, retry in {} ms"), _stats.consecutiveFailures, delay);
+#endif
+    schedule(now, delay);
+}
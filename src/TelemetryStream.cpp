@@ -0,0 +1,147 @@
+#define LOG_LEVEL NONE
+
+#include <Arduino.h>
+#include "TelemetryStream.h"
+#include "SerialLogging.h"
+
+TelemetryStream::TelemetryStream(AsyncWebServer *server, const char *url) : _ws(url)
+{
+    _ws.onEvent(
+        [this](AsyncWebSocket *ws, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len)
+        {
+            onEvent(client, type, arg, data, len);
+        });
+    server->addHandler(&_ws);
+}
+
+void TelemetryStream::onEvent(AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len)
+{
+    switch (type)
+    {
+    case WS_EVT_CONNECT:
+    {
+        bool added = false;
+        portENTER_CRITICAL(&_mux);
+        if (_clientCnt < TELEMETRY_STREAM_CLIENT_CNT)
+        {
+            auto &entry = _clients[_clientCnt++];
+            entry.id = client->id();
+            entry.period = 1000 / TELEMETRY_RATE_DEFAULT;
+            entry.next = millis();
+            added = true;
+        }
+        portEXIT_CRITICAL(&_mux);
+
+        if (!added)
+        {
+#ifdef LOG_WARNING
+            LOG_WARNING(F("TelemetryStream"), F("onEvent"), F("Client {} rejected, maximum amount of clients reached"), client->id());
+#endif
+            client->close();
+        }
+        break;
+    }
+    case WS_EVT_DISCONNECT:
+        portENTER_CRITICAL(&_mux);
+        for (uint8_t i = 0; i < _clientCnt; i++)
+        {
+            if (_clients[i].id == client->id())
+            {
+                _clients[i] = _clients[--_clientCnt];
+                break;
+            }
+        }
+        portEXIT_CRITICAL(&_mux);
+        break;
+    case WS_EVT_DATA:
+    {
+        // Only short single frame text messages are expected (the rate)
+        auto info = static_cast<AwsFrameInfo *>(arg);
+        if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT)
+        {
+            setRate(client->id(), data, len);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void TelemetryStream::setRate(uint32_t id, const uint8_t *data, size_t len)
+{
+    uint32_t rate = 0;
+    for (size_t i = 0; i < len && i < 4 && isdigit(data[i]); i++)
+    {
+        rate = rate * 10 + (data[i] - '0');
+    }
+
+    if (rate < 1)
+        rate = 1;
+    if (rate > TELEMETRY_RATE_MAX)
+        rate = TELEMETRY_RATE_MAX;
+
+    portENTER_CRITICAL(&_mux);
+    for (uint8_t i = 0; i < _clientCnt; i++)
+    {
+        if (_clients[i].id == id)
+        {
+            _clients[i].period = 1000 / rate;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+#ifdef LOG_DEBUG
+    LOG_DEBUG(F("TelemetryStream"), F("setRate"), F("Client {} rate set to {} frames/s"), id, rate);
+#endif
+}
+
+void TelemetryStream::send(const TelemetryFrame &frame)
+{
+    uint32_t due[TELEMETRY_STREAM_CLIENT_CNT];
+    uint8_t dueCnt = 0;
+    uint32_t now = millis();
+    portENTER_CRITICAL(&_mux);
+    for (uint8_t i = 0; i < _clientCnt; i++)
+    {
+        auto &client = _clients[i];
+        if ((int32_t)(now - client.next) < 0)
+            continue;
+
+        // Fixed rate, a client that has fallen behind continues from now instead of catching up
+        client.next += client.period;
+        if ((int32_t)(now - client.next) >= 0)
+            client.next = now + client.period;
+        due[dueCnt++] = client.id;
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    uint32_t sent = 0;
+    uint32_t dropped = 0;
+    for (uint8_t i = 0; i < dueCnt; i++)
+    {
+        if (_ws.availableForWrite(due[i]))
+        {
+            _ws.binary(due[i], (uint8_t *)&frame, sizeof(frame));
+            sent++;
+        }
+        else
+        {
+            dropped++;
+        }
+    }
+
+    portENTER_CRITICAL(&_mux);
+    _stats.sent += sent;
+    _stats.dropped += dropped;
+    portEXIT_CRITICAL(&_mux);
+}
+
+TelemetryStreamStats TelemetryStream::getStats() const
+{
+    portENTER_CRITICAL(&_mux);
+    TelemetryStreamStats stats = _stats;
+    stats.clients = _clientCnt;
+    portEXIT_CRITICAL(&_mux);
+    return stats;
+}
@@ -1,29 +1,81 @@
 #include <math.h>
+#include <stdint.h>
+#include <algorithm>
 #include "ThermistorCalc.h"
 
 ThermistorCalc::ThermistorCalc(int cLow, int rLow, int cMid, int rMid, int cHigh, int rHigh)
 {
-    double lnR1 = log(rLow);
-    double k1 = celsiusToKelvin(cLow);
-    double lnR2 = log(rMid);
-    double k2 = celsiusToKelvin(cMid);
-    double lnR3 = log(rHigh);
-    double k3 = celsiusToKelvin(cHigh);
-    double lnR1R2 = lnR1 - lnR2;
-    double lnR1R3 = lnR1 - lnR3;
-    double denominatorK1K2 = (1 / k1) - (1 / k2);
-    double denominatorK1K3 = (1 / k1) - (1 / k3);
+    auto coefficients = ThermistorMath::coefficients(cLow, rLow, cMid, rMid, cHigh, rHigh);
+    _coefficientA = coefficients.a;
+    _coefficientB = coefficients.b;
+    _coefficientC = coefficients.c;
+}
+
+ThermistorCalc::~ThermistorCalc()
+{
+    if (_tableOwned)
+    {
+        delete[] _table;
+    }
+}
+
+void ThermistorCalc::enableLookupTable()
+{
+    if (_table != nullptr)
+    {
+        return;
+    }
+
+    auto table = new float[THERMISTOR_TABLE_SIZE];
+    for (size_t i = 0; i < THERMISTOR_TABLE_SIZE; i++)
+    {
+        table[i] = exactResistanceFromKelvin(celsiusToKelvin(THERMISTOR_TABLE_MIN_CELSIUS + (int)i * THERMISTOR_TABLE_STEP_CELSIUS));
+    }
+
+    _table = table;
+    _tableOwned = true;
 
-    double lnR1Pow3 = pow(lnR1, 3);
-    double lnR2Pow3 = pow(lnR2, 3);
-    double lnR3Pow3 = pow(lnR3, 3);
+    // Measure the interpolation error between the table points (linear in both directions, so one check covers both)
+    float maxError = 0;
+    for (size_t i = 0; i < THERMISTOR_TABLE_SIZE - 1; i++)
+    {
+        for (uint8_t fraction = 1; fraction < 4; fraction++)
+        {
+            float celsius = THERMISTOR_TABLE_MIN_CELSIUS + (i + fraction / 4.0f) * THERMISTOR_TABLE_STEP_CELSIUS;
+            float resistance = tableResistanceFromCelsius(celsius);
+            maxError = fmaxf(maxError, fabsf(kelvinToCelsius(exactKelvinFromResistance(resistance)) - celsius));
+        }
+    }
 
-    _coefficientC = (denominatorK1K2 - lnR1R2 * denominatorK1K3 / lnR1R3) / ((lnR1Pow3 - lnR2Pow3) - lnR1R2 * (lnR1Pow3 - lnR3Pow3) / lnR1R3);
-    _coefficientB = (denominatorK1K2 - _coefficientC * (lnR1Pow3 - lnR2Pow3)) / lnR1R2;
-    _coefficientA = 1 / k1 - _coefficientC * lnR1Pow3 - _coefficientB * lnR1;
+    _tableMaxError = maxError;
 }
 
-const double ThermistorCalc::resistanceFromKelvin(double kelvin)
+const float ThermistorCalc::tableResistanceFromCelsius(float celsius)
+{
+    float position = (celsius - THERMISTOR_TABLE_MIN_CELSIUS) / THERMISTOR_TABLE_STEP_CELSIUS;
+    size_t index = std::min((size_t)position, THERMISTOR_TABLE_SIZE - 2);
+    return _table[index] + (_table[index + 1] - _table[index]) * (position - index);
+}
+
+const float ThermistorCalc::tableCelsiusFromResistance(float resistance)
+{
+    // Binary search for the interval table[low] >= resistance >= table[low + 1] (descending table)
+    size_t low = 0;
+    size_t high = THERMISTOR_TABLE_SIZE - 1;
+    while (high - low > 1)
+    {
+        size_t mid = (low + high) / 2;
+        if (_table[mid] >= resistance)
+            low = mid;
+        else
+            high = mid;
+    }
+
+    float fraction = (_table[low] - resistance) / (_table[low] - _table[high]);
+    return THERMISTOR_TABLE_MIN_CELSIUS + (low + fraction) * THERMISTOR_TABLE_STEP_CELSIUS;
+}
+
+const double ThermistorCalc::exactResistanceFromKelvin(double kelvin)
 {
     double alpha = (_coefficientA - (1 / kelvin)) / _coefficientC;
     double beta = sqrt(pow((_coefficientB / (3 * _coefficientC)), 3) + (pow(alpha, 2)) / 4);
@@ -31,20 +83,40 @@ const double ThermistorCalc::resistanceFromKelvin(double kelvin)
     return exp(pow(beta - (alpha / 2), oneThird) - pow(beta + (alpha / 2), oneThird));
 }
 
+const double ThermistorCalc::exactKelvinFromResistance(double resistance)
+{
+    double lnR = log(resistance);
+    return 1 / (_coefficientA + _coefficientB * lnR + _coefficientC * pow(lnR, 3));
+}
+
+const double ThermistorCalc::resistanceFromKelvin(double kelvin)
+{
+    return resistanceFromCelsius(kelvinToCelsius(kelvin));
+}
+
 const double ThermistorCalc::resistanceFromCelsius(double celsius)
 {
-    return resistanceFromKelvin(celsiusToKelvin(celsius));
+    if (_table != nullptr && celsius >= THERMISTOR_TABLE_MIN_CELSIUS && celsius <= THERMISTOR_TABLE_MAX_CELSIUS)
+    {
+        return tableResistanceFromCelsius(celsius);
+    }
+
+    return exactResistanceFromKelvin(celsiusToKelvin(celsius));
 }
 
 const double ThermistorCalc::kelvinFromResistance(double resistance)
 {
-    double lnR = log(resistance);
-    return 1 / (_coefficientA + _coefficientB * lnR + _coefficientC * pow(lnR, 3));
+    return celsiusToKelvin(celsiusFromResistance(resistance));
 }
 
 const double ThermistorCalc::celsiusFromResistance(double resistance)
 {
-    return kelvinToCelsius(kelvinFromResistance(resistance));
+    if (_table != nullptr && resistance <= _table[0] && resistance >= _table[THERMISTOR_TABLE_SIZE - 1])
+    {
+        return tableCelsiusFromResistance(resistance);
+    }
+
+    return kelvinToCelsius(exactKelvinFromResistance(resistance));
 }
 
 const double ThermistorCalc::celsiusToKelvin(double celsius)
@@ -0,0 +1,83 @@
+#define LOG_LEVEL NONE
+
+#include <esp_attr.h>
+#include <esp_rom_crc.h>
+#include "WeatherCache.h"
+#include "SerialLogging.h"
+
+#define WEATHER_CACHE_MAGIC 0x57434301 // "WCC" + version, change the version if the layout changes
+
+/// @brief Layout of the cache inside the RTC memory
+struct WeatherCacheData
+{
+    uint32_t magic;
+    time_t savedAt;
+    WeatherPoint current;
+    WeatherPoint forecast[WEATHER_FORECAST_SIZE];
+    uint8_t forecastCount;
+    char timestamp[9];
+    uint32_t crc;
+};
+
+RTC_NOINIT_ATTR static WeatherCacheData _cache;
+
+static uint32_t cacheCrc()
+{
+    return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t *>(&_cache), offsetof(WeatherCacheData, crc));
+}
+
+void WeatherCache::store(const WeatherSeries &series, const String &timestamp, const time_t now)
+{
+    memset(&_cache, 0, sizeof(_cache));
+    _cache.magic = WEATHER_CACHE_MAGIC;
+    _cache.savedAt = now;
+    _cache.current = series.getCurrent();
+    _cache.forecastCount = series.getForecastCount();
+    memcpy(_cache.forecast, series.getForecast(), _cache.forecastCount * sizeof(WeatherPoint));
+    strlcpy(_cache.timestamp, timestamp.c_str(), sizeof(_cache.timestamp));
+    _cache.crc = cacheCrc();
+}
+
+static bool isValid()
+{
+    return _cache.magic == WEATHER_CACHE_MAGIC && _cache.crc == cacheCrc() && _cache.forecastCount <= WEATHER_FORECAST_SIZE;
+}
+
+time_t WeatherCache::getSavedAt()
+{
+    return isValid() ? _cache.savedAt : 0;
+}
+
+bool WeatherCache::load(WeatherSeries &series, String &timestamp, const time_t now, const uint32_t maxAge)
+{
+    if (!isValid())
+    {
+#ifdef LOG_DEBUG
+        LOG_DEBUG(F("WeatherCache"), F("load"), F("No valid cache"));
+#endif
+        return false;
+    }
+
+    time_t age = now - _cache.current.time;
+    if (age < 0 || age > (time_t)maxAge)
+    {
+#ifdef LOG_DEBUG
+        LOG_DEBUG(F("WeatherCache"), F("load"), F("Cache outdated, age = {} s"), (long)age);
+#endif
+        return false;
+    }
+
+    series.setCurrent(_cache.current.time, _cache.current.temperature);
+    series.setForecast(_cache.forecast, _cache.forecastCount);
+    _cache.timestamp[sizeof(_cache.timestamp) - 1] = '\0';
+    timestamp = _cache.timestamp;
+#ifdef LOG_INFO
+    LOG_INFO(F("WeatherCache"), F("load"), F("Loaded {} °C, age = {} s"), _cache.current.temperature, (long)age);
+#endif
+    return true;
+}
+
+void WeatherCache::clear()
+{
+    _cache.magic = 0;
+}
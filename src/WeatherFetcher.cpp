@@ -0,0 +1,88 @@
+#define LOG_LEVEL NONE
+
+#include <Arduino.h>
+#include "WeatherFetcher.h"
+#include "SerialLogging.h"
+
+bool WeatherFetcher::begin()
+{
+    if (_task)
+    {
+        return true;
+    }
+
+    if (xTaskCreatePinnedToCore(taskLoop, "WeatherFetcher", WEATHER_FETCHER_STACK_SIZE, this, WEATHER_FETCHER_PRIORITY, &_task, WEATHER_FETCHER_CORE) != pdPASS)
+    {
+        _task = nullptr;
+#ifdef LOG_ERROR
+        LOG_ERROR(F("WeatherFetcher"), F("begin"), F("Failed to create task"));
+#endif
+        return false;
+    }
+
+    return true;
+}
+
+bool WeatherFetcher::trigger(bool includeForecast)
+{
+    if (!_task || _busy.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    _forecast.store(includeForecast, std::memory_order_relaxed);
+    _busy.store(true, std::memory_order_release);
+    xTaskNotifyGive(_task);
+    return true;
+}
+
+bool WeatherFetcher::poll(WeatherResult &result)
+{
+    if (!_ready.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    result = _result;
+    _ready.store(false, std::memory_order_relaxed);
+    _busy.store(false, std::memory_order_release);
+    return true;
+}
+
+WeatherResult WeatherFetcher::toResult(const ApiResponse &response)
+{
+    WeatherResult result = {};
+    result.successful = response.successful;
+    result.error = response.error;
+    result.httpCode = response.httpCode;
+    result.temperature = response.temperature;
+    strlcpy(result.timestamp, response.timestamp.c_str(), sizeof(result.timestamp));
+    result.time = response.time;
+    result.serverTime = response.serverTime;
+    result.stats = response.stats;
+    result.forecastRequested = false;
+    return result;
+}
+
+void WeatherFetcher::taskLoop(void *parameter)
+{
+    auto fetcher = static_cast<WeatherFetcher *>(parameter);
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        auto response = fetcher->_api->request();
+        fetcher->_result = toResult(response);
+        if (fetcher->_forecast.load(std::memory_order_relaxed))
+        {
+            // Uses the connection that has been kept open by the request above
+            fetcher->_result.forecastRequested = true;
+            fetcher->_result.forecast = fetcher->_api->requestForecast();
+        }
+#ifdef LOG_DEBUG
+        LOG_DEBUG(F("WeatherFetcher"), F("taskLoop"), F("Request completed in {} ms"), fetcher->_result.stats.duration);
+#endif
+        // Publish the result, the main loop takes it via poll()
+        fetcher->_ready.store(true, std::memory_order_release);
+    }
+}
@@ -0,0 +1,47 @@
+#define LOG_LEVEL NONE
+
+#include <math.h>
+#include "WeatherSeries.h"
+
+void WeatherSeries::setForecast(const WeatherPoint *points, uint8_t count)
+{
+    _forecastCount = count < WEATHER_FORECAST_SIZE ? count : WEATHER_FORECAST_SIZE;
+    for (uint8_t i = 0; i < _forecastCount; i++)
+    {
+        _forecast[i] = points[i];
+    }
+}
+
+float WeatherSeries::interpolate(const time_t time) const
+{
+    if (_current.time <= 0)
+    {
+        return NAN;
+    }
+
+    // Forecast points before the current weather are outdated and skipped
+    WeatherPoint previous = _current;
+    for (uint8_t i = 0; i < _forecastCount; i++)
+    {
+        const WeatherPoint &next = _forecast[i];
+        if (next.time <= previous.time)
+        {
+            continue;
+        }
+
+        if (time <= previous.time)
+        {
+            return previous.temperature;
+        }
+
+        if (time < next.time)
+        {
+            float factor = (float)(time - previous.time) / (float)(next.time - previous.time);
+            return previous.temperature + (next.temperature - previous.temperature) * factor;
+        }
+
+        previous = next;
+    }
+
+    return previous.temperature;
+}
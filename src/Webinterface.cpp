@@ -6,8 +6,12 @@
 #include <dataIndexHTML.h>
 #include <Update.h>
 #include <esp_arduino_version.h>
+#include <memory>
 #include "Webinterface.h"
 #include "WiFiModeChamp.h"
+#include "BootSequence.h"
+#include "Probe.h"
+#include "TelemetryStream.h"
 #include "SerialLogging.h"
 
 /*
@@ -16,6 +20,55 @@
 ##############################################
 */
 
+/// @brief Prints a probe histogram as JSON object
+static void printProbeHistogram(Print &out, const ProbeHistogram &histogram)
+{
+    out.printf("{\"count\":%u,\"min\":%u,\"avg\":%u,\"max\":%u,\"p50\":%u,\"p99\":%u,\"buckets\":[",
+               histogram.count, histogram.getMin(), histogram.getAverage(), histogram.max, histogram.getPercentile(50), histogram.getPercentile(99));
+    for (uint8_t i = 0; i < PROBE_BUCKET_CNT; i++)
+    {
+        if (i > 0)
+            out.print(",");
+        out.print(histogram.buckets[i]);
+    }
+    out.print("]}");
+}
+
+/// @brief FNV-1a hash of a string, used to detect unchanged label texts
+static uint32_t hashText(const char *text, uint32_t hash = 2166136261UL)
+{
+    for (; *text; text++)
+        hash = (hash ^ (uint8_t)*text) * 16777619UL;
+    return hash;
+}
+
+/// @brief Appends formatted text to a buffer, the buffer is truncated if it is too small
+/// @param pos current length of the text inside the buffer, updated by the appended length
+static void appendText(char *buffer, size_t size, size_t &pos, const char *format, ...)
+{
+    if (pos + 1 >= size)
+        return;
+
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(buffer + pos, size - pos, format, args);
+    va_end(args);
+    if (written > 0)
+        pos += (size_t)written < size - pos ? written : size - pos - 1;
+}
+
+/// @brief Appends a float as JSON value to a buffer (null if NAN)
+/// @param name name of the value or nullptr for an array element
+static void appendJsonFloat(char *buffer, size_t size, size_t &pos, const char *name, float value, uint8_t decimals = 2)
+{
+    if (name)
+        appendText(buffer, size, pos, "\"%s\":", name);
+    if (isnanf(value))
+        appendText(buffer, size, pos, "null");
+    else
+        appendText(buffer, size, pos, "%.*f", decimals, value);
+}
+
 Webinterface::Webinterface(uint16_t port, Config *config) : _config(config)
 {
 #ifdef LOG_DEBUG
@@ -28,7 +81,8 @@ Webinterface::Webinterface(uint16_t port, Config *config) : _config(config)
 
     _lblSensorTemp = ESPUI.addControl(ControlType::Label, emptyString.c_str(), String(NAN) + " °C", ControlColor::None, inputTempGrp);
     ESPUI.setElementStyle(_lblSensorTemp, STYLE_LBL_INOUT);
-    ESPUI.setElementStyle(ESPUI.addControl(ControlType::Label, emptyString.c_str(), "Sensor", ControlColor::None, inputTempGrp), STYLE_LBL_INOUT_VALUE_OUTPUT);
+    _lblSensorTempInfo = ESPUI.addControl(ControlType::Label, emptyString.c_str(), "Sensor", ControlColor::None, inputTempGrp);
+    ESPUI.setElementStyle(_lblSensorTempInfo, STYLE_LBL_INOUT_VALUE_OUTPUT);
 
     _lblWeatherTemp = ESPUI.addControl(ControlType::Label, "Weather API", String(NAN) + " °C", ControlColor::None, inputTempGrp);
     ESPUI.setElementStyle(_lblWeatherTemp, STYLE_LBL_API);
@@ -68,7 +122,8 @@ Webinterface::Webinterface(uint16_t port, Config *config) : _config(config)
 
     _lblTempOutput = ESPUI.addControl(ControlType::Label, emptyString.c_str(), String(NAN) + " °C", ControlColor::None, outputTempGrp);
     ESPUI.setElementStyle(_lblTempOutput, STYLE_LBL_INOUT);
-    ESPUI.setElementStyle(ESPUI.addControl(ControlType::Label, emptyString.c_str(), "Actual", ControlColor::None, outputTempGrp), STYLE_LBL_INOUT_VALUE_OUTPUT);
+    _lblTempOutputInfo = ESPUI.addControl(ControlType::Label, emptyString.c_str(), "Actual", ControlColor::None, outputTempGrp);
+    ESPUI.setElementStyle(_lblTempOutputInfo, STYLE_LBL_INOUT_VALUE_OUTPUT);
 
     _lblTempTarget = ESPUI.addControl(ControlType::Label, emptyString.c_str(), String(NAN) + " °C", ControlColor::None, outputTempGrp);
     ESPUI.setElementStyle(_lblTempTarget, STYLE_LBL_INOUT);
@@ -158,6 +213,262 @@ Webinterface::Webinterface(uint16_t port, Config *config) : _config(config)
             request->send(response);
         });
 
+    // Probes as JSON, all times in us, bucket i counts values below 2^(i+1) us
+    ESPUI.server->on(
+        "/api/probes", HTTP_GET,
+        [](AsyncWebServerRequest *request)
+        {
+            AsyncResponseStream *response = request->beginResponseStream("application/json");
+            response->print("{\"probes\":[");
+            for (uint8_t i = 0; i < Probe::getCount(); i++)
+            {
+                auto stats = Probe::get(i)->getStats();
+                if (i > 0)
+                    response->print(",");
+                response->printf("{\"name\":\"%s\",\"period\":%u,\"exec\":", stats.name, stats.period);
+                printProbeHistogram(*response, stats.exec);
+                response->print(",\"jitter\":");
+                printProbeHistogram(*response, stats.jitter);
+                response->print("}");
+            }
+            response->print("]}");
+            request->send(response);
+        });
+
+#if DEFERRED_LOG_ENABLED
+    // Latest records of the deferred log as plain text
+    ESPUI.server->on(
+        "/log", HTTP_GET,
+        [](AsyncWebServerRequest *request)
+        {
+            AsyncResponseStream *response = request->beginResponseStream("text/plain; charset=utf-8");
+            DeferredLogRecord record;
+            char line[DEFERRED_LOG_LINE_SIZE];
+            uint32_t position = 0;
+            while (DeferredLog.read(position, record))
+            {
+                record.format(line, sizeof(line), true);
+                response->println(line);
+            }
+            request->send(response);
+        });
+#endif
+
+    // Live values as binary frames (TelemetryFrame) with a client selected rate, independent of the ESPUI websocket
+    _telemetryStream = new TelemetryStream(ESPUI.server, "/telemetry");
+
+    // Live values and health counters as fixed schema JSON for pollers (e.g. home automation), temperatures in °C (null if not available)
+    ESPUI.server->on(
+        "/api/telemetry", HTTP_GET,
+        [this](AsyncWebServerRequest *request)
+        {
+            char json[WEBINTERFACE_TELEMETRY_SIZE];
+            formatTelemetry(json, sizeof(json));
+            AsyncWebServerResponse *response = request->beginResponse(200, "application/json", json);
+            response->addHeader("Cache-Control", "no-store");
+            request->send(response);
+        });
+
+    // History of a tier as chunked JSON (/api/history?tier=0..2), read entry by entry from the ring while the response is sent.
+    // Rows: [time since boot in s, input min, max, mean, output min, max, mean] in °C (null if there was no value)
+    ESPUI.server->on(
+        "/api/history", HTTP_GET,
+        [this](AsyncWebServerRequest *request)
+        {
+            const HistoryStore *history = _history;
+            uint8_t tier = request->hasParam("tier") ? request->getParam("tier")->value().toInt() : 1;
+            uint32_t first, last;
+            if (!history || tier >= HISTORY_TIER_CNT || !history->getRange(tier, first, last))
+            {
+                request->send(404, "application/json", "{}");
+                return;
+            }
+
+            // State of the response: 0 = header, 1 = rows, 2 = footer, 3 = completed
+            uint8_t state = 0;
+            uint32_t slot = first;
+            bool firstRow = true;
+            AsyncWebServerResponse *response = request->beginChunkedResponse(
+                "application/json",
+                [history, tier, state, slot, last, firstRow](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t
+                {
+                    char row[160];
+                    size_t written = 0;
+                    while (state < 3)
+                    {
+                        size_t pos = 0;
+                        HistoryEntry entry;
+                        if (state == 0)
+                        {
+                            appendText(row, sizeof(row), pos, "{\"tier\":%u,\"period\":%u,\"count\":%u,\"footprint\":%u,\"channels\":[\"input\",\"output\"],\"rows\":[",
+                                       tier, history->getPeriod(tier), history->getCount(tier), HISTORY_FOOTPRINT);
+                        }
+                        else if (state == 2)
+                        {
+                            appendText(row, sizeof(row), pos, "]}");
+                        }
+                        else if (slot > last)
+                        {
+                            state = 2;
+                            continue;
+                        }
+                        else if (!history->read(tier, slot, entry))
+                        {
+                            // Overwritten by the ring meanwhile, continue with the oldest entry
+                            uint32_t first, newest;
+                            history->getRange(tier, first, newest);
+                            slot = slot < first ? first : last + 1;
+                            continue;
+                        }
+                        else
+                        {
+                            appendText(row, sizeof(row), pos, firstRow ? "[%u" : ",[%u", slot * history->getPeriod(tier));
+                            for (uint8_t c = 0; c < HISTORY_CHANNEL_CNT; c++)
+                            {
+                                appendText(row, sizeof(row), pos, ",");
+                                appendJsonFloat(row, sizeof(row), pos, nullptr, HistoryStore::toFloat(entry.min[c]));
+                                appendText(row, sizeof(row), pos, ",");
+                                appendJsonFloat(row, sizeof(row), pos, nullptr, HistoryStore::toFloat(entry.max[c]));
+                                appendText(row, sizeof(row), pos, ",");
+                                appendJsonFloat(row, sizeof(row), pos, nullptr, HistoryStore::toFloat(entry.mean[c]));
+                            }
+                            appendText(row, sizeof(row), pos, "]");
+                        }
+
+                        if (written + pos > maxLen)
+                            break;
+
+                        memcpy(buffer + written, row, pos);
+                        written += pos;
+                        if (state == 1)
+                        {
+                            firstRow = false;
+                            slot++;
+                        }
+                        else
+                        {
+                            state++;
+                        }
+                    }
+
+                    // Nothing fits into the TCP window yet, 0 would end the response
+                    return written > 0 || state == 3 ? written : RESPONSE_TRY_AGAIN;
+                });
+            response->addHeader("Cache-Control", "no-store");
+            request->send(response);
+        });
+
+    // History log of a time range as chunked CSV or JSON (/api/history-log?from=&to=&format=csv|json, epoch unix in seconds),
+    // read record by record from the segment files while the response is sent.
+    // Rows: time, input min, max, mean, output min, max, mean in °C (empty/null if there was no value)
+    ESPUI.server->on(
+        "/api/history-log", HTTP_GET,
+        [this](AsyncWebServerRequest *request)
+        {
+            const HistoryLog *historyLog = _historyLog;
+            uint32_t first, last;
+            if (!historyLog || !historyLog->getSegments(first, last))
+            {
+                request->send(404, "text/plain", "No history log available");
+                return;
+            }
+
+            time_t to = request->hasParam("to") ? strtoul(request->getParam("to")->value().c_str(), nullptr, 10) : time(nullptr);
+            time_t from = request->hasParam("from") ? strtoul(request->getParam("from")->value().c_str(), nullptr, 10) : to - 86400;
+            bool csv = !request->hasParam("format") || request->getParam("format")->value() != "json";
+            auto reader = std::make_shared<HistoryLogReader>(historyLog, from, to);
+
+            // State of the response: 0 = header, 1 = rows, 2 = footer, 3 = completed
+            uint8_t state = 0;
+            bool pending = false;
+            bool firstRow = true;
+            HistoryLogRecord record;
+            AsyncWebServerResponse *response = request->beginChunkedResponse(
+                csv ? "text/csv" : "application/json",
+                [reader, csv, from, to, state, pending, firstRow, record](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t
+                {
+                    char row[160];
+                    size_t written = 0;
+                    while (state < 3)
+                    {
+                        size_t pos = 0;
+                        if (state == 0)
+                        {
+                            if (csv)
+                                appendText(row, sizeof(row), pos, "time,input_min,input_max,input_mean,output_min,output_max,output_mean\n");
+                            else
+                                appendText(row, sizeof(row), pos, "{\"from\":%ld,\"to\":%ld,\"period\":60,\"channels\":[\"input\",\"output\"],\"rows\":[", (long)from, (long)to);
+                        }
+                        else if (state == 2)
+                        {
+                            if (!csv)
+                                appendText(row, sizeof(row), pos, "]}");
+                        }
+                        else if (!pending && !reader->next(record))
+                        {
+                            state = 2;
+                            continue;
+                        }
+                        else if (csv)
+                        {
+                            // The record is kept until it fits into the buffer
+                            pending = true;
+                            struct tm timeInfo;
+                            time_t time = record.time;
+                            gmtime_r(&time, &timeInfo);
+                            pos = strftime(row, sizeof(row), "%Y-%m-%dT%H:%M:%SZ", &timeInfo);
+                            for (uint8_t c = 0; c < HISTORY_CHANNEL_CNT; c++)
+                            {
+                                int16_t values[] = {record.entry.min[c], record.entry.max[c], record.entry.mean[c]};
+                                for (auto value : values)
+                                {
+                                    if (value == HISTORY_NO_VALUE)
+                                        appendText(row, sizeof(row), pos, ",");
+                                    else
+                                        appendText(row, sizeof(row), pos, ",%.2f", HistoryStore::toFloat(value));
+                                }
+                            }
+                            appendText(row, sizeof(row), pos, "\n");
+                        }
+                        else
+                        {
+                            pending = true;
+                            appendText(row, sizeof(row), pos, firstRow ? "[%u" : ",[%u", record.time);
+                            for (uint8_t c = 0; c < HISTORY_CHANNEL_CNT; c++)
+                            {
+                                appendText(row, sizeof(row), pos, ",");
+                                appendJsonFloat(row, sizeof(row), pos, nullptr, HistoryStore::toFloat(record.entry.min[c]));
+                                appendText(row, sizeof(row), pos, ",");
+                                appendJsonFloat(row, sizeof(row), pos, nullptr, HistoryStore::toFloat(record.entry.max[c]));
+                                appendText(row, sizeof(row), pos, ",");
+                                appendJsonFloat(row, sizeof(row), pos, nullptr, HistoryStore::toFloat(record.entry.mean[c]));
+                            }
+                            appendText(row, sizeof(row), pos, "]");
+                        }
+
+                        if (written + pos > maxLen)
+                            break;
+
+                        memcpy(buffer + written, row, pos);
+                        written += pos;
+                        if (state == 1)
+                        {
+                            firstRow = false;
+                            pending = false;
+                        }
+                        else
+                        {
+                            state++;
+                        }
+                    }
+
+                    // Nothing fits into the TCP window yet, 0 would end the response
+                    return written > 0 || state == 3 ? written : RESPONSE_TRY_AGAIN;
+                });
+            response->addHeader("Cache-Control", "no-store");
+            request->send(response);
+        });
+
     // NOTE: Control is added inside SystemTab! The callback needs to be added after the webserver has been started.
     //ESPUI.WebServer()->on(
     ESPUI.server->on(
@@ -201,38 +512,208 @@ Webinterface::Webinterface(uint16_t port, Config *config) : _config(config)
 
 bool Webinterface::getClientIsConnected() { return ESPUI.ws->count() > 0; }
 
-void Webinterface::setSensorTemp(const float temperature)
+void Webinterface::updateSystemInformation()
+{
+    if (!getClientIsConnected() || !ESPUI.ws->availableForWriteAll())
+    {
+        return;
+    }
+
+    _systemInfoTab->setFrameStats(_frameStats);
+    _systemInfoTab->setStreamStats(_telemetryStream->getStats());
+    if (_historyLog)
+        _systemInfoTab->setHistoryLogStats(_historyLog->getStats());
+    _systemInfoTab->setConfigStoreStats(_config->store->getStats());
+    _systemInfoTab->update();
+}
+
+bool Webinterface::hasTelemetryClients() const { return _telemetryStream->hasClients(); }
+
+void Webinterface::streamTelemetry(const TelemetryFrame &frame) { _telemetryStream->send(frame); }
+
+void Webinterface::setLabel(uint16_t control, const char *format, ...)
 {
-    ESPUI.updateLabel(_lblSensorTemp, String(temperature) + " °C");
+    char text[WEBINTERFACE_LABEL_SIZE];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+
+    PendingLabel *label = nullptr;
+    for (uint8_t i = 0; i < _pendingLabelCnt && !label; i++)
+    {
+        if (_pendingLabels[i].control == control)
+            label = &_pendingLabels[i];
+    }
+
+    if (!label)
+    {
+        if (_pendingLabelCnt >= WEBINTERFACE_LABEL_CNT)
+        {
+            // No slot left, send it right away
+            ESPUI.updateLabel(control, text);
+            return;
+        }
+
+        label = &_pendingLabels[_pendingLabelCnt++];
+        label->control = control;
+    }
+    else if (strcmp(label->text, text) == 0)
+    {
+        return;
+    }
+
+    if (label->dirty)
+        _frameStats.coalesced++;
+    strlcpy(label->text, text, sizeof(label->text));
+    label->dirty = true;
+}
+
+void Webinterface::flush()
+{
+    if (_telemetryDirty)
+    {
+        _telemetry.store(_telemetryValues);
+        _telemetryDirty = false;
+    }
+
+    auto clients = ESPUI.ws->count();
+    if (clients > 0 && !ESPUI.ws->availableForWriteAll())
+    {
+        // Backpressure: keep the texts until the queue has been sent, newer texts replace them meanwhile
+        _frameStats.deferred++;
+        return;
+    }
+
+    uint32_t bytes = 0;
+    for (uint8_t n = 0; n < _pendingLabelCnt; n++)
+    {
+        uint8_t i = (_pendingLabelNext + n) % _pendingLabelCnt;
+        auto &label = _pendingLabels[i];
+        if (!label.dirty)
+            continue;
+
+        uint32_t size = strlen(label.text) + WEBINTERFACE_MESSAGE_OVERHEAD;
+        if (clients > 0 && bytes > 0 && bytes + size > WEBINTERFACE_FRAME_BUDGET)
+        {
+            // Budget used, the next frame starts with this label so all labels get their turn
+            _pendingLabelNext = i;
+            _frameStats.overBudget++;
+            break;
+        }
+
+        ESPUI.updateLabel(label.control, label.text);
+        label.dirty = false;
+        bytes += size;
+        _frameStats.updates++;
+    }
+
+    if (bytes > 0)
+    {
+        _frameStats.frames++;
+        if (clients > 0)
+            _frameStats.bytes += bytes;
+    }
+}
+
+size_t Webinterface::formatTelemetry(char *buffer, size_t size) const
+{
+    WebinterfaceTelemetry values;
+    _telemetry.load(values);
+    size_t pos = 0;
+    buffer[0] = '\0';
+    appendText(buffer, size, pos, "{\"uptime\":%llu,\"input\":{", esp_timer_get_time() / 1000000ULL);
+    appendJsonFloat(buffer, size, pos, "sensor", values.sensorTemperature);
+    appendText(buffer, size, pos, ",\"outliers\":%u,", values.sensorOutliersTotal);
+    appendJsonFloat(buffer, size, pos, "weather", values.weatherTemperature);
+    appendText(buffer, size, pos, ",\"weatherTime\":\"%s\"},\"output\":{", values.weatherTimestamp);
+    appendJsonFloat(buffer, size, pos, "target", values.targetTemperature);
+    appendText(buffer, size, pos, ",");
+    appendJsonFloat(buffer, size, pos, "actual", values.outputTemperature);
+    appendText(buffer, size, pos, ",\"step\":%u,", values.potiPosition);
+    appendJsonFloat(buffer, size, pos, "powerLimit", values.powerLimit, 0);
+    appendText(buffer, size, pos, "},\"health\":{\"heapFree\":%u,\"heapMaxAlloc\":%u,\"rssi\":%d,\"clients\":%u,"
+                                  "\"weatherApi\":{\"attempts\":%u,\"failures\":%u,\"consecutiveFailures\":%u},"
+                                  "\"controlOverruns\":%u,\"networkOverruns\":%u,\"logLost\":%u,\"uiDeferred\":%u}}",
+               ESP.getFreeHeap(), ESP.getMaxAllocHeap(), WiFi.isConnected() ? WiFi.RSSI() : 0, ESPUI.ws->count(),
+               values.weatherApiAttempts, values.weatherApiFailures, values.weatherApiConsecutiveFailures,
+               values.controlOverruns, values.networkOverruns, DeferredLog.getLostCount(), _frameStats.deferred);
+    return pos;
+}
+
+void Webinterface::setWeatherApiStats(const ApiRequestStats &stats, const RetrySchedulerStats &schedule)
+{
+    _systemInfoTab->setWeatherApiStats(stats, schedule);
+    _telemetryValues.weatherApiAttempts = schedule.attempts;
+    _telemetryValues.weatherApiFailures = schedule.failures;
+    _telemetryValues.weatherApiConsecutiveFailures = schedule.consecutiveFailures;
+    _telemetryDirty = true;
+}
+
+void Webinterface::setTaskStats(const PeriodicTaskStats &control, const PeriodicTaskStats &network)
+{
+    _systemInfoTab->setTaskStats(control, network);
+    if (control.overruns != _telemetryValues.controlOverruns || network.overruns != _telemetryValues.networkOverruns)
+    {
+        _telemetryValues.controlOverruns = control.overruns;
+        _telemetryValues.networkOverruns = network.overruns;
+        _telemetryDirty = true;
+    }
+}
+
+void Webinterface::setSensorTemp(const float temperature, const uint16_t outliers, const uint32_t outliersTotal)
+{
+    _telemetryValues.sensorTemperature = temperature;
+    _telemetryValues.sensorOutliersTotal = outliersTotal;
+    _telemetryDirty = true;
+    setLabel(_lblSensorTemp, "%.2f °C", temperature);
+    if (isnanf(temperature))
+        setLabel(_lblSensorTempInfo, "Sensor");
+    else
+        setLabel(_lblSensorTempInfo, "Sensor (%u outliers, %u total)", outliers, outliersTotal);
 }
 
 void Webinterface::setWeatherTemp(const float temperature, const String timestamp)
 {
+    _telemetryValues.weatherTemperature = temperature;
+    strlcpy(_telemetryValues.weatherTimestamp, timestamp.c_str(), sizeof(_telemetryValues.weatherTimestamp));
+    _telemetryDirty = true;
     if(!timestamp.isEmpty())
-        ESPUI.updateLabel(_lblWeatherTemp, String(temperature) + " °C (" + timestamp + ")");
+        setLabel(_lblWeatherTemp, "%.2f °C (%s)", temperature, timestamp.c_str());
     else
-        ESPUI.updateLabel(_lblWeatherTemp, String(temperature) + " °C");
+        setLabel(_lblWeatherTemp, "%.2f °C", temperature);
 }
 
-void Webinterface::setOutputTemp(const float temperature)
+void Webinterface::setOutputTemp(const float temperature, const uint16_t potiPosition, const float quantizationError)
 {
-    ESPUI.updateLabel(_lblTempOutput, String(temperature) + " °C");
+    _telemetryValues.outputTemperature = temperature;
+    _telemetryValues.potiPosition = potiPosition;
+    _telemetryDirty = true;
+    setLabel(_lblTempOutput, "%.2f °C", temperature);
+    if (isnanf(temperature))
+        setLabel(_lblTempOutputInfo, "Actual");
+    else
+        setLabel(_lblTempOutputInfo, "Actual (step %u, %.2f °C to target)", potiPosition, quantizationError);
 }
 
 void Webinterface::setTargetTemp(const float temperature)
 {
-    ESPUI.updateLabel(_lblTempTarget, String(temperature) + " °C");
+    _telemetryValues.targetTemperature = temperature;
+    _telemetryDirty = true;
+    setLabel(_lblTempTarget, "%.2f °C", temperature);
 }
 
 void Webinterface::setOuputPowerLimit(const float powerLimit)
 {
+    _telemetryValues.powerLimit = powerLimit;
+    _telemetryDirty = true;
     if (powerLimit < 10)
     {
-        ESPUI.updateLabel(_lblPowerOutput, "Inactive");
+        setLabel(_lblPowerOutput, "Inactive");
     }
     else
     {
-        ESPUI.updateLabel(_lblPowerOutput, String(powerLimit, 0) + " \%");
+        setLabel(_lblPowerOutput, "%.0f %%", powerLimit);
     }
 }
 
@@ -300,6 +781,28 @@ SystemInfoTab::SystemInfoTab()
     ESPUI.setElementStyle(lblOTA, "background-color: transparent; width: 100%;");
 
 
+#if DEFERRED_LOG_ENABLED
+    // Log group
+    _lblLog = ESPUI.addControl(ControlType::Label, "Log", emptyString, ControlColor::None, _tab);
+    ESPUI.setElementStyle(_lblLog, "background-color: unset; text-align-last: left;");
+#endif
+
+    // Boot sequence group
+    _lblBoot = ESPUI.addControl(ControlType::Label, "Boot", emptyString, ControlColor::None, _tab);
+    ESPUI.setElementStyle(_lblBoot, "background-color: unset; text-align-last: left;");
+
+    // Control and network task group
+    _lblControl = ESPUI.addControl(ControlType::Label, "Tasks", emptyString, ControlColor::None, _tab);
+    ESPUI.setElementStyle(_lblControl, "background-color: unset; text-align-last: left;");
+
+    // Probes group
+    _lblProbes = ESPUI.addControl(ControlType::Label, "Probes", emptyString, ControlColor::None, _tab);
+    ESPUI.setElementStyle(_lblProbes, "background-color: unset; text-align-last: left;");
+
+    // Weather API group
+    _lblWeatherApi = ESPUI.addControl(ControlType::Label, "Weather API", emptyString, ControlColor::None, _tab);
+    ESPUI.setElementStyle(_lblWeatherApi, "background-color: unset; text-align-last: left;");
+
     // Network info group
     _lblInfoTest = ESPUI.addControl(ControlType::Label, "Network Info", emptyString, ControlColor::None, _tab);
     ESPUI.setElementStyle(_lblInfoTest, "background-color: unset; text-align-last: left;");
@@ -488,40 +991,271 @@ void SystemInfoTab::update()
         }
     }
 
-    auto currentMillis = esp_timer_get_time() / 1000;
-    auto seconds = currentMillis / 1000;
-    auto minutes = seconds / 60;
-    auto hours = minutes / 60;
-    auto days = hours / 24;
-    currentMillis %= 1000;
-    seconds %= 60;
-    minutes %= 60;
-    hours %= 24;
-    float freeHeap = ESP.getFreeHeap();
+    _updateCount++;
+    bool statsCycle = _updateCount % SYSTEM_INFO_STATS_CYCLE == 0;
+    if (statsCycle)
+    {
+        _pushBytesRate = _pushBytes / SYSTEM_INFO_STATS_CYCLE;
+        _pushCountRate = _pushCount;
+        _pushBytes = 0;
+        _pushCount = 0;
+    }
+
+    char buffer[SYSTEM_INFO_BUFFER_SIZE];
+    updatePerformance(buffer, sizeof(buffer));
+    updateNetworkInfo(buffer, sizeof(buffer));
+    updateWeatherApi(buffer, sizeof(buffer));
+    updateBoot(buffer, sizeof(buffer));
+    if (statsCycle)
+    {
+        updateTasks(buffer, sizeof(buffer));
+        updateProbes(buffer, sizeof(buffer));
+#if DEFERRED_LOG_ENABLED
+        updateLog(buffer, sizeof(buffer));
+#endif
+    }
+}
+
+void SystemInfoTab::pushLabel(uint16_t control, const char *text, uint32_t &hash)
+{
+    uint32_t textHash = hashText(text);
+    if (textHash == hash)
+    {
+        return;
+    }
+
+    hash = textHash;
+    ESPUI.updateLabel(control, text);
+    _pushBytes += strlen(text) * ESPUI.ws->count();
+    _pushCount++;
+}
+
+void SystemInfoTab::updatePerformance(char *buffer, size_t size)
+{
+    uint32_t uptime = esp_timer_get_time() / 60000000LL;
     uint32_t heapSize = ESP.getHeapSize();
-    float usedHeap = heapSize - freeHeap;
-    float maxUsedHeap = ESP.getMaxAllocHeap();
-    float freeSketch = ESP.getFreeSketchSpace();
+    uint32_t heapUsed = heapSize - ESP.getFreeHeap();
+    uint32_t heapMaxAlloc = ESP.getMaxAllocHeap();
+    float temperature = temperatureRead();
+    if (uptime == _shownUptime && _pushBytesRate == _shownPushBytesRate &&
+        abs((int32_t)(heapUsed - _shownHeapUsed)) < SYSTEM_INFO_HEAP_THRESHOLD &&
+        abs((int32_t)(heapMaxAlloc - _shownHeapMaxAlloc)) < SYSTEM_INFO_HEAP_THRESHOLD &&
+        fabsf(temperature - _shownTemperature) < SYSTEM_INFO_TEMP_THRESHOLD)
+    {
+        return;
+    }
+
+    _shownUptime = uptime;
+    _shownHeapUsed = heapUsed;
+    _shownHeapMaxAlloc = heapMaxAlloc;
+    _shownTemperature = temperature;
+    _shownPushBytesRate = _pushBytesRate;
+    uint32_t freeSketch = ESP.getFreeSketchSpace();
     uint32_t sketchSize = freeSketch + ESP.getSketchSize();
-    auto performance = String("Uptime:\t\t\t\t") + String(days) + "d " + String(hours) + "h " + String(minutes) + "m " + String(seconds) + "s\n" +
-                "Heap Usage:\t\t\t" + String(usedHeap, 0) + "/" + String(heapSize) + " (" + String(usedHeap / heapSize * 100.0f, 2) + " %)\n" +
-                "Heap Allocated Max:\t" + String(maxUsedHeap, 0) + " (" + String(maxUsedHeap / heapSize * 100.0f, 2) + " %)\n" +
-                "Sketch Used:\t\t\t" + String(sketchSize - freeSketch, 0) + "/" + String(sketchSize) + " (" + String(freeSketch / sketchSize * 100.0f, 2) + " %)\n" +
-                "Temperature:\t\t\t" + String(temperatureRead(), 1) + " °C";
-    ESPUI.updateLabel(_lblPerformance, performance);
-
-
-
-    auto rssi = WiFi.RSSI();
-    auto info = String("Hostname:\t") + WiFi.getHostname() + "\n" +
-                "MAC:\t\t" + WiFi.macAddress() + "\n" +
-                "IP:\t\t\t" + WiFi.localIP().toString() + "\n" +
-                "DNS:\t\t" + WiFi.dnsIP().toString() + "\n" +
-                "Gateway:\t" + WiFi.gatewayIP().toString() + "\n" +
-                "Subnet:\t\t" + WiFi.subnetMask().toString() + "\n" +
-                "SSID:\t\t" + WiFi.SSID() + "\n" +
-                "RSSI:\t\t" + String(rssi) + " db (" + String(WifiModeChampClass::wifiSignalQuality(rssi)) + " %)";
-    ESPUI.updateLabel(_lblInfoTest, info);
+    snprintf(buffer, size,
+             "Uptime:\t\t\t\t%ud %uh %um\n"
+             "Heap Usage:\t\t\t%u/%u (%.2f %%)\n"
+             "Heap Allocated Max:\t%u (%.2f %%)\n"
+             "Sketch Used:\t\t\t%u/%u (%.2f %%)\n"
+             "Temperature:\t\t\t%.1f °C\n"
+             "UI Traffic:\t\t\t%u B/s (%u updates in %u s)",
+             uptime / 1440, uptime / 60 % 24, uptime % 60,
+             heapUsed, heapSize, heapUsed * 100.0f / heapSize,
+             heapMaxAlloc, heapMaxAlloc * 100.0f / heapSize,
+             sketchSize - freeSketch, sketchSize, (sketchSize - freeSketch) * 100.0f / sketchSize,
+             temperature,
+             _pushBytesRate, _pushCountRate, SYSTEM_INFO_STATS_CYCLE);
+    pushLabel(_lblPerformance, buffer, _hashPerformance);
+}
+
+void SystemInfoTab::updateNetworkInfo(char *buffer, size_t size)
+{
+    IPAddress ip = WiFi.localIP();
+    IPAddress dns = WiFi.dnsIP();
+    IPAddress gateway = WiFi.gatewayIP();
+    IPAddress subnet = WiFi.subnetMask();
+    auto ssid = WiFi.SSID();
+    auto hostname = WiFi.getHostname();
+    int8_t rssi = WiFi.RSSI();
+    uint32_t hash = hashText(ssid.c_str(), hashText(hostname ? hostname : ""));
+    hash = (hash ^ (uint32_t)ip) * 16777619UL;
+    hash = (hash ^ (uint32_t)dns) * 16777619UL;
+    hash = (hash ^ (uint32_t)gateway) * 16777619UL;
+    hash = (hash ^ (uint32_t)subnet) * 16777619UL;
+    if (hash == _shownNetworkHash && abs(rssi - _shownRssi) < SYSTEM_INFO_RSSI_THRESHOLD)
+    {
+        return;
+    }
+
+    _shownNetworkHash = hash;
+    _shownRssi = rssi;
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    snprintf(buffer, size,
+             "Hostname:\t%s\n"
+             "MAC:\t\t%02X:%02X:%02X:%02X:%02X:%02X\n"
+             "IP:\t\t\t%u.%u.%u.%u\n"
+             "DNS:\t\t%u.%u.%u.%u\n"
+             "Gateway:\t%u.%u.%u.%u\n"
+             "Subnet:\t\t%u.%u.%u.%u\n"
+             "SSID:\t\t%s\n"
+             "RSSI:\t\t%d db (%d %%)",
+             hostname ? hostname : "",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5],
+             ip[0], ip[1], ip[2], ip[3],
+             dns[0], dns[1], dns[2], dns[3],
+             gateway[0], gateway[1], gateway[2], gateway[3],
+             subnet[0], subnet[1], subnet[2], subnet[3],
+             ssid.c_str(),
+             rssi, WifiModeChampClass::wifiSignalQuality(rssi));
+    pushLabel(_lblInfoTest, buffer, _hashNetwork);
+}
+
+void SystemInfoTab::updateWeatherApi(char *buffer, size_t size)
+{
+    if (!_weatherApiDirty)
+    {
+        return;
+    }
+
+    _weatherApiDirty = false;
+    char handshake[16];
+    if (_weatherApiStats.reused)
+        strlcpy(handshake, "reused", sizeof(handshake));
+    else
+        snprintf(handshake, sizeof(handshake), "%u ms", _weatherApiStats.handshake);
+    snprintf(buffer, size,
+             "Requests:\t\t%u (%u reused connections)\n"
+             "Attempts:\t\t%u (%u failed, %u skipped offline)\n"
+             "Next:\t\t\t%u s (%u failures in a row)\n"
+             "Duration:\t\t%u ms\n"
+             "Handshake:\t\t%s\n"
+             "Received:\t\t%u bytes\n"
+             "Heap Peak:\t\t%u (max %u)",
+             _weatherApiRequests, _weatherApiReused,
+             _weatherApiSchedule.attempts, _weatherApiSchedule.failures, _weatherApiSchedule.skipped,
+             _weatherApiSchedule.delay / 1000, _weatherApiSchedule.consecutiveFailures,
+             _weatherApiStats.duration,
+             handshake,
+             _weatherApiStats.bytes,
+             _weatherApiStats.heapPeak, _weatherApiHeapPeakMax);
+    pushLabel(_lblWeatherApi, buffer, _hashWeatherApi);
+}
+
+void SystemInfoTab::updateBoot(char *buffer, size_t size)
+{
+    uint8_t stages = 0;
+    for (uint8_t i = 1; i < BOOT_STAGE_COUNT; i++)
+    {
+        if (BootSequence.getTime(static_cast<BootStage>(i)) >= 0)
+            stages++;
+    }
+
+    if (stages == _shownBootStages)
+    {
+        return;
+    }
+
+    _shownBootStages = stages;
+    size_t pos = 0;
+    buffer[0] = '\0';
+    for (uint8_t i = 1; i < BOOT_STAGE_COUNT; i++)
+    {
+        auto stage = static_cast<BootStage>(i);
+        auto time = BootSequence.getTime(stage);
+        appendText(buffer, size, pos, pos > 0 ? "\n%s:\t" : "%s:\t", BootSequence.getStageName(stage));
+        if (time < 0)
+            appendText(buffer, size, pos, "pending");
+        else
+            appendText(buffer, size, pos, "%ld ms", (long)(time / 1000));
+    }
+
+    appendText(buffer, size, pos, "\nConfig Load:\t%u us (%s)", _configStoreStats.loadTime,
+               _configStoreStats.loadVersion > 0 ? "blob" : "migrated");
+    pushLabel(_lblBoot, buffer, _hashBoot);
+}
+
+void SystemInfoTab::updateTasks(char *buffer, size_t size)
+{
+    size_t pos = 0;
+    buffer[0] = '\0';
+    appendText(buffer, size, pos,
+               "Control Period:\t%u us (%u cycles, %u overruns)\n"
+               "Control Jitter:\t%u us avg, %u us max\n"
+               "Control Exec:\t%u us max\n"
+               "Network Jitter:\t%u us avg, %u us max\n"
+               "Network Exec:\t%u us max (%u overruns)\n"
+               "UI Frames:\t%u updates in %u frames (%u coalesced, %u bytes), %u deferred, %u over budget\n"
+               "Telemetry:\t%u clients, %u frames sent, %u dropped\n"
+               "History Log:\t%u records in %u writes (%u bytes), %u segments, %u rotations, %u failures\n"
+               "Config:\t%u changes (%u coalesced, %u pending), %u commits (%u bytes, %u failed), commit %u/%u us last/max",
+               _controlStats.period, _controlStats.cycles, _controlStats.overruns,
+               _controlStats.jitterAvg, _controlStats.jitterMax,
+               _controlStats.execMax,
+               _networkStats.jitterAvg, _networkStats.jitterMax,
+               _networkStats.execMax, _networkStats.overruns,
+               _frameStats.updates, _frameStats.frames, _frameStats.coalesced, _frameStats.bytes, _frameStats.deferred, _frameStats.overBudget,
+               _streamStats.clients, _streamStats.sent, _streamStats.dropped,
+               _historyLogStats.records, _historyLogStats.writes, _historyLogStats.bytes, _historyLogStats.segments, _historyLogStats.rotations, _historyLogStats.failures,
+               _configStoreStats.changes, _configStoreStats.coalesced, _configStoreStats.pending, _configStoreStats.commits, _configStoreStats.bytes, _configStoreStats.failures,
+               _configStoreStats.commitTimeLast, _configStoreStats.commitTimeMax);
+    for (uint8_t i = 0; i < _jobCount; i++)
+    {
+        auto &job = _jobs[i];
+        appendText(buffer, size, pos, "\n%s:\t%u ms, exec %u/%u us avg/max, late %u us max, %u missed, %u overruns",
+                   job.name, job.period / 1000, job.runs > 0 ? (uint32_t)(job.execTotal / job.runs) : 0, job.execMax, job.lateMax, job.missed, job.overruns);
+    }
+    pushLabel(_lblControl, buffer, _hashControl);
+}
+
+void SystemInfoTab::updateProbes(char *buffer, size_t size)
+{
+    size_t pos = 0;
+    buffer[0] = '\0';
+    for (uint8_t i = 0; i < Probe::getCount(); i++)
+    {
+        auto stats = Probe::get(i)->getStats();
+        appendText(buffer, size, pos, pos > 0 ? "\n%s:\texec %u/%u/%u us (p99 %u), jitter %u/%u us (p99 %u)" : "%s:\texec %u/%u/%u us (p99 %u), jitter %u/%u us (p99 %u)",
+                   stats.name, stats.exec.getMin(), stats.exec.getAverage(), stats.exec.max, stats.exec.getPercentile(99),
+                   stats.jitter.getAverage(), stats.jitter.max, stats.jitter.getPercentile(99));
+    }
+    pushLabel(_lblProbes, buffer, _hashProbes);
+}
+
+#if DEFERRED_LOG_ENABLED
+void SystemInfoTab::updateLog(char *buffer, size_t size)
+{
+    snprintf(buffer, size, "Records:\t%u (%u lost)\n<a href=\"/log\" target=\"_blank\" style=\"color: white;\">Show latest records</a>",
+             DeferredLog.getRecordCount(), DeferredLog.getLostCount());
+    pushLabel(_lblLog, buffer, _hashLog);
+}
+#endif
+
+void SystemInfoTab::setWeatherApiStats(const ApiRequestStats &stats, const RetrySchedulerStats &schedule)
+{
+    _weatherApiSchedule = schedule;
+    _weatherApiRequests++;
+    if (stats.reused)
+        _weatherApiReused++;
+    if (stats.heapPeak > _weatherApiHeapPeakMax)
+        _weatherApiHeapPeakMax = stats.heapPeak;
+    _weatherApiStats = stats;
+    _weatherApiDirty = true;
+}
+
+void SystemInfoTab::setTaskStats(const PeriodicTaskStats &control, const PeriodicTaskStats &network)
+{
+    _controlStats = control;
+    _networkStats = network;
+}
+
+void SystemInfoTab::setJobStats(const SchedulerJobStats *control, uint8_t controlCount, const SchedulerJobStats *network, uint8_t networkCount)
+{
+    _jobCount = 0;
+    for (uint8_t i = 0; i < controlCount && _jobCount < SYSTEM_INFO_JOB_CNT; i++)
+        _jobs[_jobCount++] = control[i];
+    for (uint8_t i = 0; i < networkCount && _jobCount < SYSTEM_INFO_JOB_CNT; i++)
+        _jobs[_jobCount++] = network[i];
 }
 
 
@@ -372,7 +372,7 @@ void WifiModeChampClass::loop()
                 if (WiFi.SSID(i) == _wifiSsid)
                 {
 #ifdef LOG_DEBUG
-                    LOG_DEBUG(F("WiFiModeChamp"), F("loop"), F("Configured SSID `") + _wifiSsid + F("` is available again, start reconnect..."));
+                    LOG_DEBUG(F("WiFiModeChamp"), F("loop"), F("Configured SSID `{}` is available again, start reconnect..."), _wifiSsid);
 #endif
                     clearWifiScanResult(); // Only clear on success, otherwise the scan result will be error and the wait time will not work
                     stopAP();
@@ -420,7 +420,7 @@ void WifiModeChampClass::setState(WifiModeChampState state)
     const WifiModeChampState previous = _state;
     _state = state;
 #ifdef LOG_DEBUG
-    LOG_DEBUG(F("WiFiModeChamp"), F("setState"), F("Change state from ") + getStateName(previous) + F(" to ") + getStateName(state));
+    LOG_DEBUG(F("WiFiModeChamp"), F("setState"), F("Change state from {} to {}"), getStateName(previous), getStateName(state));
 #endif
 
     if (_stateCallback != nullptr)
@@ -443,7 +443,7 @@ void WifiModeChampClass::startSTA()
     WiFi.mode(WIFI_STA);
 
 #ifdef LOG_DEBUG
-    LOG_DEBUG(F("WiFiModeChamp"), F("startSTA"), F("Connecting to SSID: ") + _wifiSsid);
+    LOG_DEBUG(F("WiFiModeChamp"), F("startSTA"), F("Connecting to SSID: {}"), _wifiSsid);
 #endif
 
     WiFi.begin(_wifiSsid, _wifiPassword);
@@ -514,18 +514,15 @@ void WifiModeChampClass::onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info)
 {
 #ifdef LOG_DEBUG
     LOG_DEBUG(F("WiFiModeChamp"), F("onWiFiEvent"), 
-    F("mode=") + WiFi.getMode() + 
-    F(" state=") + getStateName() + 
-    F(" event=") + event + 
-    F(" prov_fail_reason=") + info.prov_fail_reason + 
-    F(" info.wifi_sta_disconnected.reason=") + info.wifi_sta_disconnected.reason);
+        F("mode={} state={} event={} prov_fail_reason={} info.wifi_sta_disconnected.reason={}"),
+        WiFi.getMode(), getStateName(), event, info.prov_fail_reason, info.wifi_sta_disconnected.reason);
 #endif
     //if(info.prov_fail_reason == WIFI_PROV_STA_AUTH_ERROR)
     if((_state == WifiModeChampState::NETWORK_CONNECTING ||  _state == WifiModeChampState::NETWORK_CONNECTING) && 
         info.wifi_sta_disconnected.reason == WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT)
     {
 #ifdef LOG_ERROR
-    LOG_ERROR(F("WiFiModeChamp"), F("onWiFiEvent"), F("WiFi credentals for SSID `") + _wifiSsid + F("` are invalid! Removing invalid credentials to wait in AP mode for correction..."));
+    LOG_ERROR(F("WiFiModeChamp"), F("onWiFiEvent"), F("WiFi credentals for SSID `{}` are invalid! Removing invalid credentials to wait in AP mode for correction..."), _wifiSsid);
 #endif
         _wifiSsid = emptyString; 
         _wifiPassword = emptyString;
@@ -612,7 +609,7 @@ int16_t WifiModeChampClass::scanWifiNetworks(bool ignoreWaitTime)
     if (scanCnt > 0 && _lastScanStarted > 0)
     {
 #ifdef LOG_DEBUG
-        LOG_DEBUG(F("WiFiModeChamp"), F("scanWifiNetworks"), F("Scan completed with ") + scanCnt + " available networks");
+        LOG_DEBUG(F("WiFiModeChamp"), F("scanWifiNetworks"), F("Scan completed with {} available networks"), scanCnt);
 #endif
         _lastScanCompleted = millis();
         _lastScanStarted = -1;
@@ -1,30 +1,56 @@
 #define LOG_LEVEL NONE
 
 #include <Arduino.h>
-#include <arduino-timer.h>
-#include <RunningMedian.h>
 #include <SPI.h>
 #include <Wire.h>
 #include <DFRobot_GP8403.h>
 #include "WiFiModeChamp.h"
 #include "OpenWeatherMap.h"
+#include "WeatherFetcher.h"
+#include "RetryScheduler.h"
+#include "WeatherCache.h"
+#include "BootSequence.h"
+#include "PeriodicTask.h"
+#include "SharedState.h"
+#include "Scheduler.h"
+#include "Probe.h"
+#include "HistoryStore.h"
+#include "HistoryLog.h"
 #include "ThermistorCalc.h"
+#include "DigitalPotiTable.h"
+#include "AdcCorrection.h"
+#include "AdcSampler.h"
+#include "ThermistorInput.h"
 #include "Config.h"
 #include "Webinterface.h"
 #include "Secrets.h"
 #include "SerialLogging.h"
 
+#ifndef WEATHER_API_URL
+#define WEATHER_API_URL OPEN_WEATHER_MAP_URL // Can be defined inside Secrets.h to use a local stand-in server (e.g. "http://192.168.1.10:8080")
+#endif
+
 static const uint8_t GPIO_THERMISTOR_IN = GPIO_NUM_36;										// GPIO used for real input temperature from thermistor
 static const uint8_t SPI_BUS_THERMISTOR_OUT = VSPI;											// SPI bus used for digital potentiometer for output temperature
 static const uint8_t GPIO_FAILOVER_OUT = GPIO_NUM_27;										// GPIO used as digital output to signal that the output temperature is now valid (failover via relays or LED)
 static const uint8_t GPIO_FAILOVER_IN = GPIO_NUM_25;										// GPIO used as digital output to signal that the input temperature is now required (open failover via relays or LED)
-static const float SUPPLY_VOLTAGE = 3.3;													// Maximum Voltage ADC input
+static const float SUPPLY_VOLTAGE = ADC_MAX_VOLTAGE;										// Maximum Voltage ADC input
+static const bool ADC_USE_EFUSE_CALIBRATION = false;										// Use the eFuse ADC calibration of the chip if available (otherwise the G6EJD polynomial curve is used)
 static const unsigned int TEMP_IN_DEVIDER_RESISTANCE = 10000;								// Voltage divider resistor value for input temperature in Ohm
-static const unsigned int TEMP_IN_SAMPLE_CYCLE = 10;										// Sample rate to build the median in milliseconds
+static const unsigned int TEMP_IN_SAMPLE_CYCLE = 10;										// Sample rate of the sliding median window in milliseconds
 static const unsigned int TEMP_IN_UPDATE_CYCLE = 1000;										// Update every n ms the input temperature
-static const unsigned int TEMP_IN_SAMPLE_CNT = TEMP_IN_UPDATE_CYCLE / TEMP_IN_SAMPLE_CYCLE; // Amount of samples for input thermistor median calculation
+static const unsigned int TEMP_IN_SAMPLE_CNT = TEMP_IN_UPDATE_CYCLE / TEMP_IN_SAMPLE_CYCLE; // Amount of samples inside the sliding median window of the input thermistor
+static const float TEMP_IN_OUTLIER_DEVIATION = 0.5f;										// Maximum deviation from the median in °C, samples above are rejected as outlier
+static const bool TEMP_IN_CONTINUOUS_SAMPLING = false;										// Sample the input thermistor continuously via DMA in the background (each sample cycle averages the captured frame)
+static const size_t TEMP_IN_FRAME_SIZE = ADC_CONTINUOUS_SAMPLE_FREQUENCY / 1000 * TEMP_IN_SAMPLE_CYCLE; // Maximum amount of raw samples per frame (one sample cycle)
 static const unsigned int WEATHER_API_UPDATE_CYCLE = 600000;	   							// Update time of the temperture by the weather API in milliseconds
-static const unsigned int WEATHER_API_UPDATE_CYCLE_FAILED = 10000; 							// Update time of the temperture by the weather API if the request has failed in milliseconds
+static const unsigned int WEATHER_FORECAST_UPDATE_CYCLE = 3600000;							// Update time of the weather forecast (used to interpolate the weather temperature) in milliseconds
+static const uint32_t WEATHER_CACHE_MAX_AGE = 10800;										// Maximum age of the cached weather of the last run (software reset) to be used at boot in seconds
+static const time_t MIN_VALID_UNIX_TIME = 1704067200;										// System time before 2024-01-01 is treated as not set (time is taken from the weather API responses)
+static const unsigned int WEATHER_API_RETRY_MIN = 10000; 									// First retry delay of the weather API if the request has failed in milliseconds (doubles on each failure)
+static const unsigned int WEATHER_API_RETRY_MAX = 300000; 									// Maximum retry delay of the weather API if the requests keep failing in milliseconds
+static const uint8_t WEATHER_API_RETRY_JITTER = 20; 										// Maximum random reduction of the weather API retry delay in percent
+static const uint16_t WEATHER_API_TIMEOUT = 5000;											// Timeout budget of a weather API request for connecting and reading the response in milliseconds
 static const bool PREFERE_WEATHER_API_OVER_INPUT_SENSOR = true;								// Defines that the Weather API has an higher preority than the real input temperature sensor
 static const unsigned int TEMP_OUT_UPDATE_CYCLE = 1000;										// Update time of the output temperature in milliseconds
 static const uint16_t DIGI_POTI_STEPS = 256;												// Maximum amount of steps that the digital potentiometer supports
@@ -32,210 +58,300 @@ static const uint16_t DIGI_POTI_STEP_MIN = 0;												// Minimum step of the
 static const float DIGI_POTI_RESISTANCE = 50000.0f;											// Maximum resistance of the digital potentiometer in Ohm
 static const float DIGI_POTI_PRERESISTANCE = 5000.0f;										// Digital potentiometer pre-resistor to limit current and improve precision in Ohm
 static const unsigned int POWER_OUT_UPDATE_CYCLE = 1000; 									// Update time of the output temperature in milliseconds
-
-ThermistorCalc _thermistorIn(-40, 167820, 25, 6523, 120, 302);	// Input for real temperature (Panasonic PAW-A2W-TSOD)
-ThermistorCalc _thermistorOut(-40, 167820, 25, 6523, 120, 302); // Output that simulates a Panasonic PAW-A2W-TSOD for the Panasonic T-Cap
-RunningMedian _thermistorInMedian(TEMP_IN_SAMPLE_CNT);			// Median average calculation for input temperature sensor
+static const uint32_t CONTROL_TASK_STACK_SIZE = 4096;										// Stack size of the control task (sampling, output temperature, power limit) in bytes
+static const UBaseType_t CONTROL_TASK_PRIORITY = 5;											// Priority of the control task (above the network task, AsyncTCP and the weather API task)
+static const BaseType_t CONTROL_TASK_CORE = 1;												// Core of the control task, runs every TEMP_IN_SAMPLE_CYCLE (the WiFi stack runs on core 0)
+static const unsigned int NETWORK_TASK_CYCLE = 2;											// Period of the network task (boot stages, WiFi, weather API, webinterface) in milliseconds
+static const uint32_t NETWORK_TASK_STACK_SIZE = 8192;										// Stack size of the network task in bytes (same as the Arduino loop)
+static const UBaseType_t NETWORK_TASK_PRIORITY = 1;											// Priority of the network task (same as the Arduino loop)
+static const BaseType_t NETWORK_TASK_CORE = 0;												// Core of the network task (together with the WiFi stack)
+static const unsigned int WEBINTERFACE_FRAME_CYCLE = 200;									// UI frame of the webinterface in milliseconds (changed labels are sent once per frame)
+static const unsigned int HISTORY_UPDATE_CYCLE = 1000;										// Update time of the history (completed minutes are written to the history log) in milliseconds
+static const unsigned int CONFIG_STORE_UPDATE_CYCLE = 500;									// Check for configuration changes to commit every n ms (the commit is delayed by CONFIG_STORE_COMMIT_DELAY)
+static const uint8_t SCHEDULER_JOB_CNT = 6;													// Maximum amount of jobs per task scheduler
+static const uint32_t SCHEDULER_TOLERANCE = 1000;											// Jobs are started up to n us before their deadline (one FreeRTOS tick, the tasks are woken by the tick)
+
+/// @brief Snapshot of the control values, published by the control task and shown by the network task
+struct ControlState
+{
+	float inputTemperature = NAN;
+	float thermistorInTemperature = NAN;
+	uint16_t thermistorInOutliers = 0;
+	uint32_t thermistorInOutliersTotal = 0;
+	float outputTemperature = NAN;
+	float targetTemperature = NAN;
+	uint16_t outputPotiPosition = 0;
+	uint8_t powerLimitPercent = 0;
+};
+
+using ThermistorInProfile = PanasonicPawA2wTsod;											// Profile of the real input temperature sensor
+using ThermistorOutProfile = PanasonicPawA2wTsod;											// Profile of the simulated output temperature sensor
+static_assert(std::is_same<ThermistorOutProfile, PanasonicPawA2wTsod>::value, "The Panasonic T-Cap only supports the PAW-A2W-TSOD sensor characteristic as output");
+
+ThermistorCalc _thermistorIn(ThermistorInProfile{});			// Input for real temperature (Panasonic PAW-A2W-TSOD)
+ThermistorCalc _thermistorOut(ThermistorOutProfile{});			// Output that simulates a Panasonic PAW-A2W-TSOD for the Panasonic T-Cap
+DigitalPotiTable _digitalPotiTable(_thermistorOut, DIGI_POTI_STEPS, DIGI_POTI_STEP_MIN, DIGI_POTI_RESISTANCE, DIGI_POTI_PRERESISTANCE); // Achievable output temperatures of the digital potentiometer
+AdcCorrection _adcCorrection;									// Correction of the none linear ADC readings
+AdcSampler *_adcSampler;										// Sampling of the input thermistor ADC
+ThermistorInput<TEMP_IN_SAMPLE_CNT, TEMP_IN_FRAME_SIZE> _thermistorInput(_adcCorrection, _thermistorIn, TEMP_IN_DEVIDER_RESISTANCE, SUPPLY_VOLTAGE, TEMP_IN_OUTLIER_DEVIATION); // Input temperature sensor with sliding median window and trimmed mean
 DFRobot_GP8403 *_i2cDac;										// DFRobot DAC for power limit (nullptr if not available)
 SPIClass *_spiDigitalPoti;										// Digital potentiometer SPI interface
 OpenWeatherMap *_weatherApi;									// OpenWeatherMap API access
+WeatherFetcher *_weatherFetcher;								// Background task for the weather API requests
+RetryScheduler _weatherApiSchedule(WEATHER_API_UPDATE_CYCLE, WEATHER_API_RETRY_MIN, WEATHER_API_RETRY_MAX, WEATHER_API_RETRY_JITTER); // Schedule of the weather API requests with backoff on failures
+RetryScheduler _weatherForecastSchedule(WEATHER_FORECAST_UPDATE_CYCLE, WEATHER_API_RETRY_MIN, WEATHER_API_RETRY_MAX, WEATHER_API_RETRY_JITTER); // Schedule of the weather forecast requests with backoff on failures
+WeatherSeries _weatherSeries;									// Current weather and forecast to interpolate the weather temperature
 Webinterface *_webinterface; 									// Access to the webinterface
-Timer<6, millis> _timers;	 									// Timer collection for time based operations
+Scheduler<SCHEDULER_JOB_CNT, micros> _controlScheduler(SCHEDULER_TOLERANCE); // Fixed rate jobs of the control task (sampling, output temperature, power limit)
+Scheduler<SCHEDULER_JOB_CNT, micros> _networkScheduler(SCHEDULER_TOLERANCE); // Fixed rate jobs of the network task (webinterface, UI frames, telemetry stream, history, configuration)
+SharedState<SchedulerSnapshot<SCHEDULER_JOB_CNT>> _controlJobStats; // Statistics of the control jobs written by the control task, read by the network task
+Probe _probeControl("Control", TEMP_IN_SAMPLE_CYCLE * 1000);	// Execution time and jitter of the control task cycle
+Probe _probeSample("Sample", TEMP_IN_SAMPLE_CYCLE * 1000);		// Execution time and jitter of the input thermistor sampling
+Probe _probeOutput("Output", TEMP_OUT_UPDATE_CYCLE * 1000);		// Execution time and jitter of the output temperature update (SPI)
+Probe _probePower("Power", POWER_OUT_UPDATE_CYCLE * 1000);		// Execution time and jitter of the power limit update (I2C)
+Probe _probeNetwork("Network", NETWORK_TASK_CYCLE * 1000);		// Execution time and jitter of the network task cycle
+Probe _probeWifi("WiFi", NETWORK_TASK_CYCLE * 1000);			// Execution time and jitter of WifiModeChamp.loop()
+Probe _probeWeatherApi("Weather API", NETWORK_TASK_CYCLE * 1000); // Execution time and jitter of the weather API result handling
+Probe _probeWebinterface("Webinterface", TEMP_OUT_UPDATE_CYCLE * 1000); // Execution time and jitter of the webinterface (ESPUI) updates
+PeriodicTask *_controlTask;										// Fixed period task for sampling, output temperature and power limit
+PeriodicTask *_networkTask;										// Task for boot stages, WiFi, weather API and webinterface
+SharedState<ControlState> _controlState;						// Control values written by the control task, read by the network task
+SharedState<float> _controlWeatherApiTemperature(NAN);			// Weather API temperature written by the network task, read by the control task
+SharedState<uint16_t> _controlAdcRaw;							// Average raw reading of the last input thermistor frame written by the control task, read by the network task
+uint16_t _telemetrySequence = 0;								// Sequence number of the next telemetry stream frame
+HistoryStore _history;											// History of the input and output temperature (1 s, 1 min and 15 min tiers, HISTORY_FOOTPRINT bytes)
+HistoryLog _historyLog;											// Append-only log of the 1 min history on LittleFS (survives reboots and updates)
+ControlState _controlStateShown;								// Control values that are shown inside the webinterface (network task)
+uint32_t _controlStateVersion = 0;								// Version of the control values that are shown inside the webinterface
 Config *_config;			 									// Access to the configuration
-float _thermistorInTemperature = NAN;							// Last temperature from input sensor (NAN if not available)
-float _weatherApiTemperature = NAN;								// Last temperature from weather API (NAN if not available)
+float _weatherApiTemperature = NAN;								// Last temperature from weather API, interpolated with the forecast (NAN if not available)
 String _weatherApiTimestamp = emptyString;						// Last temperature from weather API (NAN if not available)
+float _inputTemperature = NAN;									// Last input temperature that has been used for the output temperature
 float _outputTemperature = NAN;									// Last output temperature (NAN if no temperature could be calculated)
 float _targetTemperature = NAN;									// Last output target temperature (NAN if no temperature could be calculated)
+uint16_t _outputPotiPosition = 0;								// Last wiper position of the digital potentiometer
 uint8_t _powerLimitPercent = 0;									// Last powerlimit in percent (<10 means disabled)
 
-/// @brief Reads the ADC voltage with none linear compensation (maximum reading 3.3V range from 0 to 4095)
-float readAdcVoltageCorrected(uint8_t gpioPin)
+/// @brief Adds the next sample frame of the input thermistor to the sliding median window (see ThermistorInput::update)
+/// @return If the value has changed
+bool updateThermistorInTemperature()
 {
-	u_int16_t reading = analogRead(gpioPin);
-	if (reading < 1)
+	bool wasAvailable = !isnanf(_thermistorInput.getTemperature());
+	if (!_thermistorInput.update())
 	{
-		return 0;
+		return false;
 	}
 
-	if (reading > 3757)
+	float temperature = _thermistorInput.getTemperature();
+	if (isnanf(temperature))
 	{
-		// From 3.0284V on we use the normal calculation, since the Polynomial curve will drift away and will never reach 3.3V (max out at 3.14V)
-		return SUPPLY_VOLTAGE / 4095.0f * reading;
+#ifdef LOG_ERROR
+		if (wasAvailable)
+			LOG_ERROR(F("Main"), F("updateThermistorInTemperature"), F("Input thermistor not available, devider resistor defect or no sensor connected? voltage={}"), _thermistorInput.getVoltage());
+#endif
+		return true;
 	}
 
-	// Pre-calculated polynomial curve from https://github.com/G6EJD/ESP32-ADC-Accuracy-Improvement-function
-	return -0.000000000000016 * pow(reading, 4) + 0.000000000118171 * pow(reading, 3) - 0.000000301211691 * pow(reading, 2) + 0.001109019271794 * reading + 0.034143524634089;
+#ifdef LOG_INFO
+	LOG_INFO(F("Main"), F("updateThermistorInTemperature"), F("Temperature (median) {}"), temperature);
+#endif
+	return true;
 }
 
-/// @brief Gets the current input thermistor temperature
-/// @param logError Log detected errors due to e.g. unplausible values
-/// @return the temperature of te input thermistor or NAN if there is no sensor conneted or if the value is unplausible
-float getCurrentThermistorInTemperature(bool logError)
+/// @brief Sets the system time from the time of a server response, if it deviates more than a few seconds
+/// @param serverTime Time epoch unix in seconds, UTC (0 if unknown)
+void setSystemTime(const time_t serverTime)
 {
-	float voltage = readAdcVoltageCorrected(GPIO_THERMISTOR_IN);
-	if (!(voltage > 0))
+	if (serverTime < MIN_VALID_UNIX_TIME || abs(serverTime - time(nullptr)) < 3)
 	{
-#ifdef LOG_ERROR
-		if (logError)
-			LOG_ERROR(F("Main"), F("getCurrentThermistorInTemperature"), F("Voltage unplausible, devider resistor defect? voltage=") + voltage);
-#endif
-		return NAN;
+		return;
 	}
 
-	float resistance = TEMP_IN_DEVIDER_RESISTANCE * voltage / (SUPPLY_VOLTAGE - voltage);
-	if (resistance == infinityf())
-	{
-#ifdef LOG_ERROR
-		if (logError)
-			LOG_ERROR(F("Main"), F("getCurrentThermistorInTemperature"), F("No external temperature sensor connected. resistance=") + resistance);
+	timeval now = {serverTime, 0};
+	settimeofday(&now, nullptr);
+#ifdef LOG_INFO
+	LOG_INFO(F("Main"), F("setSystemTime"), F("System time set to {}"), (long)serverTime);
 #endif
-		return NAN;
-	}
-
-	return _thermistorIn.celsiusFromResistance(resistance);
 }
 
-/// @brief Update the _thermistorInTemperature by reading the input thermistor temperature to build a medain average
+/// @brief Updates the _weatherApiTemperature by interpolating the current weather and forecast for the current time
 /// @return If the value has changed
-bool updateThermistorInTemperature()
+bool updateWeatherApiInterpolation()
 {
-	float tempIn = getCurrentThermistorInTemperature(!isnanf(_thermistorInTemperature));
-	if (isnanf(tempIn))
+	time_t now = time(nullptr);
+	if (now < MIN_VALID_UNIX_TIME)
 	{
-		if (!isnanf(_thermistorInTemperature) || _thermistorInMedian.getCount() > 0)
-		{
-			_thermistorInMedian.clear();
-			_thermistorInTemperature = NAN;
-			return true;
-		}
-
 		return false;
 	}
 
-	_thermistorInMedian.add(tempIn);
-	if ((_thermistorInMedian.getCount() % TEMP_IN_SAMPLE_CNT) == 0)
+	float temperature = _weatherSeries.interpolate(now);
+	if (isnanf(temperature) || temperature == _weatherApiTemperature)
 	{
-		float medianTemp = _thermistorInMedian.getMedianAverage(TEMP_IN_SAMPLE_CNT);
-		_thermistorInMedian.clear();
-		if (isnanf(_thermistorInTemperature) || abs(medianTemp - _thermistorInTemperature) > 0.06)
-		{
-#ifdef LOG_INFO
-			LOG_INFO(F("Main"), F("updateThermistorInTemperature"), F("Temperature (median) ") + medianTemp);
-#endif
-			_thermistorInTemperature = medianTemp;
-			return true;
-		}
+		return false;
 	}
 
-	return false;
+	_weatherApiTemperature = temperature;
+	_controlWeatherApiTemperature.store(_weatherApiTemperature);
+	return true;
 }
 
-/// @brief Update Weather API temperature timer callback
-/// NOTE: The timer registration is handled by updateWeatherApiTemperature since
-/// based on the API response the timer will be restarted with different ticks
-bool updateWeatherApiTemperatureTick(void *opaque);
-
-///	@brief Updates the _weatherApiTemperature via API
+///	@brief Applies the result of a weather API request to _weatherApiTemperature and schedules the next attempt
 /// @return If the value has changed
-bool updateWeatherApiTemperature()
+bool applyWeatherApiResult(const WeatherResult &result)
 {
-	if (!_weatherApi)
+	setSystemTime(result.serverTime);
+	if (result.forecastRequested)
 	{
-		return false;
+		if (result.forecast.successful)
+		{
+			_weatherSeries.setForecast(result.forecast.points, result.forecast.count);
+			_weatherForecastSchedule.succeeded(millis());
+		}
+		else
+		{
+#ifdef LOG_ERROR
+			LOG_ERROR(F("Main"), F("applyWeatherApiResult"), F("Error on update forecast by weather API {} (HTTP code {})"), result.forecast.error, result.forecast.httpCode);
+#endif
+			_weatherForecastSchedule.failed(millis());
+		}
 	}
 
-	auto request = _weatherApi->request();
-	if (!request.successful)
+	if (!result.successful)
 	{
 #ifdef LOG_ERROR
-		switch (request.error)
+		switch (result.error)
 		{
 		case Error::WifiNotConnected:
-			LOG_ERROR(F("Main"), F("updateWeatherApiTemperature"), F("Error on update temperature by weather API (WiFi not connected)"));
+			LOG_ERROR(F("Main"), F("applyWeatherApiResult"), F("Error on update temperature by weather API (WiFi not connected)"));
 			break;
 		case Error::HttpError:
-			LOG_ERROR(F("Main"), F("updateWeatherApiTemperature"), F("Error on update temperature by weather API (HTTP error) ") + request.httpCode);
+			LOG_ERROR(F("Main"), F("applyWeatherApiResult"), F("Error on update temperature by weather API (HTTP error) {}"), result.httpCode);
 			break;
 		case Error::DeserializationFailed:
-			LOG_ERROR(F("Main"), F("updateWeatherApiTemperature"), F("Error on update temperature by weather API (Deserialization failed)"));
+			LOG_ERROR(F("Main"), F("applyWeatherApiResult"), F("Error on update temperature by weather API (Deserialization failed)"));
 			break;
 		}
 #endif
-		_timers.every(WEATHER_API_UPDATE_CYCLE_FAILED, updateWeatherApiTemperatureTick);
+		_weatherApiSchedule.failed(millis());
 		return false;
 	}
 
 #ifdef LOG_INFO
-	LOG_INFO(F("Main"), F("updateWeatherApiTemperature"), F("Updated temperature by weather API ") + request.temperature);
+	LOG_INFO(F("Main"), F("applyWeatherApiResult"), F("Updated temperature by weather API {} in {} ms"), result.temperature, result.stats.duration);
 #endif
 
-	_timers.every(WEATHER_API_UPDATE_CYCLE, updateWeatherApiTemperatureTick);
-	bool changed = _weatherApiTemperature != request.temperature || _weatherApiTimestamp != request.timestamp;
-	_weatherApiTemperature = request.temperature;
-	_weatherApiTimestamp = request.timestamp;
-	return changed;
+	_weatherApiSchedule.succeeded(millis());
+	_weatherSeries.setCurrent(result.time, result.temperature);
+	bool changed = _weatherApiTimestamp != result.timestamp;
+	_weatherApiTimestamp = result.timestamp;
+	if (time(nullptr) < MIN_VALID_UNIX_TIME)
+	{
+		// Without system time the temperature can't be interpolated, use the current weather
+		changed |= _weatherApiTemperature != result.temperature;
+		_weatherApiTemperature = result.temperature;
+		_controlWeatherApiTemperature.store(_weatherApiTemperature);
+		return changed;
+	}
+
+	WeatherCache::store(_weatherSeries, _weatherApiTimestamp, time(nullptr));
+	return updateWeatherApiInterpolation() || changed;
 }
 
-/// @brief Update Weather API temperature timer callback
-/// NOTE: The timer registration is handled by updateWeatherApiTemperature since
-/// based on the API response the timer will be restarted with different ticks
-bool updateWeatherApiTemperatureTick(void *opaque)
+/// @brief Takes the result of the background weather API request if one is available and starts
+/// the next request in the background when it is due and the network is connected (non-blocking)
+void updateWeatherApiTemperature()
 {
-	if (updateWeatherApiTemperature() && _webinterface)
+	if (!_weatherFetcher)
 	{
-		_webinterface->setWeatherTemp(_weatherApiTemperature, _weatherApiTimestamp);
+		return;
+	}
+
+	WeatherResult result;
+	if (_weatherFetcher->poll(result))
+	{
+		bool changed = applyWeatherApiResult(result);
+		if (result.successful)
+		{
+			BootSequence.mark(BootStage::FIRST_WEATHER);
+		}
+
+		if (_webinterface)
+		{
+			_webinterface->setWeatherApiStats(result.stats, _weatherApiSchedule.getStats());
+			if (changed)
+				_webinterface->setWeatherTemp(_weatherApiTemperature, _weatherApiTimestamp);
+		}
+		return;
+	}
+
+	bool includeForecast = _weatherForecastSchedule.isDue(millis());
+	bool weatherDue = _weatherApiSchedule.isDue(millis());
+	if (_weatherFetcher->isBusy() || (!includeForecast && !weatherDue))
+	{
+		return;
 	}
 
-	// Stop current timer, a new one is created by updateWeatherApiTemperature depending if failed or successful
-	return false;
+	if (WifiModeChamp.getState() != WifiModeChampState::NETWORK_CONNECTED)
+	{
+		// Attempt stays due and is started as soon as the network is connected, only the due schedules count it as skipped
+		if (weatherDue)
+			_weatherApiSchedule.skip();
+		if (includeForecast)
+			_weatherForecastSchedule.skip();
+		return;
+	}
+
+	// The forecast is requested together with the current weather, so both are using the same connection
+	if (_weatherFetcher->trigger(includeForecast))
+	{
+		_weatherApiSchedule.attempt();
+		if (includeForecast)
+			_weatherForecastSchedule.attempt();
+	}
 }
 
 /// @brief Gets the real input temperature that is used to calculate the power limit and output temperature
 /// @attention Priority: 1st Nanual Temperature, 2nd Weather API, 3rd fallback to Nanual Temperature and NAN if it is not possible to determine a input temperature
+/// @param weatherApiTemperature The temperature of the weather API (NAN if not available)
 /// @return The input temperature or NAN if it is not possible to determine one
-float getInputTemperature()
+float getInputTemperature(float weatherApiTemperature)
 {
 	// Use manual temperature as highest priority
 	if (_config->temperatureConfig->isManualInputTemp()) 
 		return _config->temperatureConfig->getManualInputTemperature();
 	// Use Weather API as preferred input by static setting
-	if (PREFERE_WEATHER_API_OVER_INPUT_SENSOR && !isnanf(_weatherApiTemperature)) 
-		return _weatherApiTemperature;
+	if (PREFERE_WEATHER_API_OVER_INPUT_SENSOR && !isnanf(weatherApiTemperature)) 
+		return weatherApiTemperature;
 	// Use real temperature sensor if Weather API is not preferred by static setting
-	if (!isnanf(_thermistorInTemperature)) 
-		return _thermistorInTemperature;
+	if (!isnanf(_thermistorInput.getTemperature())) 
+		return _thermistorInput.getTemperature();
 	// Use Weather API
-	if (!isnanf(_weatherApiTemperature)) 
-		return _weatherApiTemperature;
+	if (!isnanf(weatherApiTemperature)) 
+		return weatherApiTemperature;
 	
 	// Use the manual temperature as fallback if no API or input sensor value is available
 	return _config->temperatureConfig->getManualInputTemperature();
 }
 
-/// @brief Updates the _outputTemperature based on getInputTemperature()
+/// @brief Updates the _outputTemperature based on the input temperature
+/// @param inputTemperature The input temperature from getInputTemperature()
 /// @return If the value has changed
-bool updateOutputTemperature()
+bool updateOutputTemperature(float inputTemperature)
 {
-	float inputTemperature = getInputTemperature();
 	_targetTemperature = _config->temperatureConfig->getOutputTemperature(inputTemperature);
 
 	bool changed = false;
 	if (!isnanf(_targetTemperature))
 	{
-		float targetResistance = _thermistorOut.resistanceFromCelsius(_targetTemperature);
-		uint16_t posistion = targetResistance >= DIGI_POTI_PRERESISTANCE ? roundf(((targetResistance - DIGI_POTI_PRERESISTANCE) / (DIGI_POTI_RESISTANCE / (DIGI_POTI_STEPS + 1))) - 1) : 0;
-		posistion = constrain(posistion, DIGI_POTI_STEP_MIN, DIGI_POTI_STEPS);
-		float positionResistance = (DIGI_POTI_RESISTANCE / (DIGI_POTI_STEPS + 1)) + (posistion * (DIGI_POTI_RESISTANCE / (DIGI_POTI_STEPS + 1)));
-		float outputResistance = DIGI_POTI_PRERESISTANCE + positionResistance;
-		float outputTemperature = _thermistorOut.celsiusFromResistance(outputResistance);
-		if (_outputTemperature != outputTemperature)
+		auto output = _digitalPotiTable.lookup(_targetTemperature);
+		if (_outputTemperature != output.temperature)
 		{
 #ifdef LOG_DEBUG
-			LOG_DEBUG(F("Main"), F("updateOutputTemperature"), F("targetTemp=") + String(_targetTemperature) + F(" targetResistance=") + String(targetResistance) + F(" posistion=") + String(posistion) + F(" positionResistance=") + String(positionResistance) + F(" outputResistance=") + String(outputResistance) + F(" outputTemperature=") + String(outputTemperature));
+			LOG_DEBUG(F("Main"), F("updateOutputTemperature"), F("targetTemp={} posistion={} outputTemperature={}"), _targetTemperature, output.position, output.temperature);
 #endif
-			_spiDigitalPoti->transfer16(posistion);
-			_outputTemperature = outputTemperature;
+			_spiDigitalPoti->transfer16(output.position);
+			_outputPotiPosition = output.position;
+			_outputTemperature = output.temperature;
 			changed = true;
 		}
 	}
@@ -246,10 +362,15 @@ bool updateOutputTemperature()
 	}
 
 	digitalWrite(GPIO_FAILOVER_OUT, !isnanf(_outputTemperature) ? HIGH : LOW);
+	if (!isnanf(_outputTemperature))
+	{
+		BootSequence.mark(BootStage::FIRST_OUTPUT);
+	}
+
 	return changed;
 }
 
-/// @brief Sets the powerlimit via DAC 0-10V, updates the _powerLimitPercent and webinterface
+/// @brief Sets the powerlimit via DAC 0-10V and updates the _powerLimitPercent
 /// @attention T-Cap need at least a 10% power limit, less is detected as disabled demand control
 /// @param percent The new power limit in %
 /// @param force Force sending the given value to the DAC
@@ -267,24 +388,267 @@ bool setPowerLimit(uint8_t percent, bool force = false)
 	// dac.store(); // save value?
 	_powerLimitPercent = percent;
 #ifdef LOG_DEBUG
-	LOG_DEBUG(F("Main"), F("setPowerLimit"), F("Set power limit to ") + String(_powerLimitPercent) + "%");
+	LOG_DEBUG(F("Main"), F("setPowerLimit"), F("Set power limit to {}%"), _powerLimitPercent);
 #endif
+	return true;
+}
+
+/// @brief Publishes the current control values for the network task
+void publishControlState()
+{
+	ControlState state;
+	state.inputTemperature = _inputTemperature;
+	state.thermistorInTemperature = _thermistorInput.getTemperature();
+	state.thermistorInOutliers = _thermistorInput.getLastOutlierCount();
+	state.thermistorInOutliersTotal = _thermistorInput.getOutlierCount();
+	state.outputTemperature = _outputTemperature;
+	state.targetTemperature = _targetTemperature;
+	state.outputPotiPosition = _outputPotiPosition;
+	state.powerLimitPercent = _powerLimitPercent;
+	_controlState.store(state);
+}
+
+/// @brief Gets if a shown value has changed (NAN is equal to NAN)
+bool isChanged(float value, float shown)
+{
+	return value != shown && !(isnanf(value) && isnanf(shown));
+}
+
+/// @brief Control job (every TEMP_IN_SAMPLE_CYCLE): samples the input thermistor
+void runInputSampling()
+{
+	ProbeScope probe(_probeSample);
+	bool changed = updateThermistorInTemperature();
+	_controlAdcRaw.store(_thermistorInput.getAdcRaw());
+	if (changed)
+	{
+		publishControlState();
+	}
+}
+
+/// @brief Control job (every TEMP_OUT_UPDATE_CYCLE): updates the output temperature
+void runOutputTemperature()
+{
+	ProbeScope probe(_probeOutput);
+	auto oldTargetTemp = _targetTemperature;
+	auto oldInputTemp = _inputTemperature;
+	_inputTemperature = getInputTemperature(_controlWeatherApiTemperature.load());
+	if (updateOutputTemperature(_inputTemperature) || oldTargetTemp != _targetTemperature || isChanged(_inputTemperature, oldInputTemp))
+	{
+		publishControlState();
+	}
+}
+
+/// @brief Control job (every POWER_OUT_UPDATE_CYCLE): updates the power limit
+void runPowerLimit()
+{
+	ProbeScope probe(_probePower);
+	auto inputTemperature = getInputTemperature(_controlWeatherApiTemperature.load());
+	if (setPowerLimit(_config->powerConfig->getOutputPowerLimit(inputTemperature)))
+	{
+		publishControlState();
+	}
+}
+
+/// @brief Control job (every TEMP_OUT_UPDATE_CYCLE): publishes the statistics of the control jobs for the network task
+void runControlJobStats()
+{
+	SchedulerSnapshot<SCHEDULER_JOB_CNT> snapshot;
+	_controlScheduler.getSnapshot(snapshot);
+	_controlJobStats.store(snapshot);
+}
+
+/// @brief Updates the control values inside the webinterface that have changed since the last update
+/// @param force Update all values
+void updateWebinterfaceControlState(bool force)
+{
+	ControlState state;
+	uint32_t version = _controlState.load(state);
+	if (!force && version == _controlStateVersion)
+	{
+		return;
+	}
+
+	if (force || isChanged(state.thermistorInTemperature, _controlStateShown.thermistorInTemperature))
+		_webinterface->setSensorTemp(state.thermistorInTemperature, state.thermistorInOutliers, state.thermistorInOutliersTotal);
+
+	if (force || isChanged(state.outputTemperature, _controlStateShown.outputTemperature) || isChanged(state.targetTemperature, _controlStateShown.targetTemperature))
+		_webinterface->setOutputTemp(state.outputTemperature, state.outputPotiPosition, state.outputTemperature - state.targetTemperature);
+
+	if (force || isChanged(state.targetTemperature, _controlStateShown.targetTemperature))
+		_webinterface->setTargetTemp(state.targetTemperature);
+
+	if (force || state.powerLimitPercent != _controlStateShown.powerLimitPercent)
+		_webinterface->setOuputPowerLimit(_i2cDac ? state.powerLimitPercent : NAN);
+
+	_controlStateShown = state;
+	_controlStateVersion = version;
+}
+
+/// @brief Setup for WiFiManager
+void setupWifiManager();
+
+/// @brief Setup for Web UI
+void setupWebinterface();
+
+/// @brief Setup for Weather API
+void setupWeatherApi();
+
+/// @brief Setup for the history log on LittleFS
+void setupHistoryLog();
+
+/// @brief Runs the next asynchronous boot stage (one per network cycle, so the webinterface and weather API are started step by step)
+/// and marks the boot events that are not bound to a stage
+void updateBootSequence()
+{
+	switch (BootSequence.getStage())
+	{
+	case BootStage::POWER_LIMIT:
+		setupWifiManager();
+		BootSequence.complete(BootStage::NETWORK);
+		break;
+	case BootStage::NETWORK:
+		setupWebinterface();
+		BootSequence.complete(BootStage::WEBINTERFACE);
+		break;
+	case BootStage::WEBINTERFACE:
+		setupWeatherApi();
+		BootSequence.complete(BootStage::WEATHER_API);
+		break;
+	case BootStage::WEATHER_API:
+		setupHistoryLog();
+		BootSequence.complete(BootStage::COMPLETED);
+		break;
+	default:
+		break;
+	}
+
+	if (!BootSequence.isMarked(BootStage::NETWORK_CONNECTED) && WifiModeChamp.getState() == WifiModeChampState::NETWORK_CONNECTED)
+	{
+		BootSequence.mark(BootStage::NETWORK_CONNECTED);
+	}
+}
+
+/// @brief Network job (every TEMP_OUT_UPDATE_CYCLE): updates the weather temperature, control values and system information inside the webinterface
+void updateWebinterface()
+{
+	ProbeScope probe(_probeWebinterface);
+	if (updateWeatherApiInterpolation() && _webinterface)
+	{
+		_webinterface->setWeatherTemp(_weatherApiTemperature, _weatherApiTimestamp);
+	}
+
+	if (!_webinterface)
+	{
+		return;
+	}
+
+	SchedulerSnapshot<SCHEDULER_JOB_CNT> networkJobs;
+	_networkScheduler.getSnapshot(networkJobs);
+	auto controlJobs = _controlJobStats.load();
+	updateWebinterfaceControlState(false);
+	_webinterface->setTaskStats(_controlTask->getStats(), _networkTask->getStats());
+	_webinterface->setJobStats(controlJobs.jobs, controlJobs.count, networkJobs.jobs, networkJobs.count);
+	_webinterface->updateSystemInformation();
+}
+
+/// @brief Network job (every WEBINTERFACE_FRAME_CYCLE): sends the labels of the webinterface that have changed within the frame
+void flushWebinterface()
+{
 	if (_webinterface)
 	{
-		_webinterface->setOuputPowerLimit(_powerLimitPercent);
+		_webinterface->flush();
 	}
+}
 
-	return true;
+/// @brief Network job (every 1000 / TELEMETRY_RATE_MAX ms): sends the live values to the clients of the binary telemetry stream
+void updateTelemetryStream()
+{
+	if (!_webinterface || !_webinterface->hasTelemetryClients())
+	{
+		return;
+	}
+
+	ControlState state;
+	_controlState.load(state);
+	TelemetryFrame frame;
+	frame.time = millis();
+	frame.sequence = _telemetrySequence++;
+	frame.adcRaw = _controlAdcRaw.load();
+	frame.input = state.thermistorInTemperature;
+	frame.weather = _weatherApiTemperature;
+	frame.target = state.targetTemperature;
+	frame.output = state.outputTemperature;
+	frame.potiPosition = state.outputPotiPosition;
+	frame.powerLimit = state.powerLimitPercent;
+	frame.version = TELEMETRY_FRAME_VERSION;
+	_webinterface->streamTelemetry(frame);
 }
 
-/// @brief Put your main code here, to run repeatedly:
-void loop()
+/// @brief Network job (every HISTORY_UPDATE_CYCLE): adds the input and output temperature to the history and writes the completed minutes
+/// to the history log once the system time is known
+void updateHistory()
 {
-	_timers.tick();
+	ControlState state;
+	_controlState.load(state);
+	float values[HISTORY_CHANNEL_CNT] = {state.inputTemperature, state.outputTemperature};
+	uint32_t uptime = esp_timer_get_time() / 1000000LL;
+	_history.add(uptime, values);
+
+	time_t now = time(nullptr);
+	if (now >= MIN_VALID_UNIX_TIME)
+	{
+		_historyLog.update(_history, now - uptime);
+	}
+}
+
+/// @brief Network job (every CONFIG_STORE_UPDATE_CYCLE): commits the configuration changes after the quiet period
+void updateConfiguration()
+{
+	_config->store->update();
+}
+
+/// @brief One cycle of the network task (every NETWORK_TASK_CYCLE): boot stages, webinterface updates, weather API and WiFi
+void updateNetwork()
+{
+	ProbeScope probe(_probeNetwork);
+	updateBootSequence();
+	_networkScheduler.tick();
+	_probeWeatherApi.begin();
+	updateWeatherApiTemperature();
+	_probeWeatherApi.end();
+	_probeWifi.begin();
 	WifiModeChamp.loop();
+	_probeWifi.end();
+}
+
+/// @brief The Arduino loop is not used, control and network are running inside their own tasks (see setupTasks())
+void loop()
+{
+	vTaskDelete(nullptr);
+}
+
+/// @brief Setup for the cached weather of the last run (software reset), so the output can use it immediately
+/// while the live refresh is started in the background later on
+void setupWeatherCache()
+{
+	time_t now = time(nullptr);
+	if (now < MIN_VALID_UNIX_TIME)
+	{
+		// System time is unknown after the reset, the time when the cache has been stored is the best known lower bound
+		now = WeatherCache::getSavedAt();
+		setSystemTime(now);
+	}
+
+	if (WeatherCache::load(_weatherSeries, _weatherApiTimestamp, now, WEATHER_CACHE_MAX_AGE) && updateWeatherApiInterpolation())
+	{
+#ifdef LOG_INFO
+		LOG_INFO(F("Main"), F("setupWeatherCache"), F("initial temperature from cache {}"), _weatherApiTemperature);
+#endif
+	}
 }
 
-/// @brief Setup for Weather API with blocking initial request
+/// @brief Setup for Weather API, all requests are running in the background
 void setupWeatherApi()
 {
 #ifdef LOG_DEBUG
@@ -302,16 +666,16 @@ void setupWeatherApi()
 	if (WEATHER_CITY_ID > 0)
 	{
 #ifdef LOG_INFO
-		LOG_INFO(F("Main"), F("setupWeatherApi"), F("Using City ID ") + WEATHER_CITY_ID);
+		LOG_INFO(F("Main"), F("setupWeatherApi"), F("Using City ID {}"), WEATHER_CITY_ID);
 #endif
-		_weatherApi = new OpenWeatherMap(apiKey, WEATHER_CITY_ID);
+		_weatherApi = new OpenWeatherMap(apiKey, WEATHER_CITY_ID, WEATHER_API_URL);
 	}
 	else if (abs(WEATHER_LATITUDE) > 0 && abs(WEATHER_LONGITUDE) > 0)
 	{
 #ifdef LOG_INFO
-		LOG_INFO(F("Main"), F("setupWeatherApi"), F("Using Latitude ") + WEATHER_LATITUDE + F(" and Longitude ") + WEATHER_LONGITUDE);
+		LOG_INFO(F("Main"), F("setupWeatherApi"), F("Using Latitude {} and Longitude {}"), WEATHER_LATITUDE, WEATHER_LONGITUDE);
 #endif
-		_weatherApi = new OpenWeatherMap(apiKey, WEATHER_LATITUDE, WEATHER_LONGITUDE);
+		_weatherApi = new OpenWeatherMap(apiKey, WEATHER_LATITUDE, WEATHER_LONGITUDE, WEATHER_API_URL);
 	}
 	else
 	{
@@ -321,14 +685,20 @@ void setupWeatherApi()
 		return;
 	}
 #ifdef LOG_DEBUG
-	LOG_DEBUG(F("Main"), F("setupWeatherApi"), F("API URL ") + _weatherApi->apiUrl);
+	LOG_DEBUG(F("Main"), F("setupWeatherApi"), F("API URL {}"), _weatherApi->apiUrl);
 #endif
-	if (updateWeatherApiTemperature())
+	_weatherApi->setTimeout(WEATHER_API_TIMEOUT);
+	_weatherFetcher = new WeatherFetcher(_weatherApi);
+	if (!_weatherFetcher->begin())
 	{
-#ifdef LOG_INFO
-		LOG_INFO(F("Main"), F("setupWeatherApi"), F("initial temperature ") + _weatherApiTemperature);
+#ifdef LOG_ERROR
+		LOG_ERROR(F("Main"), F("setupWeatherApi"), F("Weather API task could not be created, weather API can't be used!"));
 #endif
+		delete _weatherFetcher;
+		_weatherFetcher = nullptr;
+		return;
 	}
+
 }
 
 /// @brief Setup reading of input thermistor with blocking initial reading
@@ -338,27 +708,40 @@ void setupThermistorInputReading()
 	LOG_DEBUG(F("Main"), F("setupThermistorInputReading"), F("Started"));
 #endif
 
+	_adcCorrection.begin(ADC_USE_EFUSE_CALIBRATION);
+	_adcSampler = nullptr;
+	if (TEMP_IN_CONTINUOUS_SAMPLING)
+	{
+		_adcSampler = new AdcContinuousSampler(GPIO_THERMISTOR_IN);
+		if (!_adcSampler->begin())
+		{
+			delete _adcSampler;
+			_adcSampler = nullptr;
+		}
+	}
+
+	if (!_adcSampler)
+	{
+		_adcSampler = new AdcPollingSampler(GPIO_THERMISTOR_IN);
+		_adcSampler->begin();
+	}
+#ifdef LOG_INFO
+	LOG_INFO(F("Main"), F("setupThermistorInputReading"), F("ADC calibration {} sampling {}"), _adcCorrection.getSourceName(), _adcSampler->getName());
+#endif
+
 	// Configure failover output pin an enable it 
 	pinMode(GPIO_FAILOVER_IN, OUTPUT);
 	digitalWrite(GPIO_FAILOVER_IN, HIGH);
 
 	delay(100); // Wait a littlebit of time after relai has been turned on, so we can read initial temperature
-	_thermistorInTemperature = getCurrentThermistorInTemperature(true);
+	float temperature = _thermistorInput.begin(_adcSampler);
+#ifdef LOG_ERROR
+	if (isnanf(temperature))
+		LOG_ERROR(F("Main"), F("setupThermistorInputReading"), F("Input thermistor not available, devider resistor defect or no sensor connected? voltage={}"), _thermistorInput.getVoltage());
+#endif
 #ifdef LOG_DEBUG
-	LOG_DEBUG(F("Main"), F("setupThermistorInputReading"), F("Inital in termperature=") + _thermistorInTemperature);
+	LOG_DEBUG(F("Main"), F("setupThermistorInputReading"), F("Inital in termperature={}"), temperature);
 #endif
-	_timers.every(
-		TEMP_IN_SAMPLE_CYCLE,
-		[](void *opaque) -> bool
-		{
-			if (updateThermistorInTemperature() && _webinterface)
-			{
-				_webinterface->setSensorTemp(_thermistorInTemperature);
-			}
-
-			return true; // Keep timer running
-		});
-
 #ifdef LOG_DEBUG
 	LOG_DEBUG(F("Main"), F("setupThermistorInputReading"), F("Completed"));
 #endif
@@ -377,25 +760,7 @@ void setupOutputTemperature()
 	pinMode(_spiDigitalPoti->pinSS(), OUTPUT);
 	pinMode(GPIO_FAILOVER_OUT, OUTPUT);
 
-	updateOutputTemperature();
-	_timers.every(
-		TEMP_OUT_UPDATE_CYCLE,
-		[](void *opaque) -> bool
-		{
-			if (_webinterface)
-			{
-				auto oldTargetTemp = _targetTemperature;
-				if(updateOutputTemperature())
-					_webinterface->setOutputTemp(_outputTemperature);
-				
-				if(oldTargetTemp != _targetTemperature)
-					_webinterface->setTargetTemp(_targetTemperature);
-
-				_webinterface->updateSystemInformation();
-			}
-
-			return true;
-		});
+	updateOutputTemperature(getInputTemperature(_weatherApiTemperature));
 #ifdef LOG_DEBUG
 	LOG_DEBUG(F("Main"), F("setupOutputTemperature"), F("Completed"));
 #endif
@@ -423,20 +788,62 @@ void setupPowerLimit()
 		LOG_DEBUG(F("Main"), F("setupPowerLimit"), F("Successful init 0-10V output via I2C"));
 #endif
 		setPowerLimit(_powerLimitPercent, true); // initially set to 0% (disable power limit)
-		_timers.every(
-			POWER_OUT_UPDATE_CYCLE,
-			[](void *opaque) -> bool
-			{
-				auto inputTemperature = getInputTemperature();
-				auto powerLimit = _config->powerConfig->getOutputPowerLimit(inputTemperature);
-				if (setPowerLimit(powerLimit) && _webinterface)
-				{
-					_webinterface->setOuputPowerLimit(_powerLimitPercent);
-				}
+	}
+}
+
+/// @brief Setup of the control task (fixed period on CONTROL_TASK_CORE) and the network task (on NETWORK_TASK_CORE),
+/// both tasks are only exchanging the control values and the weather API temperature via SharedState snapshots
+void setupTasks()
+{
+#ifdef LOG_DEBUG
+	LOG_DEBUG(F("Main"), F("setupTasks"), F("Started"));
+#endif
+
+	publishControlState();
+	bool scheduled = true;
+	scheduled &= _controlScheduler.every("Sample", TEMP_IN_SAMPLE_CYCLE, runInputSampling);
+	scheduled &= _controlScheduler.every("Output", TEMP_OUT_UPDATE_CYCLE, runOutputTemperature, TEMP_OUT_UPDATE_CYCLE);
+	if (_i2cDac)
+		scheduled &= _controlScheduler.every("Power", POWER_OUT_UPDATE_CYCLE, runPowerLimit, POWER_OUT_UPDATE_CYCLE);
+	scheduled &= _controlScheduler.every("Stats", TEMP_OUT_UPDATE_CYCLE, runControlJobStats, TEMP_OUT_UPDATE_CYCLE);
+	scheduled &= _networkScheduler.every("Webinterface", TEMP_OUT_UPDATE_CYCLE, updateWebinterface);
+	scheduled &= _networkScheduler.every("UI Frame", WEBINTERFACE_FRAME_CYCLE, flushWebinterface);
+	scheduled &= _networkScheduler.every("Telemetry", 1000 / TELEMETRY_RATE_MAX, updateTelemetryStream);
+	scheduled &= _networkScheduler.every("History", HISTORY_UPDATE_CYCLE, updateHistory);
+	scheduled &= _networkScheduler.every("Config", CONFIG_STORE_UPDATE_CYCLE, updateConfiguration);
+	if (!scheduled)
+	{
+#ifdef LOG_ERROR
+		LOG_ERROR(F("Main"), F("setupTasks"), F("Scheduler is full, SCHEDULER_JOB_CNT is too small, restarting!"));
+#endif
+		ESP.restart();
+	}
+
+	_controlTask = new PeriodicTask("Control", TEMP_IN_SAMPLE_CYCLE, []()
+		{
+			ProbeScope probe(_probeControl);
+			_controlScheduler.tick();
+		});
+	if (!_controlTask->begin(CONTROL_TASK_STACK_SIZE, CONTROL_TASK_PRIORITY, CONTROL_TASK_CORE))
+	{
+#ifdef LOG_ERROR
+		LOG_ERROR(F("Main"), F("setupTasks"), F("Control task could not be created, restarting!"));
+#endif
+		ESP.restart();
+	}
 
-				return true;
-			});
+	_networkTask = new PeriodicTask("Network", NETWORK_TASK_CYCLE, updateNetwork);
+	if (!_networkTask->begin(NETWORK_TASK_STACK_SIZE, NETWORK_TASK_PRIORITY, NETWORK_TASK_CORE))
+	{
+#ifdef LOG_ERROR
+		LOG_ERROR(F("Main"), F("setupTasks"), F("Network task could not be created, restarting!"));
+#endif
+		ESP.restart();
 	}
+
+#ifdef LOG_DEBUG
+	LOG_DEBUG(F("Main"), F("setupTasks"), F("Completed"));
+#endif
 }
 
 /// @brief Setup for the configuration for loading and storing none volatile data
@@ -448,12 +855,18 @@ void setupConfiguration()
 
 	_config = new Config();
 
+	// Pending changes are written before a restart (e.g. after an OTA update or new WiFi credentials)
+	esp_register_shutdown_handler([]()
+		{
+			_config->store->commit();
+		});
+
 #ifdef LOG_DEBUG
 	LOG_DEBUG(F("Main"), F("setupConfiguration"), F("Completed"));
 #endif
 }
 
-/// @brief Setup for Web UI (called by setupWifiManager after auto connect)
+/// @brief Setup for Web UI (called by updateBootSequence after the network has been started)
 void setupWebinterface()
 {
 #ifdef LOG_DEBUG
@@ -462,27 +875,34 @@ void setupWebinterface()
 
 	// Creaate webinterface
 	_webinterface = new Webinterface(80, _config);
+	_webinterface->setHistory(&_history);
+	_webinterface->setHistoryLog(&_historyLog);
 
 	// Set initial values
-	_webinterface->setSensorTemp(_thermistorInTemperature);
 	_webinterface->setWeatherTemp(_weatherApiTemperature, _weatherApiTimestamp);
-	_webinterface->setOutputTemp(_outputTemperature);
-	_webinterface->setTargetTemp(_targetTemperature);
-	if (_i2cDac)
-	{
-		_webinterface->setOuputPowerLimit(_powerLimitPercent);
-	}
-	else
-	{
-		_webinterface->setOuputPowerLimit(NAN);
-	}
+	updateWebinterfaceControlState(true);
 
 #ifdef LOG_DEBUG
 	LOG_DEBUG(F("Main"), F("setupWebinterface"), F("Completed"));
 #endif
 }
 
-/// @brief Setup for WiFiManager as blocking implementation if configured.
+/// @brief Setup for the history log (called by updateBootSequence after the weather API, the first mount may format LittleFS),
+/// the buffered records are written on a restart (e.g. after an OTA update)
+void setupHistoryLog()
+{
+	if (!_historyLog.begin())
+	{
+		return;
+	}
+
+	esp_register_shutdown_handler([]()
+		{
+			_historyLog.flush();
+		});
+}
+
+/// @brief Setup for WiFiManager, the connection is established in the background by WifiModeChamp.loop()
 void setupWifiManager()
 {
 #ifdef LOG_DEBUG
@@ -490,20 +910,23 @@ void setupWifiManager()
 	WifiModeChamp.listen(
 		[](__unused WifiModeChampState previous, WifiModeChampState state)
 		{
-			LOG_DEBUG(F("Main"), F("WifiModeChamp.listen"), F("State changed from ") + WifiModeChamp.getStateName(previous) + F(" to ") + WifiModeChamp.getStateName(state));
+			LOG_DEBUG(F("Main"), F("WifiModeChamp.listen"), F("State changed from {} to {}"), WifiModeChamp.getStateName(previous), WifiModeChamp.getStateName(state));
 		});
 #endif
 
 	WifiModeChamp.setReconnectTimeout(120);
     WifiModeChamp.setConnectTimeout(30);
     WifiModeChamp.setWifiScanWaitTime(30);
-	WifiModeChamp.begin("T-Cap Champ", true, WIFI_CONFIG_PASSWORD);
+	WifiModeChamp.begin("T-Cap Champ", false, WIFI_CONFIG_PASSWORD);
 }
 
 /// @brief Put your setup code here, to run once:
 void setup()
 {
 	Serial.begin(115200);
+#if DEFERRED_LOG_ENABLED
+	DeferredLog.begin();
+#endif
 
 #ifdef LOG_ERROR
 	delay(3000);
@@ -512,13 +935,19 @@ void setup()
 	LOG_DEBUG(F("Main"), F("setup"), F("Started"));
 #endif
 
+	// Output control comes up first from the sensor or cached values, network, webinterface
+	// and weather API are started afterwards by updateBootSequence() inside the network task
 	setupConfiguration();
-	setupWifiManager();
-	setupWeatherApi();
-	setupPowerLimit();
+	BootSequence.complete(BootStage::CONFIG);
+	setupWeatherCache();
+	BootSequence.complete(BootStage::WEATHER_CACHE);
 	setupThermistorInputReading();
+	BootSequence.complete(BootStage::INPUT_SENSOR);
 	setupOutputTemperature();
-	setupWebinterface();
+	BootSequence.complete(BootStage::OUTPUT_CONTROL);
+	setupPowerLimit();
+	BootSequence.complete(BootStage::POWER_LIMIT);
+	setupTasks();
 
 #ifdef LOG_DEBUG
 	LOG_DEBUG(F("Main"), F("setup"), F("Completed"));
@@ -0,0 +1,194 @@
+#pragma once
+
+// Host stub of the Arduino core, only the parts that are used by the units covered by the native tests
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <assert.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+#include "esp_timer.h"
+
+using std::max;
+using std::min;
+
+#if defined(__GLIBC__) && !(__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 38))
+/// @brief BSD strlcpy of newlib, glibc provides it since 2.38
+inline size_t strlcpy(char *dst, const char *src, size_t size)
+{
+    size_t length = strlen(src);
+    if (size > 0)
+    {
+        size_t count = length < size - 1 ? length : size - 1;
+        memcpy(dst, src, count);
+        dst[count] = '\0';
+    }
+    return length;
+}
+#endif
+
+inline unsigned long micros()
+{
+    return (unsigned long)esp_timer_get_time();
+}
+
+inline unsigned long millis()
+{
+    return (unsigned long)(esp_timer_get_time() / 1000);
+}
+
+/// @brief Advances the simulated time
+inline void delay(uint32_t ms)
+{
+    EspTimerStubTime += ms * 1000LL;
+}
+
+inline void yield() {}
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+/// @brief Arduino String on top of std::string
+class String
+{
+private:
+    std::string _value;
+
+    static std::string format(const char *format, double value, unsigned int decimalPlaces)
+    {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), format, decimalPlaces, value);
+        return buffer;
+    }
+
+public:
+    String(const char *value = "") : _value(value ? value : "") {}
+    String(const std::string &value) : _value(value) {}
+    explicit String(char value) : _value(1, value) {}
+    explicit String(unsigned char value) : _value(std::to_string(value)) {}
+    explicit String(int value) : _value(std::to_string(value)) {}
+    explicit String(unsigned int value) : _value(std::to_string(value)) {}
+    explicit String(long value) : _value(std::to_string(value)) {}
+    explicit String(unsigned long value) : _value(std::to_string(value)) {}
+    explicit String(float value, unsigned int decimalPlaces = 2) : _value(format("%.*f", value, decimalPlaces)) {}
+    explicit String(double value, unsigned int decimalPlaces = 2) : _value(format("%.*f", value, decimalPlaces)) {}
+
+    const char *c_str() const { return _value.c_str(); }
+    unsigned int length() const { return _value.length(); }
+    bool isEmpty() const { return _value.empty(); }
+    char operator[](unsigned int index) const { return index < _value.length() ? _value[index] : 0; }
+
+    int indexOf(char c, unsigned int from = 0) const
+    {
+        auto pos = _value.find(c, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+
+    int indexOf(const String &value, unsigned int from = 0) const
+    {
+        auto pos = _value.find(value._value, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+
+    String substring(unsigned int from) const { return from < _value.length() ? _value.substr(from) : std::string(); }
+    String substring(unsigned int from, unsigned int to) const { return from < to && from < _value.length() ? _value.substr(from, to - from) : std::string(); }
+    bool startsWith(const String &prefix) const { return _value.compare(0, prefix._value.length(), prefix._value) == 0; }
+    long toInt() const { return atol(_value.c_str()); }
+    float toFloat() const { return atof(_value.c_str()); }
+
+    bool concat(const String &value)
+    {
+        _value += value._value;
+        return true;
+    }
+
+    template <typename T>
+    String &operator+=(const T &value)
+    {
+        concat(String(value));
+        return *this;
+    }
+
+    template <typename T>
+    String operator+(const T &value) const
+    {
+        String result(*this);
+        result.concat(String(value));
+        return result;
+    }
+
+    friend String operator+(const char *lhs, const String &rhs) { return String(lhs) + rhs; }
+    bool operator==(const String &other) const { return _value == other._value; }
+    bool operator!=(const String &other) const { return _value != other._value; }
+    bool operator<(const String &other) const { return _value < other._value; }
+};
+
+inline const String emptyString;
+
+/// @brief Arduino Stream, the waiting of readBytes() advances the simulated time
+class Stream
+{
+protected:
+    unsigned long _timeout = 1000;
+    unsigned long _startMillis = 0;
+
+    int timedRead()
+    {
+        _startMillis = millis();
+        do
+        {
+            int c = read();
+            if (c >= 0)
+                return c;
+            delay(1);
+        } while (millis() - _startMillis < _timeout);
+        return -1;
+    }
+
+public:
+    virtual ~Stream() {}
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual size_t write(uint8_t) = 0;
+
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        size_t written = 0;
+        while (written < size && write(buffer[written]))
+            written++;
+        return written;
+    }
+
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    unsigned long getTimeout() const { return _timeout; }
+
+    virtual size_t readBytes(char *buffer, size_t length)
+    {
+        size_t count = 0;
+        while (count < length)
+        {
+            int c = timedRead();
+            if (c < 0)
+                break;
+            buffer[count++] = (char)c;
+        }
+        return count;
+    }
+
+    size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
+};
+
+/// @brief Heap statistics of the ESP32
+class EspClass
+{
+public:
+    uint32_t getFreeHeap() { return 200000; }
+};
+
+inline EspClass ESP;
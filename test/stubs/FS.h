@@ -0,0 +1,166 @@
+#pragma once
+
+// Host emulation of the Arduino FS API in RAM with a flash cost model of LittleFS on the ESP32 (4 KB blocks, 256 byte
+// program pages), so the wear of a writer can be measured:
+// - the data of a write session is committed on close, the partially filled tail block of the file is copied together
+//   with the new data into new blocks (copy on write of the CTZ skip list)
+// - each commit and each remove adds one metadata entry (one program page), a full metadata block is compacted
+//   (one erase, two program pages)
+
+#include <Arduino.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+/// @brief Flash counters of the emulation
+struct FlashStubStats
+{
+    /// @brief Programmed bytes (data and metadata)
+    uint64_t programmed = 0;
+
+    /// @brief Erased blocks
+    uint32_t erases = 0;
+
+    /// @brief Used bytes of the current metadata block
+    uint32_t metadata = 0;
+};
+
+/// @brief Flash of the emulation: the files and the counters
+class FlashStub
+{
+public:
+    static constexpr size_t BLOCK_SIZE = 4096;
+    static constexpr size_t PROGRAM_SIZE = 256;
+
+    /// @brief Content of the files by path
+    static inline std::map<std::string, std::shared_ptr<std::string>> files;
+
+    /// @brief Flash counters
+    static inline FlashStubStats stats;
+
+    /// @brief Writes fail (e.g. flash full)
+    static inline bool failWrites = false;
+
+    /// @brief Called once by the next write, e.g. to run another task while the writer is inside the file system
+    static inline std::function<void()> onWrite;
+
+    /// @brief Removes all files and resets the counters
+    static void reset()
+    {
+        files.clear();
+        stats = FlashStubStats();
+        failWrites = false;
+        onWrite = nullptr;
+    }
+
+    /// @brief Commits one metadata entry
+    static void commitMetadata()
+    {
+        stats.programmed += PROGRAM_SIZE;
+        stats.metadata += PROGRAM_SIZE;
+        if (stats.metadata >= BLOCK_SIZE)
+        {
+            stats.erases++;
+            stats.programmed += PROGRAM_SIZE * 2;
+            stats.metadata = PROGRAM_SIZE * 2;
+        }
+    }
+
+    /// @brief Commits appended data to a file
+    static void commitData(std::string &file, const std::string &data)
+    {
+        size_t tail = file.size() % BLOCK_SIZE;
+        size_t bytes = tail + data.size();
+        stats.erases += (bytes + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        stats.programmed += (bytes + PROGRAM_SIZE - 1) / PROGRAM_SIZE * PROGRAM_SIZE;
+        file += data;
+        commitMetadata();
+    }
+};
+
+namespace fs
+{
+    class File
+    {
+    private:
+        std::string _path;
+        std::shared_ptr<std::string> _data;
+        bool _directory = false;
+        bool _append = false;
+        size_t _position = 0;
+        std::string _pending;
+        std::vector<std::string> _children;
+        size_t _child = 0;
+
+    public:
+        File() {}
+
+        /// @brief Opens a file
+        File(const std::string &path, std::shared_ptr<std::string> data, bool append) : _path(path), _data(data), _append(append) {}
+
+        /// @brief Opens a directory with the paths of its files
+        File(const std::string &path, const std::vector<std::string> &children) : _path(path), _directory(true), _children(children) {}
+
+        explicit operator bool() const { return _directory || _data; }
+        const char *name() const { return _path.c_str(); }
+        bool isDirectory() const { return _directory; }
+        size_t size() const { return _data ? _data->size() + _pending.size() : 0; }
+        size_t position() const { return _position; }
+
+        bool seek(uint32_t position)
+        {
+            if (!_data || position > _data->size())
+                return false;
+            _position = position;
+            return true;
+        }
+
+        size_t read(uint8_t *buffer, size_t size)
+        {
+            if (!_data || _position >= _data->size())
+                return 0;
+            size_t count = std::min(size, _data->size() - _position);
+            memcpy(buffer, _data->data() + _position, count);
+            _position += count;
+            return count;
+        }
+
+        size_t write(const uint8_t *buffer, size_t size)
+        {
+            if (FlashStub::onWrite)
+            {
+                auto callback = FlashStub::onWrite;
+                FlashStub::onWrite = nullptr;
+                callback();
+            }
+
+            if (!_data || !_append || FlashStub::failWrites)
+                return 0;
+            _pending.append(reinterpret_cast<const char *>(buffer), size);
+            return size;
+        }
+
+        void close()
+        {
+            if (_data && !_pending.empty())
+                FlashStub::commitData(*_data, _pending);
+            _pending.clear();
+            _data.reset();
+            _directory = false;
+        }
+
+        File openNextFile()
+        {
+            if (_child >= _children.size())
+                return File();
+            auto &path = _children[_child++];
+            return File(path, FlashStub::files[path], false);
+        }
+    };
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+// Host stub of the Arduino HTTPClient (GET only), the response header is read with the same inactivity timeout
+// as the ESP32 implementation: the header has to arrive without a gap longer than setTimeout()
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "WiFiClient.h"
+
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_NOT_FOUND 404
+#define HTTP_CODE_REQUEST_TIMEOUT 408
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+class HTTPClient
+{
+private:
+    WiFiClient *_client = nullptr;
+    std::string _host;
+    uint16_t _port = 80;
+    std::string _path;
+    uint16_t _tcpTimeout = 5000;
+    int32_t _connectTimeout = 5000;
+    bool _reuse = true;
+    bool _canReuse = false;
+    std::vector<std::string> _collect;
+    std::map<std::string, std::string> _headers;
+
+public:
+    bool begin(WiFiClient &client, const String &url)
+    {
+        std::string value = url.c_str();
+        size_t hostStart = value.find("://") + 3;
+        size_t pathStart = value.find('/', hostStart);
+        _host = value.substr(hostStart, pathStart - hostStart);
+        _path = value.substr(pathStart);
+        _port = value.compare(0, 5, "https") == 0 ? 443 : 80;
+        size_t portStart = _host.find(':');
+        if (portStart != std::string::npos)
+        {
+            _port = atoi(_host.c_str() + portStart + 1);
+            _host = _host.substr(0, portStart);
+        }
+
+        _client = &client;
+        _headers.clear();
+        return true;
+    }
+
+    void setReuse(bool reuse) { _reuse = reuse; }
+    void useHTTP10(bool) {}
+    void setConnectTimeout(int32_t timeout) { _connectTimeout = timeout; }
+    void setTimeout(uint16_t timeout) { _tcpTimeout = timeout; }
+
+    void collectHeaders(const char *headerKeys[], const size_t headerKeysCount)
+    {
+        _collect.assign(headerKeys, headerKeys + headerKeysCount);
+    }
+
+    String header(const char *name)
+    {
+        auto it = _headers.find(name);
+        return it == _headers.end() ? String() : String(it->second);
+    }
+
+    int GET()
+    {
+        if (!_client)
+            return HTTPC_ERROR_NOT_CONNECTED;
+        if (!_client->connected() && !_client->connect(_host.c_str(), _port, _connectTimeout))
+            return HTTPC_ERROR_CONNECTION_REFUSED;
+
+        std::string request = "GET " + _path + " HTTP/1.0\r\nHost: " + _host + "\r\nConnection: keep-alive\r\n\r\n";
+        if (_client->write((const uint8_t *)request.data(), request.size()) != request.size())
+            return HTTPC_ERROR_SEND_HEADER_FAILED;
+
+        _canReuse = _reuse;
+        int code = HTTPC_ERROR_CONNECTION_LOST;
+        std::string line;
+        unsigned long lastData = millis();
+        while (_client->connected())
+        {
+            if (_client->available() <= 0)
+            {
+                if (millis() - lastData > _tcpTimeout)
+                    return HTTPC_ERROR_READ_TIMEOUT;
+                delay(1);
+                continue;
+            }
+
+            lastData = millis();
+            char c = _client->read();
+            if (c != '\n')
+            {
+                if (c != '\r')
+                    line += c;
+                continue;
+            }
+
+            if (line.empty())
+                return code;
+
+            if (line.compare(0, 5, "HTTP/") == 0)
+            {
+                code = atoi(line.c_str() + line.find(' ') + 1);
+            }
+            else
+            {
+                size_t separator = line.find(": ");
+                std::string name = line.substr(0, separator);
+                std::string value = line.substr(separator + 2);
+                if (name == "Connection" && value.find("close") != std::string::npos)
+                    _canReuse = false;
+                for (auto &key : _collect)
+                {
+                    if (key == name)
+                        _headers[name] = value;
+                }
+            }
+
+            line.clear();
+        }
+
+        return HTTPC_ERROR_CONNECTION_LOST;
+    }
+
+    WiFiClient &getStream() { return *_client; }
+
+    void end()
+    {
+        if (_client && !(_reuse && _canReuse))
+            _client->stop();
+    }
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+// Local HTTP stand-in for the native tests: a scripted server that answers the requests of the WiFiClient stub
+// with raw HTTP responses on the simulated clock, so that slow connects, headers and bodies can be reproduced
+
+#include <Arduino.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+/// @brief Scripted response of the stand-in, the delays are applied on the simulated clock
+struct HttpStandInResponse
+{
+    /// @brief HTTP status code
+    int code = 200;
+
+    /// @brief Value of the Date header (no header if empty)
+    std::string date;
+
+    /// @brief Response body
+    std::string body;
+
+    /// @brief Duration of the TCP connect (and TLS handshake) in ms, if the request needs a new connection
+    uint32_t connectDelay = 0;
+
+    /// @brief Time from the request until the response header is sent in ms
+    uint32_t headerDelay = 0;
+
+    /// @brief Stall in the middle of the body in ms
+    uint32_t bodyStall = 0;
+
+    /// @brief The server closes the connection after the response (otherwise keep-alive)
+    bool close = false;
+};
+
+/// @brief Data that becomes available on the connection at the given time
+struct HttpStandInSegment
+{
+    int64_t time;
+    std::string data;
+};
+
+/// @brief The stand-in server, reachable by the WiFiClient stub at HttpStandIn::host:HttpStandIn::port
+class HttpStandIn
+{
+public:
+    /// @brief Host of the stand-in
+    static inline std::string host = "127.0.0.1";
+
+    /// @brief Port of the stand-in
+    static inline uint16_t port = 8080;
+
+    /// @brief Responses for the next requests in order, without a response the server answers 404
+    static inline std::deque<HttpStandInResponse> responses;
+
+    /// @brief Request lines that have been received ("GET /path HTTP/1.0")
+    static inline std::vector<std::string> requests;
+
+    /// @brief Amount of established connections
+    static inline uint32_t connects = 0;
+
+    /// @brief Removes the scripted responses and the received requests
+    static void reset()
+    {
+        responses.clear();
+        requests.clear();
+        connects = 0;
+    }
+
+    /// @brief Gets the connect delay of the next response
+    static uint32_t getConnectDelay()
+    {
+        return responses.empty() ? 0 : responses.front().connectDelay;
+    }
+
+    /// @brief Handles a complete request and schedules the response segments
+    /// @param request the raw request (request line and header)
+    /// @param segments the segments of the connection
+    /// @return if the server closes the connection after the response
+    static bool handle(const std::string &request, std::deque<HttpStandInSegment> &segments)
+    {
+        requests.push_back(request.substr(0, request.find("\r\n")));
+        HttpStandInResponse response;
+        if (!responses.empty())
+        {
+            response = responses.front();
+            responses.pop_front();
+        }
+        else
+        {
+            response.code = 404;
+            response.body = "{\"cod\":\"404\",\"message\":\"not found\"}";
+        }
+
+        std::string header = "HTTP/1.1 " + std::to_string(response.code) + (response.code == 200 ? " OK" : " Error") + "\r\n";
+        header += "Content-Type: application/json; charset=utf-8\r\n";
+        header += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+        if (!response.date.empty())
+            header += "Date: " + response.date + "\r\n";
+        header += response.close ? "Connection: close\r\n\r\n" : "Connection: keep-alive\r\n\r\n";
+
+        int64_t time = esp_timer_get_time() + response.headerDelay * 1000LL;
+        size_t half = response.body.size() / 2;
+        segments.push_back({time, header + response.body.substr(0, half)});
+        segments.push_back({time + response.bodyStall * 1000LL, response.body.substr(half)});
+        return response.close;
+    }
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+// Host stub of LittleFS on top of the flash emulation of FS.h
+
+#include "FS.h"
+
+class LittleFSFS
+{
+public:
+    bool begin(bool formatOnFail = false) { return true; }
+    bool mkdir(const char *path) { return true; }
+    bool exists(const char *path) { return FlashStub::files.count(path) > 0; }
+    size_t usedBytes() { return 0; }
+    size_t totalBytes() { return 0; }
+
+    fs::File open(const char *path, const char *mode = FILE_READ)
+    {
+        std::string name = path;
+        auto it = FlashStub::files.find(name);
+        if (strcmp(mode, FILE_READ) != 0)
+        {
+            if (it == FlashStub::files.end())
+                it = FlashStub::files.emplace(name, std::make_shared<std::string>()).first;
+            else if (strcmp(mode, FILE_WRITE) == 0)
+                it->second->clear();
+            return fs::File(name, it->second, true);
+        }
+
+        if (it != FlashStub::files.end())
+            return fs::File(name, it->second, false);
+
+        // Directory: the files directly inside the path
+        std::vector<std::string> children;
+        std::string prefix = name + "/";
+        for (auto &file : FlashStub::files)
+        {
+            if (file.first.compare(0, prefix.size(), prefix) == 0 && file.first.find('/', prefix.size()) == std::string::npos)
+                children.push_back(file.first);
+        }
+
+        return children.empty() ? fs::File() : fs::File(name, children);
+    }
+
+    bool remove(const char *path)
+    {
+        if (!FlashStub::files.erase(path))
+            return false;
+        FlashStub::commitMetadata();
+        return true;
+    }
+};
+
+inline LittleFSFS LittleFS;
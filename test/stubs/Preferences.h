@@ -0,0 +1,123 @@
+#pragma once
+
+// Host stub of the Arduino Preferences, the NVS is a map in RAM that counts the reads and writes
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+
+/// @brief NVS of the stub: the namespaces with their keys and the access counters
+class NvsStub
+{
+public:
+    /// @brief Values by namespace and key
+    static inline std::map<std::string, std::map<std::string, std::vector<uint8_t>>> namespaces;
+
+    /// @brief Amount of reads (each get, also of missing keys)
+    static inline uint32_t reads = 0;
+
+    /// @brief Amount of writes (each put)
+    static inline uint32_t writes = 0;
+
+    /// @brief Writes fail (e.g. NVS full)
+    static inline bool failWrites = false;
+
+    /// @brief Removes all values and resets the counters
+    static void reset()
+    {
+        namespaces.clear();
+        reads = writes = 0;
+        failWrites = false;
+    }
+};
+
+class Preferences
+{
+private:
+    std::string _name;
+
+    template <typename T>
+    T get(const char *key, T defaultValue)
+    {
+        NvsStub::reads++;
+        auto &values = NvsStub::namespaces[_name];
+        auto it = values.find(key);
+        if (it == values.end() || it->second.size() != sizeof(T))
+            return defaultValue;
+
+        T value;
+        memcpy(&value, it->second.data(), sizeof(value));
+        return value;
+    }
+
+    template <typename T>
+    size_t put(const char *key, T value)
+    {
+        return putBytes(key, &value, sizeof(value));
+    }
+
+public:
+    bool begin(const char *name, bool readOnly = false, const char *partitionLabel = nullptr)
+    {
+        _name = name;
+        return true;
+    }
+
+    void end() {}
+
+    bool clear()
+    {
+        NvsStub::namespaces[_name].clear();
+        return true;
+    }
+
+    bool remove(const char *key)
+    {
+        return NvsStub::namespaces[_name].erase(key) > 0;
+    }
+
+    bool isKey(const char *key)
+    {
+        return NvsStub::namespaces[_name].count(key) > 0;
+    }
+
+    bool getBool(const char *key, bool defaultValue = false) { return get(key, defaultValue); }
+    int8_t getChar(const char *key, int8_t defaultValue = 0) { return get(key, defaultValue); }
+    uint8_t getUChar(const char *key, uint8_t defaultValue = 0) { return get(key, defaultValue); }
+    int16_t getShort(const char *key, int16_t defaultValue = 0) { return get(key, defaultValue); }
+    uint16_t getUShort(const char *key, uint16_t defaultValue = 0) { return get(key, defaultValue); }
+    int32_t getInt(const char *key, int32_t defaultValue = 0) { return get(key, defaultValue); }
+    float getFloat(const char *key, float defaultValue = NAN) { return get(key, defaultValue); }
+
+    size_t putBool(const char *key, bool value) { return put(key, value); }
+    size_t putChar(const char *key, int8_t value) { return put(key, value); }
+    size_t putUChar(const char *key, uint8_t value) { return put(key, value); }
+    size_t putShort(const char *key, int16_t value) { return put(key, value); }
+    size_t putUShort(const char *key, uint16_t value) { return put(key, value); }
+    size_t putInt(const char *key, int32_t value) { return put(key, value); }
+    size_t putFloat(const char *key, float value) { return put(key, value); }
+
+    size_t getBytes(const char *key, void *buffer, size_t length)
+    {
+        NvsStub::reads++;
+        auto &values = NvsStub::namespaces[_name];
+        auto it = values.find(key);
+        if (it == values.end() || it->second.size() > length)
+            return 0;
+
+        memcpy(buffer, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+
+    size_t putBytes(const char *key, const void *value, size_t length)
+    {
+        if (NvsStub::failWrites)
+            return 0;
+
+        NvsStub::writes++;
+        auto data = static_cast<const uint8_t *>(value);
+        NvsStub::namespaces[_name][key].assign(data, data + length);
+        return length;
+    }
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+// Host stub of the Arduino WiFi, the connection state is set by the tests
+
+#include "WiFiClient.h"
+
+typedef enum
+{
+    WL_IDLE_STATUS = 0,
+    WL_CONNECTED = 3,
+    WL_DISCONNECTED = 6,
+} wl_status_t;
+
+class WiFiClass
+{
+public:
+    /// @brief Connection state that is reported
+    wl_status_t stubStatus = WL_CONNECTED;
+
+    wl_status_t status() { return stubStatus; }
+};
+
+inline WiFiClass WiFi;
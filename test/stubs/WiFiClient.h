@@ -0,0 +1,116 @@
+#pragma once
+
+// Host stub of the Arduino WiFiClient, the only reachable server is the HttpStandIn
+
+#include <Arduino.h>
+#include <deque>
+#include <string>
+#include "HttpStandIn.h"
+
+class WiFiClient : public Stream
+{
+private:
+    bool _connected = false;
+    bool _closing = false;
+    std::string _request;
+    std::deque<HttpStandInSegment> _segments;
+
+    /// @brief Gets the segment that is available at the current time
+    HttpStandInSegment *current()
+    {
+        while (!_segments.empty() && _segments.front().data.empty() && _segments.front().time <= esp_timer_get_time())
+            _segments.pop_front();
+        if (_segments.empty() || _segments.front().time > esp_timer_get_time())
+            return nullptr;
+        return &_segments.front();
+    }
+
+public:
+    virtual ~WiFiClient() {}
+
+    virtual int connect(const char *host, uint16_t port, int32_t timeout)
+    {
+        stop();
+        uint32_t duration = HttpStandIn::getConnectDelay();
+        if (host != HttpStandIn::host || port != HttpStandIn::port || duration > (uint32_t)timeout)
+        {
+            delay(timeout);
+            return 0;
+        }
+
+        delay(duration);
+        HttpStandIn::connects++;
+        _connected = true;
+        return 1;
+    }
+
+    int connect(const char *host, uint16_t port)
+    {
+        return connect(host, port, 3000);
+    }
+
+    /// @brief Gets if the connection is open or received data is still available
+    virtual uint8_t connected()
+    {
+        return _connected || available() > 0;
+    }
+
+    virtual void stop()
+    {
+        _connected = false;
+        _closing = false;
+        _request.clear();
+        _segments.clear();
+    }
+
+    size_t write(uint8_t data) override
+    {
+        if (!_connected)
+            return 0;
+
+        _request += (char)data;
+        if (_request.size() >= 4 && _request.compare(_request.size() - 4, 4, "\r\n\r\n") == 0)
+        {
+            _closing = HttpStandIn::handle(_request, _segments);
+            _request.clear();
+        }
+
+        return 1;
+    }
+
+    int available() override
+    {
+        int count = 0;
+        int64_t now = esp_timer_get_time();
+        for (auto &segment : _segments)
+        {
+            if (segment.time > now)
+                break;
+            count += segment.data.size();
+        }
+
+        // The server closes the connection once the response has been sent
+        if (_closing && count == 0 && (_segments.empty() || _segments.back().time <= now))
+            _connected = false;
+        return count;
+    }
+
+    int read() override
+    {
+        auto segment = current();
+        if (!segment || segment->data.empty())
+            return -1;
+
+        int c = (uint8_t)segment->data[0];
+        segment->data.erase(0, 1);
+        return c;
+    }
+
+    int peek() override
+    {
+        auto segment = current();
+        return segment && !segment->data.empty() ? (uint8_t)segment->data[0] : -1;
+    }
+
+    using Stream::write;
+};
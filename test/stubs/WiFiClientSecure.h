@@ -0,0 +1,12 @@
+#pragma once
+
+// Host stub of the Arduino WiFiClientSecure, the TLS handshake is part of the connect delay of the HttpStandIn
+
+#include "WiFiClient.h"
+
+class WiFiClientSecure : public WiFiClient
+{
+public:
+    void setInsecure() {}
+    void setHandshakeTimeout(unsigned long) {}
+};
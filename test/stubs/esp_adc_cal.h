@@ -0,0 +1,69 @@
+#pragma once
+
+// Host stub of the ESP-IDF ADC calibration, the eFuse calibration is only available if enabled by the test
+
+#include <stdint.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_ERR_NOT_SUPPORTED 0x106
+
+typedef enum
+{
+    ADC_UNIT_1 = 1,
+    ADC_UNIT_2 = 2,
+} adc_unit_t;
+
+typedef enum
+{
+    ADC_ATTEN_DB_0 = 0,
+    ADC_ATTEN_DB_2_5 = 1,
+    ADC_ATTEN_DB_6 = 2,
+    ADC_ATTEN_DB_11 = 3,
+} adc_atten_t;
+
+typedef enum
+{
+    ADC_WIDTH_BIT_9 = 0,
+    ADC_WIDTH_BIT_10 = 1,
+    ADC_WIDTH_BIT_11 = 2,
+    ADC_WIDTH_BIT_12 = 3,
+} adc_bits_width_t;
+
+typedef enum
+{
+    ESP_ADC_CAL_VAL_EFUSE_VREF = 0,
+    ESP_ADC_CAL_VAL_EFUSE_TP = 1,
+    ESP_ADC_CAL_VAL_DEFAULT_VREF = 2,
+} esp_adc_cal_value_t;
+
+typedef struct
+{
+    adc_unit_t adc_num;
+    adc_atten_t atten;
+    adc_bits_width_t bit_width;
+    uint32_t coeff_a;
+    uint32_t coeff_b;
+    uint32_t vref;
+} esp_adc_cal_characteristics_t;
+
+/// @brief eFuse calibration that is reported as burned into the simulated chip (ESP_ADC_CAL_VAL_DEFAULT_VREF for none)
+inline esp_adc_cal_value_t EspAdcCalStubEfuse = ESP_ADC_CAL_VAL_DEFAULT_VREF;
+
+inline esp_err_t esp_adc_cal_check_efuse(esp_adc_cal_value_t value_type)
+{
+    return value_type == EspAdcCalStubEfuse ? ESP_OK : ESP_ERR_NOT_SUPPORTED;
+}
+
+inline esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t adc_num, adc_atten_t atten, adc_bits_width_t bit_width, uint32_t default_vref, esp_adc_cal_characteristics_t *chars)
+{
+    // Linear characteristic of an ideal chip: 3.3 V over the 12-bit range (mV = reading * coeff_a / 65536 + coeff_b)
+    *chars = {adc_num, atten, bit_width, 3300 * 65536 / 4095, 0, default_vref};
+    return EspAdcCalStubEfuse;
+}
+
+inline uint32_t esp_adc_cal_raw_to_voltage(uint32_t adc_reading, const esp_adc_cal_characteristics_t *chars)
+{
+    return (adc_reading * chars->coeff_a + 32768) / 65536 + chars->coeff_b;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+// Host stub of the ESP ROM CRC functions (software CRC32, same polynomial and conventions as the ROM)
+
+#include <stdint.h>
+
+inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *buf++;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+    }
+
+    return ~crc;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// Host stub of the ESP-IDF high resolution timer, the time is simulated and only advanced by the tests (or delay())
+
+#include <stdint.h>
+
+/// @brief Simulated time since boot in microseconds
+inline int64_t EspTimerStubTime = 0;
+
+inline int64_t esp_timer_get_time()
+{
+    return EspTimerStubTime;
+}
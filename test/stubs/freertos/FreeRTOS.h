@@ -0,0 +1,24 @@
+#pragma once
+
+// Host stub of FreeRTOS, the native tests are single threaded so the critical sections only track the nesting
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint32_t count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((mux)->count++)
+#define portEXIT_CRITICAL(mux) ((mux)->count--)
+#define portTICK_PERIOD_MS 1
+#define portMAX_DELAY 0xffffffffUL
+#define pdMS_TO_TICKS(ms) (ms)
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
@@ -0,0 +1,33 @@
+#pragma once
+
+// Host stub of the FreeRTOS mutex, the native tests are single threaded so a take of a held mutex would block forever.
+// It fails instead, which lets a test run "another task" (e.g. FlashStub::onWrite) while the mutex is held.
+
+#include "FreeRTOS.h"
+
+typedef struct
+{
+    bool taken;
+} StaticSemaphore_t;
+
+typedef StaticSemaphore_t *SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buffer)
+{
+    buffer->taken = false;
+    return buffer;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t)
+{
+    if (mutex->taken)
+        return pdFALSE;
+    mutex->taken = true;
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex)
+{
+    mutex->taken = false;
+    return pdTRUE;
+}
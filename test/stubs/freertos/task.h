@@ -0,0 +1,8 @@
+#pragma once
+
+// Host stub of the FreeRTOS task API, only the types (the native tests do not start tasks)
+
+#include "FreeRTOS.h"
+
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
@@ -0,0 +1,142 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include "AdcCorrection.h"
+
+static const int BENCHMARK_ROUNDS = 200;            // Rounds over all readings for the benchmark
+static const double MAX_TABLE_ERROR = 0.00005;      // Maximum deviation of the table against the polynomial in V (table resolution 0.1 mV)
+
+static volatile double _sink;                       // Keeps the benchmark loops from being optimized away
+
+void setUp()
+{
+    EspAdcCalStubEfuse = ESP_ADC_CAL_VAL_DEFAULT_VREF;
+}
+
+void tearDown() {}
+
+/// @brief The correction that has been used before the table (pow() version of the G6EJD polynomial)
+static double polynomialVoltage(uint16_t reading)
+{
+    if (reading < 1)
+    {
+        return 0;
+    }
+
+    if (reading > 3757)
+    {
+        return 3.3f / 4095.0f * reading;
+    }
+
+    return -0.000000000000016 * pow(reading, 4) + 0.000000000118171 * pow(reading, 3) - 0.000000301211691 * pow(reading, 2) + 0.001109019271794 * reading + 0.034143524634089;
+}
+
+/// @brief Measures the average time of a conversion over all readings in ns
+template <typename Convert>
+static double benchmark(Convert convert)
+{
+    auto start = std::chrono::steady_clock::now();
+    double sum = 0;
+    for (int round = 0; round < BENCHMARK_ROUNDS; round++)
+    {
+        for (uint16_t reading = 0; reading <= ADC_MAX_READING; reading++)
+        {
+            sum += convert(reading);
+        }
+    }
+
+    _sink = sum;
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (BENCHMARK_ROUNDS * (ADC_MAX_READING + 1));
+}
+
+void test_table_matches_polynomial_for_all_readings()
+{
+    AdcCorrection correction;
+    TEST_ASSERT_EQUAL(AdcCalibrationSource::Polynomial, correction.begin(false));
+
+    double maxError = 0;
+    uint16_t maxErrorReading = 0;
+    for (uint16_t reading = 0; reading <= ADC_MAX_READING; reading++)
+    {
+        double error = fabs(correction.voltageFromReading(reading) - polynomialVoltage(reading));
+        if (error > maxError)
+        {
+            maxError = error;
+            maxErrorReading = reading;
+        }
+    }
+
+    char message[80];
+    snprintf(message, sizeof(message), "Maximum deviation %.4f mV at reading %u", maxError * 1000, maxErrorReading);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(MAX_TABLE_ERROR + 1e-6, maxError);
+}
+
+void test_short_and_open_are_detected()
+{
+    AdcCorrection correction;
+    correction.begin(false);
+    TEST_ASSERT_EQUAL_FLOAT(0, correction.voltageFromReading((uint16_t)0));
+    TEST_ASSERT_EQUAL_FLOAT(ADC_MAX_VOLTAGE, correction.voltageFromReading((uint16_t)ADC_MAX_READING));
+
+    // The eFuse calibration keeps both limits as well
+    EspAdcCalStubEfuse = ESP_ADC_CAL_VAL_EFUSE_TP;
+    TEST_ASSERT_EQUAL(AdcCalibrationSource::EfuseTwoPoint, correction.begin(true));
+    TEST_ASSERT_EQUAL_FLOAT(0, correction.voltageFromReading((uint16_t)0));
+    TEST_ASSERT_EQUAL_FLOAT(ADC_MAX_VOLTAGE, correction.voltageFromReading((uint16_t)ADC_MAX_READING));
+}
+
+void test_efuse_calibration_is_optional()
+{
+    AdcCorrection correction;
+    TEST_ASSERT_EQUAL(AdcCalibrationSource::Polynomial, correction.begin(true));
+    TEST_ASSERT_EQUAL_STRING("Polynomial", correction.getSourceName());
+
+    EspAdcCalStubEfuse = ESP_ADC_CAL_VAL_EFUSE_VREF;
+    TEST_ASSERT_EQUAL(AdcCalibrationSource::Polynomial, correction.begin(false));
+    TEST_ASSERT_EQUAL(AdcCalibrationSource::EfuseVref, correction.begin(true));
+    TEST_ASSERT_EQUAL_FLOAT(1.65f, correction.voltageFromReading((uint16_t)2048));
+}
+
+void test_oversampled_reading_is_interpolated()
+{
+    AdcCorrection correction;
+    correction.begin(false);
+    for (uint16_t reading = 0; reading < ADC_MAX_READING; reading += 97)
+    {
+        float lower = correction.voltageFromReading(reading);
+        float upper = correction.voltageFromReading((uint16_t)(reading + 1));
+        TEST_ASSERT_EQUAL_FLOAT(lower, correction.voltageFromReading((float)reading));
+        TEST_ASSERT_FLOAT_WITHIN(1e-6, (lower + upper) / 2, correction.voltageFromReading(reading + 0.5f));
+    }
+
+    TEST_ASSERT_EQUAL_FLOAT(0, correction.voltageFromReading(-1.0f));
+    TEST_ASSERT_EQUAL_FLOAT(ADC_MAX_VOLTAGE, correction.voltageFromReading(4100.0f));
+}
+
+void test_benchmark_table_and_polynomial()
+{
+    AdcCorrection correction;
+    correction.begin(false);
+
+    double polynomial = benchmark([](uint16_t reading) { return polynomialVoltage(reading); });
+    double table = benchmark([&correction](uint16_t reading) { return correction.voltageFromReading(reading); });
+
+    // Only reported, the host FPU says little about the software double precision of the ESP32
+    char message[80];
+    snprintf(message, sizeof(message), "Voltage from reading: pow() %.1f ns, table %.1f ns", polynomial, table);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_GREATER_THAN(0, polynomial + table);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_table_matches_polynomial_for_all_readings);
+    RUN_TEST(test_short_and_open_are_detected);
+    RUN_TEST(test_efuse_calibration_is_optional);
+    RUN_TEST(test_oversampled_reading_is_interpolated);
+    RUN_TEST(test_benchmark_table_and_polynomial);
+    return UNITY_END();
+}
@@ -0,0 +1,107 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "BootSequence.h"
+
+static BootSequenceClass *_boot;
+
+void setUp()
+{
+    EspTimerStubTime = 0;
+    _boot = new BootSequenceClass();
+}
+
+void tearDown()
+{
+    delete _boot;
+}
+
+/// @brief Advances the simulated time and completes the stage
+static void completeAt(BootStage stage, int64_t timeUs)
+{
+    EspTimerStubTime = timeUs;
+    _boot->complete(stage);
+}
+
+void test_initial_state()
+{
+    TEST_ASSERT_EQUAL(BootStage::RESET, _boot->getStage());
+    TEST_ASSERT_FALSE(_boot->isCompleted());
+    TEST_ASSERT_TRUE(_boot->isMarked(BootStage::RESET));
+    TEST_ASSERT_EQUAL_INT64(0, _boot->getTime(BootStage::RESET));
+    for (uint8_t i = 1; i < BOOT_STAGE_COUNT; i++)
+    {
+        TEST_ASSERT_FALSE(_boot->isMarked(static_cast<BootStage>(i)));
+        TEST_ASSERT_EQUAL_INT64(-1, _boot->getTime(static_cast<BootStage>(i)));
+    }
+}
+
+void test_stages_complete_in_order_with_times()
+{
+    // Same order as setup() and updateBootSequence(), each stage 1 ms after the previous one
+    for (uint8_t i = static_cast<uint8_t>(BootStage::CONFIG); i <= static_cast<uint8_t>(BootStage::COMPLETED); i++)
+    {
+        BootStage stage = static_cast<BootStage>(i);
+        completeAt(stage, i * 1000);
+        TEST_ASSERT_EQUAL(stage, _boot->getStage());
+        TEST_ASSERT_EQUAL(stage == BootStage::COMPLETED, _boot->isCompleted());
+    }
+
+    for (uint8_t i = 1; i <= static_cast<uint8_t>(BootStage::COMPLETED); i++)
+    {
+        TEST_ASSERT_EQUAL_INT64(i * 1000, _boot->getTime(static_cast<BootStage>(i)));
+        TEST_ASSERT_TRUE(_boot->getTime(static_cast<BootStage>(i - 1)) < _boot->getTime(static_cast<BootStage>(i)));
+    }
+
+    // The events are not marked by the stages
+    TEST_ASSERT_FALSE(_boot->isMarked(BootStage::FIRST_OUTPUT));
+    TEST_ASSERT_FALSE(_boot->isMarked(BootStage::NETWORK_CONNECTED));
+    TEST_ASSERT_FALSE(_boot->isMarked(BootStage::FIRST_WEATHER));
+}
+
+void test_events_keep_first_time_and_stage()
+{
+    completeAt(BootStage::CONFIG, 1000);
+    completeAt(BootStage::POWER_LIMIT, 2000);
+
+    EspTimerStubTime = 150000;
+    _boot->mark(BootStage::FIRST_OUTPUT);
+    EspTimerStubTime = 250000;
+    _boot->mark(BootStage::FIRST_OUTPUT);
+    _boot->mark(BootStage::NETWORK_CONNECTED);
+
+    TEST_ASSERT_EQUAL(BootStage::POWER_LIMIT, _boot->getStage());
+    TEST_ASSERT_EQUAL_INT64(150000, _boot->getTime(BootStage::FIRST_OUTPUT));
+    TEST_ASSERT_EQUAL_INT64(250000, _boot->getTime(BootStage::NETWORK_CONNECTED));
+    TEST_ASSERT_FALSE(_boot->isMarked(BootStage::FIRST_WEATHER));
+}
+
+void test_completed_stage_keeps_first_time()
+{
+    completeAt(BootStage::NETWORK, 5000);
+    completeAt(BootStage::NETWORK, 9000);
+    TEST_ASSERT_EQUAL(BootStage::NETWORK, _boot->getStage());
+    TEST_ASSERT_EQUAL_INT64(5000, _boot->getTime(BootStage::NETWORK));
+
+    // Reset is time 0 and can not be marked again
+    EspTimerStubTime = 10000;
+    _boot->mark(BootStage::RESET);
+    TEST_ASSERT_EQUAL_INT64(0, _boot->getTime(BootStage::RESET));
+}
+
+void test_stage_names()
+{
+    TEST_ASSERT_EQUAL_STRING("Reset", BootSequenceClass::getStageName(BootStage::RESET));
+    TEST_ASSERT_EQUAL_STRING("Completed", BootSequenceClass::getStageName(BootStage::COMPLETED));
+    TEST_ASSERT_EQUAL_STRING("First Weather", BootSequenceClass::getStageName(BootStage::FIRST_WEATHER));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_initial_state);
+    RUN_TEST(test_stages_complete_in_order_with_times);
+    RUN_TEST(test_events_keep_first_time_and_stage);
+    RUN_TEST(test_completed_stage_keeps_first_time);
+    RUN_TEST(test_stage_names);
+    return UNITY_END();
+}
@@ -0,0 +1,213 @@
+#include <unity.h>
+#include <stddef.h>
+#include <esp_rom_crc.h>
+#include "Config.h"
+
+static const uint32_t LEGACY_KEY_CNT = 4 + TEMP_ADJUST_AMOUNT + 2 + 3 * POWER_AREA_AMOUNT; // Keys of the former per-key layout
+
+static Config *_config;
+
+void setUp()
+{
+    NvsStub::reset();
+    EspTimerStubTime = 0;
+    _config = nullptr;
+}
+
+void tearDown()
+{
+    delete _config;
+}
+
+/// @brief Writes a configuration with the former per-key layout
+static void writeLegacy()
+{
+    Preferences preferences;
+    preferences.begin(KEY_SETTINGS_NAMESPACE, false);
+    preferences.putBool(KEY_SETTING_TEMP_MANUAL_OUT_MODE, true);
+    preferences.putShort(KEY_SETTING_TEMP_MANUAL_OUT_TEMP, -73);
+    preferences.putChar("TempOffset-15", -12);
+    preferences.putChar("TempOffset21", 7);
+    preferences.putChar("TempOffset0", 3);
+    preferences.putShort("PowerStart2", -50);
+    preferences.putShort("PowerEnd2", 55);
+    preferences.putUChar("PowerLimit2", 40);
+    preferences.putUChar(KEY_SETTING_POWER_MANUAL_POWER, 35);
+    preferences.end();
+    NvsStub::reads = NvsStub::writes = 0;
+}
+
+/// @brief Gets the stored blob
+static std::vector<uint8_t> &blob()
+{
+    return NvsStub::namespaces[KEY_CONFIG_NAMESPACE][KEY_CONFIG_BLOB];
+}
+
+/// @brief Checks the values of writeLegacy()
+static void assertLegacyValues(Config *config)
+{
+    auto temperature = config->temperatureConfig;
+    TEST_ASSERT_TRUE(temperature->isManualOutputTemp());
+    TEST_ASSERT_EQUAL_FLOAT(-7.3f, temperature->getManualOutputTemperature());
+    TEST_ASSERT_FALSE(temperature->isManualInputTemp());
+    TEST_ASSERT_EQUAL_FLOAT(-1.2f, temperature->getTempAdjustment(-15)->getTemperatureOffset());
+    TEST_ASSERT_EQUAL_FLOAT(0.7f, temperature->getTempAdjustment(21)->getTemperatureOffset());
+    TEST_ASSERT_EQUAL_FLOAT(0.3f, temperature->getTempAdjustment(0)->getTemperatureOffset());
+    TEST_ASSERT_EQUAL_FLOAT(0, temperature->getTempAdjustment(5)->getTemperatureOffset());
+
+    auto area = config->powerConfig->getArea((size_t)2);
+    TEST_ASSERT_EQUAL_FLOAT(-5, area->getStart());
+    TEST_ASSERT_EQUAL_FLOAT(5.5f, area->getEnd());
+    TEST_ASSERT_EQUAL_UINT8(40, area->getPowerLimit());
+    TEST_ASSERT_EQUAL_UINT8(35, config->powerConfig->getManualPower());
+}
+
+void test_migration_reads_each_key_once_and_writes_one_blob()
+{
+    writeLegacy();
+    _config = new Config();
+
+    // One read of the (missing) blob and one per legacy key, one write of the blob
+    TEST_ASSERT_EQUAL_UINT32(62, LEGACY_KEY_CNT + 1);
+    TEST_ASSERT_EQUAL_UINT32(LEGACY_KEY_CNT + 1, NvsStub::reads);
+    TEST_ASSERT_EQUAL_UINT32(1, NvsStub::writes);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(ConfigStoreHeader) + sizeof(ConfigData), blob().size());
+    TEST_ASSERT_EQUAL_UINT32(0, NvsStub::namespaces[KEY_SETTINGS_NAMESPACE].size());
+
+    auto stats = _config->store->getStats();
+    TEST_ASSERT_EQUAL_UINT16(0, stats.loadVersion);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.commits);
+    assertLegacyValues(_config);
+}
+
+void test_reload_reads_the_blob_once()
+{
+    writeLegacy();
+    delete new Config();
+
+    NvsStub::reads = NvsStub::writes = 0;
+    _config = new Config();
+    TEST_ASSERT_EQUAL_UINT32(1, NvsStub::reads);
+    TEST_ASSERT_EQUAL_UINT32(0, NvsStub::writes);
+    TEST_ASSERT_EQUAL_UINT16(CONFIG_DATA_VERSION, _config->store->getStats().loadVersion);
+    assertLegacyValues(_config);
+}
+
+void test_changes_are_written_behind()
+{
+    _config = new Config();
+    NvsStub::writes = 0;
+
+    // Burst of changes (number input steps), committed once after the quiet period
+    auto adjustment = _config->temperatureConfig->getTempAdjustment(5);
+    for (int i = 1; i <= 10; i++)
+    {
+        adjustment->setTemperatureOffset(0.1f * i);
+        delay(200);
+        _config->store->update();
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, NvsStub::writes);
+    TEST_ASSERT_EQUAL_UINT32(10, _config->store->getStats().pending);
+    delay(CONFIG_STORE_COMMIT_DELAY);
+    _config->store->update();
+    auto stats = _config->store->getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, NvsStub::writes);
+    TEST_ASSERT_EQUAL_UINT32(9, stats.coalesced);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.pending);
+
+    // Ongoing changes are committed after CONFIG_STORE_COMMIT_MAX
+    for (uint32_t time = 0; time < CONFIG_STORE_COMMIT_MAX; time += 1000)
+    {
+        _config->powerConfig->setManualPower(time % 2000 ? 50 : 60);
+        delay(1000);
+        _config->store->update();
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(2, NvsStub::writes);
+
+    NvsStub::reads = 0;
+    Config reloaded;
+    TEST_ASSERT_EQUAL_UINT32(1, NvsStub::reads);
+    TEST_ASSERT_EQUAL_FLOAT(1, reloaded.temperatureConfig->getTempAdjustment(5)->getTemperatureOffset());
+}
+
+void test_corrupt_blob_falls_back_to_migration()
+{
+    writeLegacy();
+    delete new Config();
+
+    // A flipped bit inside the data, the legacy keys have already been removed so the defaults are used
+    blob()[sizeof(ConfigStoreHeader) + 1] ^= 1;
+    NvsStub::reads = NvsStub::writes = 0;
+    _config = new Config();
+    TEST_ASSERT_EQUAL_UINT32(LEGACY_KEY_CNT + 1, NvsStub::reads);
+    TEST_ASSERT_EQUAL_UINT32(1, NvsStub::writes);
+    TEST_ASSERT_EQUAL_UINT16(0, _config->store->getStats().loadVersion);
+    TEST_ASSERT_FALSE(_config->temperatureConfig->isManualOutputTemp());
+    TEST_ASSERT_EQUAL_FLOAT(15, _config->temperatureConfig->getManualOutputTemperature());
+
+    // The blob has been rewritten
+    ConfigStoreHeader header;
+    memcpy(&header, blob().data(), sizeof(header));
+    TEST_ASSERT_EQUAL_UINT32(header.crc, esp_rom_crc32_le(0, blob().data() + sizeof(header), header.size));
+}
+
+void test_older_prefix_blob_loads()
+{
+    {
+        Config config;
+        config.temperatureConfig->setManualOutputActive(true);
+        config.temperatureConfig->getTempAdjustment(21)->setTemperatureOffset(2);
+        config.powerConfig->setManualPower(20);
+        TEST_ASSERT_TRUE(config.store->commit());
+    }
+
+    // Blob of an older layout that ends after the first temperature offset
+    ConfigStoreHeader header;
+    memcpy(&header, blob().data(), sizeof(header));
+    header.size = offsetof(ConfigData, tempOffset) + 1;
+    header.crc = esp_rom_crc32_le(0, blob().data() + sizeof(header), header.size);
+    blob().resize(sizeof(header) + header.size);
+    memcpy(blob().data(), &header, sizeof(header));
+
+    // Firmware with a newer layout version of the same data
+    ConfigData data;
+    ConfigStore store(KEY_CONFIG_NAMESPACE, KEY_CONFIG_BLOB, CONFIG_DATA_VERSION + 1, &data, sizeof(data));
+    TEST_ASSERT_EQUAL_UINT16(CONFIG_DATA_VERSION, store.load());
+    TEST_ASSERT_TRUE(data.manualOutputActive);
+    TEST_ASSERT_EQUAL_INT8(20, data.tempOffset[0]);
+    TEST_ASSERT_EQUAL_UINT8(100, data.manualPower);
+
+    TEST_ASSERT_TRUE(store.commit(true));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(ConfigStoreHeader) + sizeof(ConfigData), blob().size());
+}
+
+void test_failed_commit_stays_pending()
+{
+    _config = new Config();
+    NvsStub::failWrites = true;
+    _config->temperatureConfig->setManualInputActive(true);
+    TEST_ASSERT_FALSE(_config->store->commit());
+    auto stats = _config->store->getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.failures);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.pending);
+
+    // Retried after the next quiet period
+    NvsStub::failWrites = false;
+    delay(CONFIG_STORE_COMMIT_DELAY);
+    _config->store->update();
+    TEST_ASSERT_EQUAL_UINT32(0, _config->store->getStats().pending);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_migration_reads_each_key_once_and_writes_one_blob);
+    RUN_TEST(test_reload_reads_the_blob_once);
+    RUN_TEST(test_changes_are_written_behind);
+    RUN_TEST(test_corrupt_blob_falls_back_to_migration);
+    RUN_TEST(test_older_prefix_blob_loads);
+    RUN_TEST(test_failed_commit_stays_pending);
+    return UNITY_END();
+}
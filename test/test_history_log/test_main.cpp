@@ -0,0 +1,302 @@
+#include <unity.h>
+#include <stdio.h>
+#include <LittleFS.h>
+#include "HistoryLog.h"
+
+static const time_t BOOT_TIME = 1760000000;                 // System time at uptime 0 (a full minute)
+static const uint32_t DAY = 86400;                          // Seconds of a day
+static const uint32_t RECORDS_PER_PAGE = HISTORY_LOG_PAGE_SIZE / sizeof(HistoryLogRecord);
+static const uint32_t RECORDS_PER_SEGMENT = HISTORY_LOG_SEGMENT_SIZE / sizeof(HistoryLogRecord);
+
+static HistoryStore *_history;
+static HistoryLog *_log;
+static uint32_t _uptime;
+
+void setUp()
+{
+    FlashStub::reset();
+    _history = new HistoryStore();
+    _log = new HistoryLog();
+    _uptime = 0;
+    TEST_ASSERT_TRUE(_log->begin());
+}
+
+void tearDown()
+{
+    delete _log;
+    delete _history;
+}
+
+/// @brief Runs the history job of the network task (every second) for the given time
+static void run(uint32_t seconds, time_t bootTime = BOOT_TIME)
+{
+    for (uint32_t end = _uptime + seconds; _uptime < end; _uptime++)
+    {
+        float values[HISTORY_CHANNEL_CNT] = {(float)(_uptime % 600) / 60 - 5, 35};
+        _history->add(_uptime, values);
+        _log->update(*_history, bootTime);
+    }
+}
+
+/// @brief Reads a range and checks that the records are in order
+/// @return the amount of records
+static uint32_t readRange(time_t from, time_t to, time_t &first, time_t &last)
+{
+    HistoryLogReader reader(_log, from, to);
+    HistoryLogRecord record;
+    uint32_t count = 0;
+    first = last = 0;
+    while (reader.next(record))
+    {
+        if (count == 0)
+            first = record.time;
+        else
+            TEST_ASSERT_EQUAL_INT64(last + 60, record.time);
+        last = record.time;
+        count++;
+    }
+
+    return count;
+}
+
+void test_records_are_written_page_by_page()
+{
+    run(DAY);
+    auto stats = _log->getStats();
+
+    // The last minute is still open, the records of the last page are buffered
+    uint32_t minutes = DAY / 60 - 1;
+    TEST_ASSERT_EQUAL_UINT32(minutes / RECORDS_PER_PAGE * RECORDS_PER_PAGE, stats.records);
+    TEST_ASSERT_EQUAL_UINT32(minutes / RECORDS_PER_PAGE, stats.writes);
+    TEST_ASSERT_EQUAL_UINT32(stats.writes * HISTORY_LOG_PAGE_SIZE, stats.bytes);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.failures);
+
+    _log->flush();
+    stats = _log->getStats();
+    TEST_ASSERT_EQUAL_UINT32(minutes, stats.records);
+    TEST_ASSERT_EQUAL_UINT32(minutes / RECORDS_PER_PAGE + 1, stats.writes);
+    TEST_ASSERT_EQUAL_UINT32(minutes * sizeof(HistoryLogRecord), stats.bytes);
+
+    // A second flush has nothing to write
+    _log->flush();
+    TEST_ASSERT_EQUAL_UINT32(stats.writes, _log->getStats().writes);
+}
+
+void test_rotation_keeps_the_newest_segments()
+{
+    const uint32_t days = 40;
+    run(days * DAY);
+    _log->flush();
+
+    auto stats = _log->getStats();
+    uint32_t minutes = days * DAY / 60 - 1;
+    TEST_ASSERT_EQUAL_UINT32(HISTORY_LOG_SEGMENT_CNT, stats.segments);
+    TEST_ASSERT_EQUAL_UINT32(HISTORY_LOG_SEGMENT_CNT, FlashStub::files.size());
+    TEST_ASSERT_EQUAL_UINT32((minutes * sizeof(HistoryLogRecord) + HISTORY_LOG_SEGMENT_SIZE - 1) / HISTORY_LOG_SEGMENT_SIZE, stats.rotations);
+
+    uint32_t first, last;
+    TEST_ASSERT_TRUE(_log->getSegments(first, last));
+    TEST_ASSERT_EQUAL_UINT32(stats.rotations - HISTORY_LOG_SEGMENT_CNT, first);
+    TEST_ASSERT_EQUAL_UINT32(stats.rotations - 1, last);
+
+    // Everything that is left: the full segments and the newest one
+    time_t from, to;
+    uint32_t count = readRange(0, INT32_MAX, from, to);
+    TEST_ASSERT_EQUAL_UINT32(minutes - first * RECORDS_PER_SEGMENT, count);
+    TEST_ASSERT_EQUAL_INT64(BOOT_TIME + (time_t)(minutes - 1) * 60, to);
+
+    // Write amplification of the cost model, about 10 for page writes (the tail block is copied by each append)
+    double amplification = (double)FlashStub::stats.programmed / stats.bytes;
+    char message[120];
+    snprintf(message, sizeof(message), "%u days: write amplification %.2f, %.1f block erases per day",
+             days, amplification, (double)FlashStub::stats.erases / days);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(amplification < 12);
+}
+
+void test_pages_reduce_the_wear()
+{
+    run(DAY);
+    _log->flush();
+    auto paged = FlashStub::stats;
+
+    // Same day with a write of each record on its own
+    tearDown();
+    setUp();
+    for (uint32_t minute = 0; minute < DAY / 60; minute++)
+    {
+        run(60);
+        _log->flush();
+    }
+
+    auto single = FlashStub::stats;
+    char message[120];
+    snprintf(message, sizeof(message), "1 day: pages %u erases %llu bytes, single records %u erases %llu bytes",
+             paged.erases, (unsigned long long)paged.programmed, single.erases, (unsigned long long)single.programmed);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(single.programmed > paged.programmed * 10);
+    TEST_ASSERT_TRUE(single.erases > paged.erases * 10);
+}
+
+void test_range_read()
+{
+    run(12 * DAY);
+    _log->flush();
+
+    // One day 10 days ago, spread over several segments
+    time_t from = BOOT_TIME + 1 * DAY;
+    time_t to = BOOT_TIME + 2 * DAY - 1;
+    time_t first, last;
+    TEST_ASSERT_EQUAL_UINT32(1440, readRange(from, to, first, last));
+    TEST_ASSERT_EQUAL_INT64(from, first);
+    TEST_ASSERT_EQUAL_INT64(to - 59, last);
+
+    // The start inside a minute begins with the next record, the end is included
+    TEST_ASSERT_EQUAL_UINT32(3, readRange(from + 1, from + 180, first, last));
+    TEST_ASSERT_EQUAL_INT64(from + 60, first);
+    TEST_ASSERT_EQUAL_INT64(from + 180, last);
+
+    // Range at a segment boundary
+    time_t boundary = BOOT_TIME + RECORDS_PER_SEGMENT * 60;
+    TEST_ASSERT_EQUAL_UINT32(2, readRange(boundary - 60, boundary, first, last));
+    TEST_ASSERT_EQUAL_INT64(boundary, last);
+
+    // Ranges outside of the log
+    TEST_ASSERT_EQUAL_UINT32(0, readRange(BOOT_TIME - DAY, BOOT_TIME - 1, first, last));
+    TEST_ASSERT_EQUAL_UINT32(0, readRange(BOOT_TIME + 13 * DAY, BOOT_TIME + 14 * DAY, first, last));
+    TEST_ASSERT_EQUAL_UINT32(2, readRange(BOOT_TIME - DAY, BOOT_TIME + 60, first, last));
+}
+
+void test_restart_continues_after_the_newest_record()
+{
+    run(DAY);
+    _log->flush();
+    auto written = _log->getStats().records;
+    uint32_t first, last;
+    _log->getSegments(first, last);
+
+    // New instance after a reboot finds the segments and does not write the same minutes again
+    delete _log;
+    _log = new HistoryLog();
+    TEST_ASSERT_TRUE(_log->begin());
+    uint32_t restartFirst, restartLast;
+    TEST_ASSERT_TRUE(_log->getSegments(restartFirst, restartLast));
+    TEST_ASSERT_EQUAL_UINT32(first, restartFirst);
+    TEST_ASSERT_EQUAL_UINT32(last, restartLast);
+    TEST_ASSERT_EQUAL_UINT32(last - first + 1, _log->getStats().segments);
+
+    _log->update(*_history, BOOT_TIME);
+    _log->update(*_history, BOOT_TIME - 3600);
+    _log->flush();
+    TEST_ASSERT_EQUAL_UINT32(0, _log->getStats().records);
+
+    // The next minutes are appended to the newest segment
+    run(600);
+    _log->flush();
+    TEST_ASSERT_EQUAL_UINT32(10, _log->getStats().records);
+    TEST_ASSERT_EQUAL_UINT32(0, _log->getStats().rotations);
+    time_t from, to;
+    TEST_ASSERT_EQUAL_UINT32(written + 10, readRange(0, INT32_MAX, from, to));
+}
+
+void test_incomplete_record_is_skipped()
+{
+    run(3600);
+    _log->flush();
+    uint32_t first, last;
+    _log->getSegments(first, last);
+
+    // Interrupted write: the newest segment ends with a part of a record
+    char path[32];
+    HistoryLog::getSegmentPath(last, path, sizeof(path));
+    FlashStub::files[path]->append(5, '\xff');
+
+    delete _log;
+    _log = new HistoryLog();
+    TEST_ASSERT_TRUE(_log->begin());
+    run(600);
+    _log->flush();
+
+    // The log continues with a new segment, the reader skips the incomplete record
+    uint32_t restartFirst, restartLast;
+    _log->getSegments(restartFirst, restartLast);
+    TEST_ASSERT_EQUAL_UINT32(last + 1, restartLast);
+    time_t from, to;
+    TEST_ASSERT_EQUAL_UINT32(59 + 10, readRange(0, INT32_MAX, from, to));
+    TEST_ASSERT_EQUAL_INT64(BOOT_TIME + 68 * 60, to);
+}
+
+void test_failed_write_starts_a_new_segment()
+{
+    run(RECORDS_PER_PAGE * 60 + 60);
+    TEST_ASSERT_EQUAL_UINT32(1, _log->getStats().writes);
+
+    FlashStub::failWrites = true;
+    run(RECORDS_PER_PAGE * 60);
+    FlashStub::failWrites = false;
+    TEST_ASSERT_EQUAL_UINT32(1, _log->getStats().failures);
+
+    run(RECORDS_PER_PAGE * 60);
+    auto stats = _log->getStats();
+    TEST_ASSERT_EQUAL_UINT32(2, stats.writes);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.rotations);
+    TEST_ASSERT_EQUAL_UINT32(2, FlashStub::files.size());
+}
+
+void test_flush_during_page_write()
+{
+    // The shutdown handler flushes while the network task is writing a full page
+    run(RECORDS_PER_PAGE * 60 - 1);
+    FlashStub::onWrite = []()
+    {
+        _log->flush();
+    };
+    run(2 * 60);
+    TEST_ASSERT_NULL(FlashStub::onWrite);
+
+    // The page is written once, the flush had nothing left to write
+    auto stats = _log->getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.writes);
+    TEST_ASSERT_EQUAL_UINT32(RECORDS_PER_PAGE, stats.records);
+    _log->flush();
+    time_t from, to;
+    TEST_ASSERT_EQUAL_UINT32(RECORDS_PER_PAGE + 1, readRange(0, INT32_MAX, from, to));
+    TEST_ASSERT_EQUAL_UINT32((RECORDS_PER_PAGE + 1) * sizeof(HistoryLogRecord), FlashStub::files.begin()->second->size());
+}
+
+void test_page_completed_during_flush_is_written_after_it()
+{
+    // The shutdown handler flushes a partial page while the network task completes the next page, the newer page
+    // waits for the flush so the records stay sorted by time
+    run(5 * 60);
+    FlashStub::onWrite = []()
+    {
+        run(RECORDS_PER_PAGE * 60);
+    };
+    _log->flush();
+    TEST_ASSERT_NULL(FlashStub::onWrite);
+    TEST_ASSERT_EQUAL_UINT32(1, _log->getStats().writes);
+
+    _log->flush();
+    auto stats = _log->getStats();
+    TEST_ASSERT_EQUAL_UINT32(2, stats.writes);
+    TEST_ASSERT_EQUAL_UINT32(4 + RECORDS_PER_PAGE, stats.records);
+    time_t from, to;
+    TEST_ASSERT_EQUAL_UINT32(4 + RECORDS_PER_PAGE, readRange(0, INT32_MAX, from, to));
+    TEST_ASSERT_EQUAL_INT64(BOOT_TIME, from);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_records_are_written_page_by_page);
+    RUN_TEST(test_rotation_keeps_the_newest_segments);
+    RUN_TEST(test_pages_reduce_the_wear);
+    RUN_TEST(test_range_read);
+    RUN_TEST(test_restart_continues_after_the_newest_record);
+    RUN_TEST(test_incomplete_record_is_skipped);
+    RUN_TEST(test_failed_write_starts_a_new_segment);
+    RUN_TEST(test_flush_during_page_write);
+    RUN_TEST(test_page_completed_during_flush_is_written_after_it);
+    return UNITY_END();
+}
@@ -0,0 +1,130 @@
+#include <unity.h>
+#include <math.h>
+#include "HistoryStore.h"
+
+static HistoryStore *_store;
+
+void setUp()
+{
+    _store = new HistoryStore();
+}
+
+void tearDown()
+{
+    delete _store;
+}
+
+/// @brief Adds the same value to both channels
+static void add(uint32_t time, float value)
+{
+    float values[HISTORY_CHANNEL_CNT];
+    for (uint8_t c = 0; c < HISTORY_CHANNEL_CNT; c++)
+        values[c] = value;
+    _store->add(time, values);
+}
+
+void test_fixed_point()
+{
+    TEST_ASSERT_EQUAL_INT16(2151, HistoryStore::toFixed(21.505f));
+    TEST_ASSERT_EQUAL_INT16(-1025, HistoryStore::toFixed(-10.25f));
+    TEST_ASSERT_EQUAL_INT16(HISTORY_NO_VALUE, HistoryStore::toFixed(NAN));
+    TEST_ASSERT_EQUAL_INT16(INT16_MAX, HistoryStore::toFixed(1000));
+    TEST_ASSERT_EQUAL_INT16(INT16_MIN + 1, HistoryStore::toFixed(-1000));
+    TEST_ASSERT_EQUAL_FLOAT(21.51f, HistoryStore::toFloat(2151));
+    TEST_ASSERT_TRUE(isnanf(HistoryStore::toFloat(HISTORY_NO_VALUE)));
+}
+
+void test_minute_aggregation()
+{
+    uint32_t first, last;
+    TEST_ASSERT_FALSE(_store->getRange(1, first, last));
+
+    // Minute 0: 0..59 s, minute 1 starts with 60 s and completes minute 0
+    for (uint32_t time = 0; time < 60; time++)
+        add(time, time < 30 ? 20 : 22);
+    add(60, 25);
+
+    HistoryEntry entry;
+    TEST_ASSERT_TRUE(_store->getRange(1, first, last));
+    TEST_ASSERT_EQUAL_UINT32(0, first);
+    TEST_ASSERT_EQUAL_UINT32(0, last);
+    TEST_ASSERT_TRUE(_store->read(1, 0, entry));
+    TEST_ASSERT_EQUAL_INT16(2000, entry.min[0]);
+    TEST_ASSERT_EQUAL_INT16(2200, entry.max[0]);
+    TEST_ASSERT_EQUAL_INT16(2100, entry.mean[0]);
+    TEST_ASSERT_FALSE(_store->read(1, 1, entry));
+
+    TEST_ASSERT_TRUE(_store->read(0, 60, entry));
+    TEST_ASSERT_EQUAL_INT16(2500, entry.mean[1]);
+}
+
+void test_gaps_are_kept()
+{
+    add(10, 20);
+    add(13, 21);
+
+    HistoryEntry entry;
+    TEST_ASSERT_TRUE(_store->read(0, 11, entry));
+    TEST_ASSERT_EQUAL_INT16(HISTORY_NO_VALUE, entry.mean[0]);
+    TEST_ASSERT_TRUE(_store->read(0, 13, entry));
+    TEST_ASSERT_EQUAL_INT16(2100, entry.mean[0]);
+    TEST_ASSERT_FALSE(_store->read(0, 9, entry));
+}
+
+void test_duplicate_second_is_not_accumulated_twice()
+{
+    // Second 30 is added three times (e.g. the history job was late and the uptime did not change)
+    for (uint32_t time = 0; time < 60; time++)
+    {
+        add(time, 20);
+        if (time == 30)
+        {
+            add(time, 50);
+            add(time, 50);
+        }
+    }
+    add(60, 20);
+
+    // The 1 s tier keeps the last value of the second
+    HistoryEntry entry;
+    TEST_ASSERT_TRUE(_store->read(0, 30, entry));
+    TEST_ASSERT_EQUAL_INT16(5000, entry.mean[0]);
+
+    // The minute only contains the first value of each second
+    TEST_ASSERT_TRUE(_store->read(1, 0, entry));
+    TEST_ASSERT_EQUAL_INT16(2000, entry.min[0]);
+    TEST_ASSERT_EQUAL_INT16(2000, entry.max[0]);
+    TEST_ASSERT_EQUAL_INT16(2000, entry.mean[0]);
+
+    // An older second inside the ring only replaces its value
+    add(45, 30);
+    TEST_ASSERT_TRUE(_store->read(0, 45, entry));
+    TEST_ASSERT_EQUAL_INT16(3000, entry.mean[0]);
+    uint32_t first, last;
+    TEST_ASSERT_TRUE(_store->getRange(0, first, last));
+    TEST_ASSERT_EQUAL_UINT32(60, last);
+}
+
+void test_second_before_ring_is_ignored()
+{
+    for (uint32_t time = 0; time <= HISTORY_SECONDS_CNT; time++)
+        add(time, 20);
+
+    // Second 0 has left the ring, its slot is used by the newest second
+    add(0, 50);
+    HistoryEntry entry;
+    TEST_ASSERT_FALSE(_store->read(0, 0, entry));
+    TEST_ASSERT_TRUE(_store->read(0, HISTORY_SECONDS_CNT, entry));
+    TEST_ASSERT_EQUAL_INT16(2000, entry.mean[0]);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fixed_point);
+    RUN_TEST(test_minute_aggregation);
+    RUN_TEST(test_gaps_are_kept);
+    RUN_TEST(test_duplicate_second_is_not_accumulated_twice);
+    RUN_TEST(test_second_before_ring_is_ignored);
+    return UNITY_END();
+}
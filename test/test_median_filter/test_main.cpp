@@ -0,0 +1,186 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <RunningMedian.h>
+#include "MedianFilter.h"
+
+static const int SAMPLE_CNT = 5000;         // Random samples for the brute force check
+static const uint16_t WINDOW_SIZE = 100;    // Window of the input thermistor (TEMP_IN_UPDATE_CYCLE / TEMP_IN_SAMPLE_CYCLE)
+static const int BENCHMARK_WINDOWS = 2000;  // Windows (seconds of input sampling) for the benchmark
+static const float OUTLIER_DEVIATION = 0.5f; // Maximum deviation from the median in °C (TEMP_IN_OUTLIER_DEVIATION)
+
+static volatile float _sink;                // Keeps the benchmark loops from being optimized away
+
+void setUp() {}
+void tearDown() {}
+
+/// @brief Median of the window by sorting a copy
+static float bruteForceMedian(std::vector<float> window)
+{
+    std::sort(window.begin(), window.end());
+    size_t count = window.size();
+    return (count & 1) ? window[count / 2] : (window[count / 2 - 1] + window[count / 2]) / 2;
+}
+
+/// @brief Trimmed mean of the window by a plain loop
+static float bruteForceTrimmedMean(const std::vector<float> &window, float maxDeviation, uint16_t &outliers)
+{
+    float median = bruteForceMedian(window);
+    float sum = 0;
+    uint16_t used = 0;
+    for (float value : window)
+    {
+        if (fabsf(value - median) <= maxDeviation)
+        {
+            sum += value;
+            used++;
+        }
+    }
+
+    outliers = window.size() - used;
+    return used > 0 ? sum / used : median;
+}
+
+/// @brief Adds random samples (with duplicates and spikes) and compares each median against the sorted window
+template <uint16_t N>
+static void checkAgainstBruteForce(uint32_t seed)
+{
+    MedianFilter<N> filter;
+    std::mt19937 random(seed);
+    std::normal_distribution<float> noise(20, 0.2f);
+    std::vector<float> samples;
+    TEST_ASSERT_TRUE(isnanf(filter.getMedian()));
+
+    for (int i = 0; i < SAMPLE_CNT; i++)
+    {
+        float value = roundf(noise(random) * 100) / 100;
+        if (random() % 50 == 0)
+            value += (random() % 2) ? 5 : -5;
+
+        filter.add(value);
+        samples.push_back(value);
+        size_t count = std::min(samples.size(), (size_t)N);
+        std::vector<float> window(samples.end() - count, samples.end());
+        TEST_ASSERT_EQUAL_UINT16(count, filter.getCount());
+        TEST_ASSERT_EQUAL_FLOAT(bruteForceMedian(window), filter.getMedian());
+
+        if (i % 37 == 0)
+        {
+            uint16_t outliers;
+            float expected = bruteForceTrimmedMean(window, OUTLIER_DEVIATION, outliers);
+            TEST_ASSERT_FLOAT_WITHIN(1e-4, expected, filter.getTrimmedMean(OUTLIER_DEVIATION));
+            TEST_ASSERT_EQUAL_UINT16(outliers, filter.getLastOutlierCount());
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(SAMPLE_CNT, filter.getSampleCount());
+}
+
+void test_median_matches_brute_force()
+{
+    checkAgainstBruteForce<1>(1);
+    checkAgainstBruteForce<2>(2);
+    checkAgainstBruteForce<7>(7);
+    checkAgainstBruteForce<WINDOW_SIZE>(100);
+}
+
+void test_median_of_sorted_input()
+{
+    // Ascending and descending input moves every sample through both heaps
+    MedianFilter<7> filter;
+    for (int i = 0; i < 20; i++)
+        filter.add(i);
+    TEST_ASSERT_EQUAL_FLOAT(16, filter.getMedian());
+    for (int i = 20; i > 0; i--)
+        filter.add(i);
+    TEST_ASSERT_EQUAL_FLOAT(4, filter.getMedian());
+}
+
+void test_clear_restarts_window_and_keeps_outliers()
+{
+    MedianFilter<5> filter;
+    filter.add(1);
+    filter.add(1);
+    filter.add(9);
+    TEST_ASSERT_EQUAL_FLOAT(1, filter.getTrimmedMean(OUTLIER_DEVIATION));
+    TEST_ASSERT_EQUAL_UINT32(1, filter.getOutlierCount());
+
+    filter.clear();
+    TEST_ASSERT_EQUAL_UINT16(0, filter.getCount());
+    TEST_ASSERT_EQUAL_UINT32(0, filter.getSampleCount());
+    TEST_ASSERT_TRUE(isnanf(filter.getMedian()));
+    TEST_ASSERT_TRUE(isnanf(filter.getTrimmedMean(OUTLIER_DEVIATION)));
+    TEST_ASSERT_EQUAL_UINT32(1, filter.getOutlierCount());
+
+    filter.add(3);
+    filter.add(4);
+    TEST_ASSERT_EQUAL_FLOAT(3.5f, filter.getMedian());
+}
+
+void test_benchmark_against_running_median()
+{
+    std::mt19937 random(42);
+    std::normal_distribution<float> noise(20, 0.2f);
+    std::vector<float> samples(WINDOW_SIZE * BENCHMARK_WINDOWS);
+    for (float &value : samples)
+        value = noise(random);
+
+    // Previous implementation: collect a block of WINDOW_SIZE samples, sort it once for the median average, then clear
+    RunningMedian runningMedian(WINDOW_SIZE);
+    double runningBurstMax = 0;
+    float runningSum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        runningMedian.add(samples[i]);
+        if (runningMedian.getCount() == WINDOW_SIZE)
+        {
+            auto burstStart = std::chrono::steady_clock::now();
+            runningSum += runningMedian.getMedianAverage(WINDOW_SIZE);
+            runningMedian.clear();
+            runningBurstMax = std::max(runningBurstMax, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - burstStart).count());
+        }
+    }
+    double running = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / samples.size();
+
+    // Sliding window: each sample replaces the oldest one, the trimmed mean every WINDOW_SIZE samples
+    MedianFilter<WINDOW_SIZE> filter;
+    double filterBurstMax = 0;
+    float filterSum = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        filter.add(samples[i]);
+        if (filter.getSampleCount() % WINDOW_SIZE == 0)
+        {
+            auto burstStart = std::chrono::steady_clock::now();
+            filterSum += filter.getTrimmedMean(OUTLIER_DEVIATION);
+            filterBurstMax = std::max(filterBurstMax, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - burstStart).count());
+        }
+    }
+    double sliding = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / samples.size();
+    _sink = runningSum + filterSum;
+
+    // Only reported, the timing of the host says little about the ESP32
+    char message[160];
+    snprintf(message, sizeof(message), "Per sample: RunningMedian %.1f ns, MedianFilter %.1f ns; worst window evaluation: RunningMedian %.0f ns, MedianFilter %.0f ns",
+             running, sliding, runningBurstMax, filterBurstMax);
+    TEST_MESSAGE(message);
+
+    // Both see the same (noise only) signal, so the results of each window need to be close
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, runningSum / BENCHMARK_WINDOWS, filterSum / BENCHMARK_WINDOWS);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_median_matches_brute_force);
+    RUN_TEST(test_median_of_sorted_input);
+    RUN_TEST(test_clear_restarts_window_and_keeps_outliers);
+    RUN_TEST(test_benchmark_against_running_median);
+    return UNITY_END();
+}
@@ -0,0 +1,225 @@
+#include <unity.h>
+#include <WiFi.h>
+#include <HttpStandIn.h>
+#include "OpenWeatherMap.h"
+
+static const char *BASE_URL = "http://127.0.0.1:8080";     // Address of the HttpStandIn
+static const unsigned int CITY_ID = 2950159;                // Any city, the stand-in ignores the query
+static const uint16_t TIMEOUT = 5000;                       // Timeout budget of a request in ms (WEATHER_API_TIMEOUT)
+
+// Response of the current weather (shortened example of the API documentation)
+static const char *WEATHER_BODY =
+    "{\"coord\":{\"lon\":13.41,\"lat\":52.52},\"weather\":[{\"id\":801,\"main\":\"Clouds\"}],\"main\":{\"temp\":7.81,\"feels_like\":5.2,\"humidity\":66},"
+    "\"dt\":1711359903,\"timezone\":3600,\"name\":\"Berlin\",\"cod\":200}";
+static const char *WEATHER_DATE = "Mon, 25 Mar 2024 09:45:07 GMT";
+static const time_t WEATHER_DATE_UNIX = 1711359907;
+
+static OpenWeatherMap *_api;
+
+void setUp()
+{
+    HttpStandIn::reset();
+    WiFi.stubStatus = WL_CONNECTED;
+    _api = new OpenWeatherMap("key", CITY_ID, BASE_URL);
+    _api->setTimeout(TIMEOUT);
+}
+
+void tearDown()
+{
+    delete _api;
+}
+
+static HttpStandInResponse weatherResponse()
+{
+    HttpStandInResponse response;
+    response.date = WEATHER_DATE;
+    response.body = WEATHER_BODY;
+    return response;
+}
+
+void test_request_parses_temperature_and_server_time()
+{
+    HttpStandIn::responses.push_back(weatherResponse());
+    HttpStandIn::responses.back().connectDelay = 300;
+    HttpStandIn::responses.back().headerDelay = 200;
+
+    auto response = _api->request();
+    TEST_ASSERT_TRUE(response.successful);
+    TEST_ASSERT_EQUAL(None, response.error);
+    TEST_ASSERT_EQUAL(HTTP_CODE_OK, response.httpCode);
+    TEST_ASSERT_EQUAL_FLOAT(7.81f, response.temperature);
+    TEST_ASSERT_EQUAL_STRING("10:45:03", response.timestamp.c_str());
+    TEST_ASSERT_EQUAL_INT64(1711359903, response.time);
+    TEST_ASSERT_EQUAL_INT64(WEATHER_DATE_UNIX, response.serverTime);
+
+    TEST_ASSERT_EQUAL(1, HttpStandIn::requests.size());
+    TEST_ASSERT_EQUAL_STRING("GET /data/2.5/weather?id=2950159&lang=en&units=METRIC&appid=key HTTP/1.0", HttpStandIn::requests[0].c_str());
+    TEST_ASSERT_FALSE(response.stats.reused);
+    TEST_ASSERT_EQUAL_UINT32(300, response.stats.handshake);
+    TEST_ASSERT_EQUAL_UINT32(strlen(WEATHER_BODY), response.stats.bytes);
+    TEST_ASSERT_UINT32_WITHIN(5, 500, response.stats.duration);
+}
+
+void test_connection_is_reused_until_closed()
+{
+    HttpStandIn::responses.push_back(weatherResponse());
+    HttpStandIn::responses.push_back(weatherResponse());
+    HttpStandIn::responses.back().close = true;
+    HttpStandIn::responses.push_back(weatherResponse());
+
+    TEST_ASSERT_TRUE(_api->request().successful);
+    auto reused = _api->request();
+    TEST_ASSERT_TRUE(reused.successful);
+    TEST_ASSERT_TRUE(reused.stats.reused);
+    TEST_ASSERT_EQUAL_UINT32(0, reused.stats.handshake);
+    TEST_ASSERT_EQUAL_UINT32(1, HttpStandIn::connects);
+
+    // The server has closed the connection after the second response
+    auto reconnected = _api->request();
+    TEST_ASSERT_TRUE(reconnected.successful);
+    TEST_ASSERT_FALSE(reconnected.stats.reused);
+    TEST_ASSERT_EQUAL_UINT32(2, HttpStandIn::connects);
+}
+
+void test_forecast_points()
+{
+    HttpStandInResponse response;
+    response.body = "{\"cod\":\"200\",\"cnt\":3,\"list\":["
+                    "{\"dt\":1711368000,\"main\":{\"temp\":8.5,\"humidity\":60}},"
+                    "{\"dt\":1711378800,\"main\":{\"humidity\":61}},"
+                    "{\"dt\":1711389600,\"main\":{\"temp\":6.25,\"humidity\":70}}],\"city\":{\"id\":2950159}}";
+    HttpStandIn::responses.push_back(response);
+
+    auto forecast = _api->requestForecast();
+    TEST_ASSERT_TRUE(forecast.successful);
+    TEST_ASSERT_EQUAL_STRING("GET /data/2.5/forecast?id=2950159&cnt=8&lang=en&units=METRIC&appid=key HTTP/1.0", HttpStandIn::requests[0].c_str());
+
+    // The point without temperature is skipped
+    TEST_ASSERT_EQUAL_UINT8(2, forecast.count);
+    TEST_ASSERT_EQUAL_INT64(1711368000, forecast.points[0].time);
+    TEST_ASSERT_EQUAL_FLOAT(8.5f, forecast.points[0].temperature);
+    TEST_ASSERT_EQUAL_INT64(1711389600, forecast.points[1].time);
+    TEST_ASSERT_EQUAL_FLOAT(6.25f, forecast.points[1].temperature);
+    TEST_ASSERT_EQUAL_INT64(0, forecast.serverTime);
+}
+
+void test_http_error_closes_connection()
+{
+    // No scripted response, the stand-in answers 404
+    HttpStandIn::responses.clear();
+    auto response = _api->request();
+    TEST_ASSERT_FALSE(response.successful);
+    TEST_ASSERT_EQUAL(HttpError, response.error);
+    TEST_ASSERT_EQUAL(HTTP_CODE_NOT_FOUND, response.httpCode);
+    TEST_ASSERT_TRUE(isnanf(response.temperature));
+
+    HttpStandIn::responses.push_back(weatherResponse());
+    auto next = _api->request();
+    TEST_ASSERT_TRUE(next.successful);
+    TEST_ASSERT_FALSE(next.stats.reused);
+    TEST_ASSERT_EQUAL_UINT32(2, HttpStandIn::connects);
+}
+
+void test_invalid_or_incomplete_json()
+{
+    HttpStandInResponse response;
+    response.body = "{\"main\":{\"temp\":7.81";
+    HttpStandIn::responses.push_back(response);
+    response.body = "{\"main\":{\"humidity\":66},\"dt\":1711359903}";
+    HttpStandIn::responses.push_back(response);
+
+    auto incomplete = _api->request();
+    TEST_ASSERT_FALSE(incomplete.successful);
+    TEST_ASSERT_EQUAL(DeserializationFailed, incomplete.error);
+
+    auto missingTemperature = _api->request();
+    TEST_ASSERT_FALSE(missingTemperature.successful);
+    TEST_ASSERT_EQUAL(DeserializationFailed, missingTemperature.error);
+    TEST_ASSERT_EQUAL(HTTP_CODE_OK, missingTemperature.httpCode);
+}
+
+void test_wifi_not_connected()
+{
+    WiFi.stubStatus = WL_DISCONNECTED;
+    HttpStandIn::responses.push_back(weatherResponse());
+    auto response = _api->request();
+    TEST_ASSERT_FALSE(response.successful);
+    TEST_ASSERT_EQUAL(WifiNotConnected, response.error);
+    TEST_ASSERT_EQUAL_UINT32(0, HttpStandIn::connects);
+}
+
+void test_unreachable_server_fails_after_timeout()
+{
+    delete _api;
+    _api = new OpenWeatherMap("key", 52.52, 13.41, "http://127.0.0.2:8080");
+    _api->setTimeout(TIMEOUT);
+    TEST_ASSERT_EQUAL_STRING("http://127.0.0.2:8080/data/2.5/weather?lat=52.520000&lon=13.410000&lang=en&units=METRIC&appid=key", _api->apiUrl.c_str());
+
+    auto response = _api->request();
+    TEST_ASSERT_FALSE(response.successful);
+    TEST_ASSERT_EQUAL(HttpError, response.error);
+    TEST_ASSERT_EQUAL(HTTPC_ERROR_CONNECTION_REFUSED, response.httpCode);
+    TEST_ASSERT_EQUAL_UINT32(TIMEOUT, response.stats.duration);
+}
+
+void test_slow_phases_share_one_deadline()
+{
+    // Each phase alone is below the timeout, together they exceed it
+    HttpStandIn::responses.push_back(weatherResponse());
+    HttpStandIn::responses.back().connectDelay = 3000;
+    HttpStandIn::responses.back().headerDelay = 3000;
+    HttpStandIn::responses.back().bodyStall = 3000;
+
+    auto response = _api->request();
+    TEST_ASSERT_FALSE(response.successful);
+    TEST_ASSERT_EQUAL(HttpError, response.error);
+    TEST_ASSERT_EQUAL(HTTPC_ERROR_READ_TIMEOUT, response.httpCode);
+    TEST_ASSERT_UINT32_WITHIN(5, TIMEOUT, response.stats.duration);
+}
+
+void test_stalled_body_fails_at_deadline()
+{
+    HttpStandIn::responses.push_back(weatherResponse());
+    HttpStandIn::responses.back().connectDelay = 1000;
+    HttpStandIn::responses.back().headerDelay = 1000;
+    HttpStandIn::responses.back().bodyStall = 4000;
+
+    auto response = _api->request();
+    TEST_ASSERT_FALSE(response.successful);
+    TEST_ASSERT_EQUAL(DeserializationFailed, response.error);
+    TEST_ASSERT_UINT32_WITHIN(5, TIMEOUT, response.stats.duration);
+
+    // The stalled connection is not reused
+    HttpStandIn::responses.push_back(weatherResponse());
+    auto next = _api->request();
+    TEST_ASSERT_TRUE(next.successful);
+    TEST_ASSERT_FALSE(next.stats.reused);
+}
+
+void test_slow_response_within_deadline()
+{
+    HttpStandIn::responses.push_back(weatherResponse());
+    HttpStandIn::responses.back().connectDelay = 1500;
+    HttpStandIn::responses.back().headerDelay = 1500;
+    HttpStandIn::responses.back().bodyStall = 1500;
+
+    auto response = _api->request();
+    TEST_ASSERT_TRUE(response.successful);
+    TEST_ASSERT_UINT32_WITHIN(5, 4500, response.stats.duration);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_request_parses_temperature_and_server_time);
+    RUN_TEST(test_connection_is_reused_until_closed);
+    RUN_TEST(test_forecast_points);
+    RUN_TEST(test_http_error_closes_connection);
+    RUN_TEST(test_invalid_or_incomplete_json);
+    RUN_TEST(test_wifi_not_connected);
+    RUN_TEST(test_unreachable_server_fails_after_timeout);
+    RUN_TEST(test_slow_phases_share_one_deadline);
+    RUN_TEST(test_stalled_body_fails_at_deadline);
+    RUN_TEST(test_slow_response_within_deadline);
+    return UNITY_END();
+}
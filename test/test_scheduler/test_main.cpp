@@ -0,0 +1,245 @@
+#include <unity.h>
+#include <stdio.h>
+#include <random>
+#include "Scheduler.h"
+
+static const uint32_t SAMPLE_CYCLE = 10;        // Period of the input sampling in ms (TEMP_IN_SAMPLE_CYCLE)
+static const uint32_t OUTPUT_CYCLE = 1000;      // Period of the output temperature in ms (TEMP_OUT_UPDATE_CYCLE)
+static const uint32_t TOLERANCE = 1000;         // Jobs are started up to 1 ms before the deadline (SCHEDULER_TOLERANCE)
+static const uint32_t SIMULATED_CYCLES = 360000; // Control task cycles of the load simulation (one hour)
+
+static uint32_t _nowUs;                         // Simulated time, 32 bit like micros() on the ESP32
+static std::mt19937 _random;
+static uint32_t _sampleLoad;                    // Execution time of the next sample job in us
+static uint32_t _sampleRuns;
+static uint32_t _outputRuns;
+static uint32_t _outputLateMax;                 // Maximum start of the output job after its 1 s grid point in us
+static uint32_t _outputStart;                   // Time of the first output deadline
+
+/// @brief Injectable clock of the scheduler
+static unsigned long mockClock()
+{
+    return _nowUs;
+}
+
+typedef Scheduler<4, mockClock> MockScheduler;
+
+static void sample()
+{
+    _nowUs += _sampleLoad;
+    _sampleRuns++;
+}
+
+static void output()
+{
+    uint32_t late = (_nowUs - _outputStart) % (OUTPUT_CYCLE * 1000);
+    if (late > _outputLateMax)
+        _outputLateMax = late;
+    _nowUs += 2000 + _random() % 3000;
+    _outputRuns++;
+}
+
+static void power()
+{
+    _nowUs += 1500;
+}
+
+void setUp()
+{
+    _nowUs = 0;
+    _random.seed(15);
+    _sampleLoad = 0;
+    _sampleRuns = 0;
+    _outputRuns = 0;
+    _outputLateMax = 0;
+    _outputStart = OUTPUT_CYCLE * 1000;
+}
+
+void tearDown() {}
+
+void test_add_jobs()
+{
+    MockScheduler scheduler;
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, scheduler.getTimeUntilDue());
+    TEST_ASSERT_FALSE(scheduler.every("Zero", 0, sample));
+    TEST_ASSERT_FALSE(scheduler.every("None", 10, nullptr));
+    for (uint8_t i = 0; i < 4; i++)
+        TEST_ASSERT_TRUE(scheduler.every("Job", 10, sample, 5));
+    TEST_ASSERT_FALSE(scheduler.every("Full", 10, sample));
+    TEST_ASSERT_EQUAL_UINT8(4, scheduler.getCount());
+    TEST_ASSERT_EQUAL_UINT32(5000, scheduler.getTimeUntilDue());
+    TEST_ASSERT_EQUAL_STRING("Job", scheduler.getStats(0).name);
+    TEST_ASSERT_EQUAL_UINT32(10000, scheduler.getStats(0).period);
+}
+
+void test_fixed_rate_without_load()
+{
+    MockScheduler scheduler(TOLERANCE);
+    scheduler.every("Sample", SAMPLE_CYCLE, sample);
+    scheduler.every("Output", OUTPUT_CYCLE, output, OUTPUT_CYCLE);
+
+    // Woken exactly by the task every sample cycle for 10 s
+    for (uint32_t cycle = 0; cycle < 1000; cycle++)
+    {
+        _nowUs = cycle * SAMPLE_CYCLE * 1000;
+        scheduler.tick();
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(1000, _sampleRuns);
+    TEST_ASSERT_EQUAL_UINT32(9, _outputRuns);
+    TEST_ASSERT_EQUAL_UINT32(0, _outputLateMax);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(0).missed);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(0).lateMax);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(1).missed);
+}
+
+void test_tolerance_starts_slightly_early()
+{
+    MockScheduler scheduler(TOLERANCE);
+    scheduler.every("Sample", SAMPLE_CYCLE, sample, SAMPLE_CYCLE);
+
+    _nowUs = SAMPLE_CYCLE * 1000 - TOLERANCE - 1;
+    scheduler.tick();
+    TEST_ASSERT_EQUAL_UINT32(0, _sampleRuns);
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler.getTimeUntilDue());
+
+    _nowUs = SAMPLE_CYCLE * 1000 - TOLERANCE;
+    TEST_ASSERT_EQUAL_UINT32(SAMPLE_CYCLE * 1000, scheduler.tick());
+    TEST_ASSERT_EQUAL_UINT32(1, _sampleRuns);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(0).late);
+
+    // The early start does not shift the next deadline
+    _nowUs = 2 * SAMPLE_CYCLE * 1000 + 300;
+    scheduler.tick();
+    TEST_ASSERT_EQUAL_UINT32(2, _sampleRuns);
+    TEST_ASSERT_EQUAL_UINT32(300, scheduler.getStats(0).late);
+}
+
+void test_missed_periods_are_skipped()
+{
+    MockScheduler scheduler(TOLERANCE);
+    scheduler.every("Sample", SAMPLE_CYCLE, sample);
+    scheduler.tick();
+
+    // A stall of 35 ms inside the job: the deadlines at 10, 20 and 30 ms have passed
+    _sampleLoad = 35000;
+    _nowUs = 10000;
+    scheduler.tick();
+    _sampleLoad = 0;
+    TEST_ASSERT_EQUAL_UINT32(2, _sampleRuns);
+    TEST_ASSERT_EQUAL_UINT32(3, scheduler.getStats(0).missed);
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler.getStats(0).overruns);
+    TEST_ASSERT_EQUAL_UINT32(35000, scheduler.getStats(0).execMax);
+
+    // Next run on the original 10 ms grid
+    TEST_ASSERT_EQUAL_UINT32(50000 - 45000 - TOLERANCE, scheduler.getTimeUntilDue());
+}
+
+void test_job_ending_on_next_deadline_is_not_missed()
+{
+    MockScheduler scheduler(TOLERANCE);
+    scheduler.every("Sample", SAMPLE_CYCLE, sample);
+    scheduler.tick();
+
+    // The job takes exactly one period and ends on its next deadline, which is still due
+    _sampleLoad = SAMPLE_CYCLE * 1000;
+    _nowUs = 10000;
+    scheduler.tick();
+    _sampleLoad = 0;
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(0).missed);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(0).overruns);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getTimeUntilDue());
+
+    scheduler.tick();
+    TEST_ASSERT_EQUAL_UINT32(3, _sampleRuns);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(0).late);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(0).missed);
+}
+
+void test_cadence_under_load()
+{
+    MockScheduler scheduler(TOLERANCE);
+    scheduler.every("Sample", SAMPLE_CYCLE, sample);
+    scheduler.every("Output", OUTPUT_CYCLE, output, OUTPUT_CYCLE);
+    scheduler.every("Power", OUTPUT_CYCLE, power, OUTPUT_CYCLE);
+
+    // The control task is woken every sample cycle with +-100 us jitter, the sample job takes 0.2-0.5 ms and
+    // stalls for 25 ms now and then (e.g. flash access or a blocked ADC read)
+    uint32_t wake = 0;
+    uint32_t stalls = 0;
+    for (uint32_t cycle = 0; cycle < SIMULATED_CYCLES; cycle++)
+    {
+        wake += SAMPLE_CYCLE * 1000;
+        int32_t jitter = (int32_t)(_random() % 200) - 100;
+        if ((int32_t)(wake + jitter - _nowUs) > 0)
+            _nowUs = wake + jitter;
+
+        _sampleLoad = 200 + _random() % 300;
+        if (_random() % 5000 == 0)
+        {
+            _sampleLoad += 25000;
+            stalls++;
+        }
+
+        scheduler.tick();
+
+        // The task is delayed by vTaskDelayUntil(), a cycle that took longer than the period is not repeated
+        if ((int32_t)(_nowUs - wake) > (int32_t)(SAMPLE_CYCLE * 1000))
+            wake += (_nowUs - wake) / (SAMPLE_CYCLE * 1000) * SAMPLE_CYCLE * 1000;
+    }
+
+    auto &sampleStats = scheduler.getStats(0);
+    auto &outputStats = scheduler.getStats(1);
+    char message[160];
+    snprintf(message, sizeof(message), "%u stalls: samples %u missed %u late max %u us, outputs %u missed %u late max %u us",
+             stalls, sampleStats.runs, sampleStats.missed, sampleStats.lateMax, outputStats.runs, outputStats.missed, _outputLateMax);
+    TEST_MESSAGE(message);
+
+    // Every 10 ms period is either sampled or counted as missed, a stall only costs the periods it covers
+    uint32_t elapsed = _nowUs / (SAMPLE_CYCLE * 1000);
+    TEST_ASSERT_TRUE(stalls > 0);
+    TEST_ASSERT_UINT32_WITHIN(1, elapsed, sampleStats.runs + sampleStats.missed);
+    TEST_ASSERT_TRUE(sampleStats.missed <= stalls * 3);
+    TEST_ASSERT_EQUAL_UINT32(sampleStats.runs, _sampleRuns);
+
+    // The output stays on the 1 s grid: one run per second, started after at most one sample job plus a stall
+    TEST_ASSERT_EQUAL_UINT32(_nowUs / (OUTPUT_CYCLE * 1000), outputStats.runs + outputStats.missed);
+    TEST_ASSERT_EQUAL_UINT32(0, outputStats.missed);
+    TEST_ASSERT_TRUE(_outputLateMax < 30000);
+    TEST_ASSERT_EQUAL_UINT32(0, outputStats.overruns);
+}
+
+void test_cadence_across_clock_wrap()
+{
+    // micros() wraps after ~71 minutes
+    _nowUs = UINT32_MAX - 2500000;
+    _outputStart = _nowUs + OUTPUT_CYCLE * 1000;
+    MockScheduler scheduler(TOLERANCE);
+    scheduler.every("Sample", SAMPLE_CYCLE, sample);
+    scheduler.every("Output", OUTPUT_CYCLE, output, OUTPUT_CYCLE);
+
+    uint32_t start = _nowUs;
+    for (uint32_t cycle = 0; cycle < 500; cycle++)
+    {
+        _nowUs = start + cycle * SAMPLE_CYCLE * 1000;
+        scheduler.tick();
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(500, _sampleRuns);
+    TEST_ASSERT_EQUAL_UINT32(4, _outputRuns);
+    TEST_ASSERT_EQUAL_UINT32(0, _outputLateMax);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(0).missed);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_add_jobs);
+    RUN_TEST(test_fixed_rate_without_load);
+    RUN_TEST(test_tolerance_starts_slightly_early);
+    RUN_TEST(test_missed_periods_are_skipped);
+    RUN_TEST(test_job_ending_on_next_deadline_is_not_missed);
+    RUN_TEST(test_cadence_under_load);
+    RUN_TEST(test_cadence_across_clock_wrap);
+    return UNITY_END();
+}
@@ -0,0 +1,116 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include "ThermistorCalc.h"
+
+static const int BENCHMARK_ROUNDS = 200;        // Rounds over the whole table range for the benchmark
+static const double MAX_TABLE_ERROR = 0.0084;   // Maximum deviation of the PAW-A2W-TSOD table against Steinhart–Hart in °C
+
+static volatile double _sink;                   // Keeps the benchmark loops from being optimized away
+
+void setUp() {}
+void tearDown() {}
+
+/// @brief Measures the average time of a conversion over the table range in ns
+template <typename Convert>
+static double benchmark(Convert convert)
+{
+    auto start = std::chrono::steady_clock::now();
+    double sum = 0;
+    int count = 0;
+    for (int round = 0; round < BENCHMARK_ROUNDS; round++)
+    {
+        for (double celsius = THERMISTOR_TABLE_MIN_CELSIUS; celsius < THERMISTOR_TABLE_MAX_CELSIUS; celsius += 0.1)
+        {
+            sum += convert(celsius);
+            count++;
+        }
+    }
+
+    _sink = sum;
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+void test_profile_reports_table_error_below_bound()
+{
+    ThermistorCalc calc(PanasonicPawA2wTsod{});
+    TEST_ASSERT_TRUE(calc.isLookupTableEnabled());
+    TEST_ASSERT_GREATER_THAN_FLOAT(0, calc.getLookupTableMaxError());
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(MAX_TABLE_ERROR, calc.getLookupTableMaxError());
+}
+
+void test_runtime_table_matches_profile()
+{
+    ThermistorCalc profile(PanasonicPawA2wTsod{});
+    ThermistorCalc runtime(-40, 167820, 25, 6523, 120, 302);
+    TEST_ASSERT_FALSE(runtime.isLookupTableEnabled());
+    TEST_ASSERT_EQUAL_FLOAT(0, runtime.getLookupTableMaxError());
+
+    runtime.enableLookupTable();
+    TEST_ASSERT_TRUE(runtime.isLookupTableEnabled());
+    TEST_ASSERT_FLOAT_WITHIN(0.0005, profile.getLookupTableMaxError(), runtime.getLookupTableMaxError());
+}
+
+void test_table_error_against_exact_steinhart_hart()
+{
+    ThermistorCalc table(PanasonicPawA2wTsod{});
+    ThermistorCalc exact(-40, 167820, 25, 6523, 120, 302);
+
+    // Dense sweep over the whole table range, not only the quarter points that are checked by the table itself
+    double maxError = 0;
+    double maxResistanceError = 0;
+    for (double celsius = THERMISTOR_TABLE_MIN_CELSIUS; celsius <= THERMISTOR_TABLE_MAX_CELSIUS; celsius += 0.01)
+    {
+        double resistance = exact.resistanceFromCelsius(celsius);
+        maxError = fmax(maxError, fabs(table.celsiusFromResistance(resistance) - celsius));
+        maxResistanceError = fmax(maxResistanceError, fabs(exact.celsiusFromResistance(table.resistanceFromCelsius(celsius)) - celsius));
+    }
+
+    char message[96];
+    snprintf(message, sizeof(message), "Table error: reported %.5f °C, measured %.5f °C / %.5f °C", table.getLookupTableMaxError(), maxError, maxResistanceError);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(MAX_TABLE_ERROR, maxError);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(MAX_TABLE_ERROR, maxResistanceError);
+    TEST_ASSERT_FLOAT_WITHIN(0.0005, table.getLookupTableMaxError(), fmax(maxError, maxResistanceError));
+}
+
+void test_outside_table_range_uses_exact_formula()
+{
+    ThermistorCalc table(PanasonicPawA2wTsod{});
+    ThermistorCalc exact(-40, 167820, 25, 6523, 120, 302);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, exact.resistanceFromCelsius(-45), table.resistanceFromCelsius(-45));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, exact.resistanceFromCelsius(130), table.resistanceFromCelsius(130));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, exact.celsiusFromResistance(200000), table.celsiusFromResistance(200000));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, exact.celsiusFromResistance(250), table.celsiusFromResistance(250));
+}
+
+void test_benchmark_table_and_exact_formula()
+{
+    ThermistorCalc table(PanasonicPawA2wTsod{});
+    ThermistorCalc exact(-40, 167820, 25, 6523, 120, 302);
+
+    double exactToResistance = benchmark([&exact](double celsius) { return exact.resistanceFromCelsius(celsius); });
+    double tableToResistance = benchmark([&table](double celsius) { return table.resistanceFromCelsius(celsius); });
+    double exactToCelsius = benchmark([&exact](double celsius) { return exact.celsiusFromResistance(1000 + celsius * 100); });
+    double tableToCelsius = benchmark([&table](double celsius) { return table.celsiusFromResistance(1000 + celsius * 100); });
+
+    // Only reported, the host FPU says little about the software double precision of the ESP32
+    char message[128];
+    snprintf(message, sizeof(message), "Resistance from celsius: exact %.1f ns, table %.1f ns", exactToResistance, tableToResistance);
+    TEST_MESSAGE(message);
+    snprintf(message, sizeof(message), "Celsius from resistance: exact %.1f ns, table %.1f ns", exactToCelsius, tableToCelsius);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_GREATER_THAN(0, exactToResistance + tableToResistance + exactToCelsius + tableToCelsius);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_profile_reports_table_error_below_bound);
+    RUN_TEST(test_runtime_table_matches_profile);
+    RUN_TEST(test_table_error_against_exact_steinhart_hart);
+    RUN_TEST(test_outside_table_range_uses_exact_formula);
+    RUN_TEST(test_benchmark_table_and_exact_formula);
+    return UNITY_END();
+}
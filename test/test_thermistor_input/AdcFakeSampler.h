@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <deque>
+#include <vector>
+#include "AdcSampler.h"
+
+/// @brief Sampler that returns queued frames instead of reading the ADC, one frame per read call
+class AdcFakeSampler : public AdcSampler
+{
+private:
+    std::deque<std::vector<uint16_t>> _frames;
+    uint32_t _reads = 0;
+
+protected:
+public:
+    /// @brief Queues a frame of raw readings
+    void push(const std::vector<uint16_t> &frame) { _frames.push_back(frame); };
+
+    /// @brief Queues a frame that contains the same reading several times
+    void push(uint16_t reading, size_t count = 1) { _frames.push_back(std::vector<uint16_t>(count, reading)); };
+
+    /// @brief Gets the amount of queued frames
+    size_t getPending() const { return _frames.size(); };
+
+    /// @brief Gets the amount of read calls
+    uint32_t getReads() const { return _reads; };
+
+    bool begin() override { return true; };
+
+    size_t read(uint16_t *samples, size_t maxSamples) override
+    {
+        _reads++;
+        if (_frames.empty())
+        {
+            return 0;
+        }
+
+        // Like the continuous sampler only the most recent samples are kept if the frame exceeds the buffer
+        auto frame = _frames.front();
+        _frames.pop_front();
+        size_t count = frame.size() < maxSamples ? frame.size() : maxSamples;
+        for (size_t i = 0; i < count; i++)
+        {
+            samples[i] = frame[frame.size() - count + i];
+        }
+
+        return count;
+    }
+
+    const char *getName() const override { return "Fake"; };
+};
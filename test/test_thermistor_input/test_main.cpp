@@ -0,0 +1,162 @@
+#include <unity.h>
+#include <math.h>
+#include "AdcFakeSampler.h"
+#include "ThermistorInput.h"
+
+static const uint16_t WINDOW_SIZE = 10;             // Samples inside the sliding median window
+static const size_t FRAME_SIZE = 8;                 // Maximum raw samples per frame
+static const float DIVIDER_RESISTANCE = 10000;      // Voltage divider resistor in Ohm
+static const float OUTLIER_DEVIATION = 0.5f;        // Maximum deviation from the median in °C
+static const float READING_TOLERANCE = 0.05f;       // Temperature resolution of a single ADC reading around 20 °C is ~0.03 °C
+
+static AdcCorrection _correction;
+static ThermistorCalc _thermistor(PanasonicPawA2wTsod{});
+static AdcFakeSampler *_sampler;
+static ThermistorInput<WINDOW_SIZE, FRAME_SIZE> *_input;
+
+void setUp()
+{
+    _correction.begin(false);
+    _sampler = new AdcFakeSampler();
+    _input = new ThermistorInput<WINDOW_SIZE, FRAME_SIZE>(_correction, _thermistor, DIVIDER_RESISTANCE, ADC_MAX_VOLTAGE, OUTLIER_DEVIATION);
+}
+
+void tearDown()
+{
+    delete _input;
+    delete _sampler;
+}
+
+/// @brief Gets the ADC reading that is closest to the voltage of the divider at the given temperature
+static uint16_t readingFromCelsius(float celsius)
+{
+    double resistance = _thermistor.resistanceFromCelsius(celsius);
+    float voltage = ADC_MAX_VOLTAGE * resistance / (resistance + DIVIDER_RESISTANCE);
+    uint16_t best = 1;
+    for (uint16_t reading = 1; reading < ADC_MAX_READING; reading++)
+    {
+        if (fabsf(_correction.voltageFromReading(reading) - voltage) < fabsf(_correction.voltageFromReading(best) - voltage))
+            best = reading;
+    }
+
+    return best;
+}
+
+/// @brief Feeds the frames into the input
+/// @return the amount of updates that have changed the temperature
+static int feed(uint16_t reading, int frames, size_t frameSize = 1)
+{
+    int changes = 0;
+    for (int i = 0; i < frames; i++)
+    {
+        _sampler->push(reading, frameSize);
+        changes += _input->update() ? 1 : 0;
+    }
+
+    return changes;
+}
+
+void test_no_frame_keeps_temperature()
+{
+    TEST_ASSERT_TRUE(isnanf(_input->begin(_sampler)));
+    TEST_ASSERT_TRUE(isnanf(_input->readAdcVoltageCorrected()));
+    TEST_ASSERT_FALSE(_input->update());
+    TEST_ASSERT_TRUE(isnanf(_input->getTemperature()));
+    TEST_ASSERT_EQUAL_UINT32(3, _sampler->getReads());
+}
+
+void test_frame_is_averaged()
+{
+    _input->begin(_sampler);
+    _sampler->push({1000, 1001, 1003, 1004, 1001});
+    TEST_ASSERT_EQUAL_FLOAT(_correction.voltageFromReading(1001.8f), _input->readAdcVoltageCorrected());
+    TEST_ASSERT_EQUAL_UINT16(1001, _input->getAdcRaw());
+
+    _sampler->push(2000);
+    TEST_ASSERT_EQUAL_FLOAT(_correction.voltageFromReading((uint16_t)2000), _input->readAdcVoltageCorrected());
+    TEST_ASSERT_EQUAL_UINT16(2000, _input->getAdcRaw());
+
+    // Only the most recent FRAME_SIZE samples of an oversized frame are used
+    _sampler->push({0, 0, 0, 0, 3000, 3000, 3000, 3000, 3000, 3000, 3000, 3000});
+    TEST_ASSERT_EQUAL_FLOAT(_correction.voltageFromReading((uint16_t)3000), _input->readAdcVoltageCorrected());
+    TEST_ASSERT_EQUAL_UINT16(3000, _input->getAdcRaw());
+}
+
+void test_begin_applies_first_frame()
+{
+    _sampler->push(readingFromCelsius(25), FRAME_SIZE);
+    TEST_ASSERT_FLOAT_WITHIN(READING_TOLERANCE, 25, _input->begin(_sampler));
+    TEST_ASSERT_FLOAT_WITHIN(READING_TOLERANCE, 25, _input->getTemperature());
+}
+
+void test_window_is_applied_every_n_samples()
+{
+    _input->begin(_sampler);
+    TEST_ASSERT_EQUAL(0, feed(readingFromCelsius(20), WINDOW_SIZE - 1, FRAME_SIZE));
+    TEST_ASSERT_TRUE(isnanf(_input->getTemperature()));
+    TEST_ASSERT_EQUAL(1, feed(readingFromCelsius(20), 1, FRAME_SIZE));
+    TEST_ASSERT_FLOAT_WITHIN(READING_TOLERANCE, 20, _input->getTemperature());
+
+    // A change below THERMISTOR_INPUT_MIN_CHANGE is not applied, a larger one after the next window
+    TEST_ASSERT_EQUAL(0, feed(readingFromCelsius(20.02f), WINDOW_SIZE));
+    TEST_ASSERT_FLOAT_WITHIN(READING_TOLERANCE, 20, _input->getTemperature());
+    TEST_ASSERT_EQUAL(0, feed(readingFromCelsius(21), WINDOW_SIZE - 1));
+    TEST_ASSERT_EQUAL(1, feed(readingFromCelsius(21), 1));
+    TEST_ASSERT_FLOAT_WITHIN(READING_TOLERANCE, 21, _input->getTemperature());
+}
+
+void test_outliers_are_rejected()
+{
+    _input->begin(_sampler);
+    feed(readingFromCelsius(20), 4);
+    feed(readingFromCelsius(30), 1);
+    feed(readingFromCelsius(20), 4);
+    feed(readingFromCelsius(10), 1);
+    TEST_ASSERT_FLOAT_WITHIN(READING_TOLERANCE, 20, _input->getTemperature());
+    TEST_ASSERT_EQUAL_UINT16(2, _input->getLastOutlierCount());
+    TEST_ASSERT_EQUAL_UINT32(2, _input->getOutlierCount());
+}
+
+void test_disconnected_sensor_and_shorted_divider()
+{
+    _sampler->push(readingFromCelsius(20));
+    _input->begin(_sampler);
+
+    // Sensor disconnected (supply voltage), reported once
+    TEST_ASSERT_EQUAL(1, feed(ADC_MAX_READING, 1));
+    TEST_ASSERT_TRUE(isnanf(_input->getTemperature()));
+    TEST_ASSERT_EQUAL(0, feed(ADC_MAX_READING, 1));
+
+    // Divider resistor shorted (0V)
+    TEST_ASSERT_EQUAL(0, feed(0, 1, FRAME_SIZE));
+    TEST_ASSERT_TRUE(isnanf(_input->getTemperature()));
+    TEST_ASSERT_TRUE(isnanf(_input->temperatureFromVoltage(0)));
+    TEST_ASSERT_TRUE(isnanf(_input->temperatureFromVoltage(ADC_MAX_VOLTAGE)));
+}
+
+void test_window_is_refilled_after_dropout()
+{
+    _input->begin(_sampler);
+    feed(readingFromCelsius(20), WINDOW_SIZE + 3);
+    TEST_ASSERT_FLOAT_WITHIN(READING_TOLERANCE, 20, _input->getTemperature());
+
+    // After the dropout the temperature is only applied again once the window is full
+    TEST_ASSERT_EQUAL(1, feed(ADC_MAX_READING, 1));
+    TEST_ASSERT_EQUAL(0, feed(readingFromCelsius(25), WINDOW_SIZE - 1));
+    TEST_ASSERT_TRUE(isnanf(_input->getTemperature()));
+    TEST_ASSERT_EQUAL(1, feed(readingFromCelsius(25), 1));
+    TEST_ASSERT_FLOAT_WITHIN(READING_TOLERANCE, 25, _input->getTemperature());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_no_frame_keeps_temperature);
+    RUN_TEST(test_frame_is_averaged);
+    RUN_TEST(test_begin_applies_first_frame);
+    RUN_TEST(test_window_is_applied_every_n_samples);
+    RUN_TEST(test_outliers_are_rejected);
+    RUN_TEST(test_disconnected_sensor_and_shorted_divider);
+    RUN_TEST(test_window_is_refilled_after_dropout);
+    return UNITY_END();
+}